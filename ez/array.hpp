@@ -0,0 +1,52 @@
+#ifndef _ez_array_hpp_
+#define _ez_array_hpp_
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <array>
+
+namespace ez {
+
+/* EZ arrays of `N` elements, a thin layer over std::array: the elements are
+ * stored inline, copies are the std::array ones.
+ *
+ * Like for vectors, defining EZ_BOUNDS_CHECK makes the accesses out of the
+ * array exit the program with an error instead of being undefined.
+ */
+template <typename T, size_t N>
+class array {
+  private:
+    std::array<T, N> _elements;
+
+    void check_index(unsigned int n) const {
+#ifdef EZ_BOUNDS_CHECK
+        if (n >= N) {
+            fprintf(stderr, "array index %u out of bounds (size %u)\n",
+                    n, size());
+            exit(EXIT_FAILURE);
+        }
+#else
+        (void)n;
+#endif
+    }
+
+  public:
+    T& at(unsigned int n) {
+        check_index(n);
+        return _elements[n];
+    }
+
+    const T& at(unsigned int n) const {
+        check_index(n);
+        return _elements[n];
+    }
+
+    unsigned int size() const {
+        return N;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef _ez_framebuffer_hpp_
+#define _ez_framebuffer_hpp_
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace ez {
+
+struct Color {
+    unsigned int red;
+    unsigned int green;
+    unsigned int blue;
+
+    Color(unsigned int red, unsigned int green, unsigned int blue)
+        : red(red)
+        , green(green)
+        , blue(blue)
+    {
+
+    }
+};
+
+Color color(unsigned int red, unsigned int green, unsigned int blue) {
+    return Color(red, green, blue);
+}
+
+/* An image in memory, as rows of RGB bytes from the top left corner: the
+ * layout of binary PPM files and of GL_RGB textures.
+ *
+ * Drawing out of the image is clipped.
+ */
+class Framebuffer {
+  private:
+    unsigned int _width;
+    unsigned int _height;
+    std::vector<uint8_t> _pixels;
+
+    /* Clips [x, x + w) to [0, limit). */
+    static bool clip(unsigned int& x, unsigned int& w, unsigned int limit) {
+        if (x >= limit) {
+            return false;
+        }
+        if (w > limit - x) {
+            w = limit - x;
+        }
+        return w > 0;
+    }
+
+  public:
+    Framebuffer() : _width(0), _height(0) {
+    }
+
+    void resize(unsigned int width, unsigned int height) {
+        _width = width;
+        _height = height;
+        _pixels.assign((size_t)width * height * 3, 0);
+    }
+
+    unsigned int width() const {
+        return _width;
+    }
+
+    unsigned int height() const {
+        return _height;
+    }
+
+    const uint8_t* pixels() const {
+        return _pixels.data();
+    }
+
+    void put_pixel(unsigned int x, unsigned int y, const Color& c) {
+        if (x < _width && y < _height) {
+            uint8_t* p = &_pixels[((size_t)y * _width + x) * 3];
+            p[0] = c.red;
+            p[1] = c.green;
+            p[2] = c.blue;
+        }
+    }
+
+    void fill_rect(unsigned int x, unsigned int y,
+                   unsigned int w, unsigned int h, const Color& c)
+    {
+        if (!clip(x, w, _width) || !clip(y, h, _height)) {
+            return;
+        }
+
+        /* Fill the first row, then copy it to the others. */
+        uint8_t* first = &_pixels[((size_t)y * _width + x) * 3];
+        for (unsigned int i = 0; i < w; i++) {
+            first[i * 3] = c.red;
+            first[i * 3 + 1] = c.green;
+            first[i * 3 + 2] = c.blue;
+        }
+        for (unsigned int j = 1; j < h; j++) {
+            memcpy(first + (size_t)j * _width * 3, first, (size_t)w * 3);
+        }
+    }
+
+    void clear(const Color& c) {
+        fill_rect(0, 0, _width, _height, c);
+    }
+
+    /* Copies `src` with its top left corner at (x, y). */
+    void blit(const Framebuffer& src, unsigned int x, unsigned int y) {
+        unsigned int w = src._width;
+        unsigned int h = src._height;
+        if (&src == this || !clip(x, w, _width) || !clip(y, h, _height)) {
+            return;
+        }
+
+        for (unsigned int j = 0; j < h; j++) {
+            memcpy(&_pixels[((size_t)(y + j) * _width + x) * 3],
+                   &src._pixels[(size_t)j * src._width * 3],
+                   (size_t)w * 3);
+        }
+    }
+
+    bool write_ppm(const std::string& path) const {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+
+        fprintf(file, "P6\n%u %u\n255\n", _width, _height);
+        bool written = fwrite(_pixels.data(), 1, _pixels.size(), file)
+                    == _pixels.size();
+        return fclose(file) == 0 && written;
+    }
+};
+
+void create_framebuffer(Framebuffer& fb,
+                        unsigned int width, unsigned int height)
+{
+    fb.resize(width, height);
+}
+
+unsigned int framebuffer_width(const Framebuffer& fb) {
+    return fb.width();
+}
+
+unsigned int framebuffer_height(const Framebuffer& fb) {
+    return fb.height();
+}
+
+void set_pixel(Framebuffer& fb,
+               unsigned int x, unsigned int y, const Color& color)
+{
+    fb.put_pixel(x, y, color);
+}
+
+void fill_rect(Framebuffer& fb, unsigned int x, unsigned int y,
+               unsigned int width, unsigned int height, const Color& color)
+{
+    fb.fill_rect(x, y, width, height, color);
+}
+
+void clear_framebuffer(Framebuffer& fb, const Color& color) {
+    fb.clear(color);
+}
+
+void blit(Framebuffer& fb, const Framebuffer& src,
+          unsigned int x, unsigned int y)
+{
+    fb.blit(src, x, y);
+}
+
+bool write_framebuffer_ppm(const Framebuffer& fb, const std::string& path) {
+    return fb.write_ppm(path);
+}
+
+}
+
+#endif
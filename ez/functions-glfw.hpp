@@ -6,10 +6,20 @@
 #include <string>
 #include <GLFW/glfw3.h>
 #include "optional.hpp"
+#include "framebuffer.hpp"
 
 namespace ez {
 
-typedef GLFWwindow* Window;
+/* Windows are drawn in a framebuffer in memory, uploaded in a texture and
+ * drawn at once by `update_window`. */
+struct Window {
+    GLFWwindow* handle;
+    Framebuffer framebuffer;
+    GLuint texture;
+
+    Window() : handle(NULL), texture(0) {
+    }
+};
 
 void _error_callback(int error, const char* desc) {
     fprintf(stderr, "GLFW error %d: %s", error, desc);
@@ -31,17 +41,18 @@ ez::optional<std::string> open_window(Window& window,
         return ez::optional<std::string>("couldn't initialize GLFW");
     }
     glfwSetErrorCallback(&_error_callback);
-    window = glfwCreateWindow(width, height, title.c_str(),
-                            NULL, NULL);
-    if (!window) {
+    window.handle = glfwCreateWindow(width, height, title.c_str(),
+                                     NULL, NULL);
+    if (!window.handle) {
         return ez::optional<std::string>("couldn't open window");
     }
-    glfwMakeContextCurrent(window);
-    glfwSetKeyCallback(window, &_key_callback);
+    glfwMakeContextCurrent(window.handle);
+    glfwSetKeyCallback(window.handle, &_key_callback);
 
     int fb_width, fb_height;
-    glfwGetFramebufferSize(window, &fb_width, &fb_height);
+    glfwGetFramebufferSize(window.handle, &fb_width, &fb_height);
     glViewport(0, 0, fb_width, fb_height);
+    window.framebuffer.resize(fb_width, fb_height);
 
     glMatrixMode(GL_PROJECTION);
     glLoadIdentity();
@@ -50,52 +61,59 @@ ez::optional<std::string> open_window(Window& window,
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
 
+    glEnable(GL_TEXTURE_2D);
+    glGenTextures(1, &window.texture);
+    glBindTexture(GL_TEXTURE_2D, window.texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, fb_width, fb_height, 0,
+                 GL_RGB, GL_UNSIGNED_BYTE, window.framebuffer.pixels());
+
     return ez::optional<std::string>();
 }
 
 void close_window(Window& window) {
-    glfwDestroyWindow(window);
+    glDeleteTextures(1, &window.texture);
+    glfwDestroyWindow(window.handle);
     glfwTerminate();
 }
 
 void update_window(Window& window) {
-    glfwSwapBuffers(window);
+    const Framebuffer& fb = window.framebuffer;
+
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, fb.width(), fb.height(),
+                    GL_RGB, GL_UNSIGNED_BYTE, fb.pixels());
+    glColor3ub(255, 255, 255);
+    glBegin(GL_QUADS);
+        glTexCoord2i(0, 0); glVertex2i(0, 0);
+        glTexCoord2i(1, 0); glVertex2i(fb.width(), 0);
+        glTexCoord2i(1, 1); glVertex2i(fb.width(), fb.height());
+        glTexCoord2i(0, 1); glVertex2i(0, fb.height());
+    glEnd();
+
+    glfwSwapBuffers(window.handle);
     glfwPollEvents();
 }
 
 bool should_close_window(Window& window) {
-    return glfwWindowShouldClose(window);
+    return glfwWindowShouldClose(window.handle);
 }
 
 void clear_window(Window& window) {
-    glClear(GL_COLOR_BUFFER_BIT);
-}
-
-struct Color {
-    unsigned int red;
-    unsigned int green;
-    unsigned int blue;
-
-    Color(unsigned int red, unsigned int green, unsigned int blue)
-        : red(red)
-        , green(green)
-        , blue(blue)
-    {
-
-    }
-};
-
-Color color(unsigned int red, unsigned int green, unsigned int blue) {
-    return Color(red, green, blue);
+    window.framebuffer.clear(Color(0, 0, 0));
 }
 
 void put_pixel(Window& window,
                unsigned int x, unsigned int y, const Color& color)
 {
-    glBegin(GL_POINTS);
-        glColor3ub(color.red, color.green, color.blue);
-        glVertex2i(x, y);
-    glEnd();
+    window.framebuffer.put_pixel(x, y, color);
+}
+
+void draw_framebuffer(Window& window, const Framebuffer& fb,
+                      unsigned int x, unsigned int y)
+{
+    window.framebuffer.blit(fb, x, y);
 }
 
 }
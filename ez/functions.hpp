@@ -7,20 +7,14 @@
 #include <cmath>
 #include <unistd.h>
 #include "functions-glfw.hpp"
+#include "reader.hpp"
+#include "mapped-file.hpp"
+#include "random.hpp"
+#include "framebuffer.hpp"
+#include "parse.hpp"
 
 namespace ez {
 
-int random(int start, int stop) {
-    if (stop - start <= 0) {
-        return 0;
-    }
-    return start + std::rand() % (stop - start);
-}
-
-void set_random_seed(int seed) {
-    srand(seed);
-}
-
 int integer_from_string(const std::string& str) {
     return atoi(str.c_str());
 }
@@ -70,9 +64,15 @@ void close_file(File& file) {
 }
 
 std::string read_line_from_file(File file) {
-    static char buf[4096];
-    fgets(buf, sizeof(buf) - 1, file);
-    return std::string(buf);
+    std::string line;
+    char buf[4096];
+    while (fgets(buf, sizeof(buf), file)) {
+        line += buf;
+        if (line[line.size() - 1] == '\n') {
+            break;
+        }
+    }
+    return line;
 }
 
 bool is_file_over(File file) {
@@ -0,0 +1,335 @@
+#ifndef _ez_io_hpp_
+#define _ez_io_hpp_
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sstream>
+#include <mutex>
+#include "vector.hpp"
+#include "array.hpp"
+
+namespace ez {
+
+/* Console I/O used by the `print` and `read` instructions.
+ *
+ * Both sides are buffered in large blocks and format numbers by hand, where
+ * iostreams synchronize with stdio and go through the locale on each value.
+ * The output is flushed when the program exits, and before the input blocks
+ * waiting for data, so prompts are still shown before reading.
+ *
+ * The functions given to the parallel methods may print or read: each value
+ * is written or read under a lock, the values of concurrent prints may then
+ * be interleaved but never corrupted.
+ */
+class output {
+  private:
+    static const size_t BUFFER_SIZE = 64 * 1024;
+
+    char _buffer[BUFFER_SIZE];
+    size_t _size;
+    std::mutex _lock;
+
+    void drain() {
+        if (_size > 0) {
+            fwrite(_buffer, 1, _size, stdout);
+            _size = 0;
+        }
+        fflush(stdout);
+    }
+
+    void put(const char* data, size_t size) {
+        if (_size + size > BUFFER_SIZE) {
+            drain();
+            if (size > BUFFER_SIZE) {
+                fwrite(data, 1, size, stdout);
+                return;
+            }
+        }
+        memcpy(_buffer + _size, data, size);
+        _size += size;
+    }
+
+    template <typename U>
+    void write_unsigned(U value, bool negative = false) {
+        char digits[24];
+        int n = sizeof(digits);
+
+        do {
+            digits[--n] = '0' + value % 10;
+            value /= 10;
+        } while (value);
+        if (negative) {
+            digits[--n] = '-';
+        }
+
+        write(digits + n, sizeof(digits) - n);
+    }
+
+  public:
+    output() : _size(0) {
+
+    }
+
+    ~output() {
+        flush();
+    }
+
+    bool is_empty() {
+        std::lock_guard<std::mutex> guard(_lock);
+        return _size == 0;
+    }
+
+    void flush() {
+        std::lock_guard<std::mutex> guard(_lock);
+        drain();
+    }
+
+    void write(const char* data, size_t size) {
+        std::lock_guard<std::mutex> guard(_lock);
+        put(data, size);
+    }
+
+    output& operator<<(const char* s) {
+        write(s, strlen(s));
+        return *this;
+    }
+
+    output& operator<<(const std::string& s) {
+        write(s.data(), s.size());
+        return *this;
+    }
+
+    output& operator<<(char c) {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (_size == BUFFER_SIZE) {
+            drain();
+        }
+        _buffer[_size++] = c;
+        return *this;
+    }
+
+    /* Booleans are printed as numbers, like iostreams do by default. */
+    output& operator<<(bool b) {
+        return *this << (b ? '1' : '0');
+    }
+
+    output& operator<<(unsigned int n) {
+        write_unsigned(n);
+        return *this;
+    }
+
+    output& operator<<(int n) {
+        if (n < 0) {
+            write_unsigned(0u - (unsigned int)n, true);
+        } else {
+            write_unsigned((unsigned int)n);
+        }
+        return *this;
+    }
+
+    /* Same format as the iostreams default one. */
+    output& operator<<(double d) {
+        char buffer[32];
+        int size = snprintf(buffer, sizeof(buffer), "%g", d);
+        write(buffer, size);
+        return *this;
+    }
+
+    template <typename T>
+    output& operator<<(const vector<T>& v) {
+        *this << '[';
+        for (unsigned int i = 0; i < v.size(); i++) {
+            *this << v.at(i);
+            if (i + 1 < v.size()) {
+                write(", ", 2);
+            }
+        }
+        return *this << ']';
+    }
+
+    template <typename T, size_t N>
+    output& operator<<(const array<T, N>& a) {
+        *this << '[';
+        for (size_t i = 0; i < N; i++) {
+            *this << a.at(i);
+            if (i + 1 < N) {
+                write(", ", 2);
+            }
+        }
+        return *this << ']';
+    }
+
+    /* Anything else printable by iostreams. */
+    template <typename T>
+    output& operator<<(const T& value) {
+        std::ostringstream os;
+        os << value;
+        return *this << os.str();
+    }
+};
+
+class input {
+  private:
+    static const size_t BUFFER_SIZE = 64 * 1024;
+
+    char _buffer[BUFFER_SIZE];
+    size_t _position;
+    size_t _size;
+    output& _tied;
+    std::mutex _lock;
+
+    /* Returns the next character without consuming it, or EOF. */
+    int peek() {
+        if (_position == _size) {
+            _tied.flush();
+            _size = fread(_buffer, 1, BUFFER_SIZE, stdin);
+            _position = 0;
+            if (_size == 0) {
+                return EOF;
+            }
+        }
+        return (unsigned char)_buffer[_position];
+    }
+
+    int get() {
+        int c = peek();
+        if (c != EOF) {
+            _position++;
+        }
+        return c;
+    }
+
+    static bool is_space(int c) {
+        return c == ' ' || c == '\n' || c == '\t'
+            || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    static bool is_digit(int c) {
+        return c >= '0' && c <= '9';
+    }
+
+    int skip_spaces() {
+        int c = peek();
+        while (c != EOF && is_space(c)) {
+            _position++;
+            c = peek();
+        }
+        return c;
+    }
+
+    /* Reads an optional sign and digits, returns false if there were no
+     * digits. */
+    bool read_digits(bool& negative, unsigned long& value) {
+        int c = skip_spaces();
+
+        negative = (c == '-');
+        if (c == '-' || c == '+') {
+            _position++;
+            c = peek();
+        }
+
+        if (!is_digit(c)) {
+            return false;
+        }
+
+        value = 0;
+        while (is_digit(c)) {
+            value = value * 10 + (c - '0');
+            _position++;
+            c = peek();
+        }
+        return true;
+    }
+
+  public:
+    input(output& tied) : _position(0), _size(0), _tied(tied) {
+
+    }
+
+    input& operator>>(std::string& s) {
+        std::lock_guard<std::mutex> guard(_lock);
+        int c = skip_spaces();
+        if (c == EOF) {
+            return *this;
+        }
+
+        s.clear();
+        while (c != EOF && !is_space(c)) {
+            s += (char)c;
+            _position++;
+            c = peek();
+        }
+        return *this;
+    }
+
+    input& operator>>(char& c) {
+        std::lock_guard<std::mutex> guard(_lock);
+        int read = skip_spaces();
+        if (read != EOF) {
+            c = (char)get();
+        }
+        return *this;
+    }
+
+    input& operator>>(int& n) {
+        std::lock_guard<std::mutex> guard(_lock);
+        bool negative = false;
+        unsigned long value = 0;
+
+        n = read_digits(negative, value)
+          ? (negative ? -(int)value : (int)value)
+          : 0;
+        return *this;
+    }
+
+    input& operator>>(unsigned int& n) {
+        std::lock_guard<std::mutex> guard(_lock);
+        bool negative = false;
+        unsigned long value = 0;
+
+        n = read_digits(negative, value)
+          ? (negative ? 0u - (unsigned int)value : (unsigned int)value)
+          : 0;
+        return *this;
+    }
+
+    /* Booleans are read as numbers, like iostreams do by default. */
+    input& operator>>(bool& b) {
+        std::lock_guard<std::mutex> guard(_lock);
+        bool negative = false;
+        unsigned long value = 0;
+
+        b = read_digits(negative, value) && (unsigned int)value != 0;
+        return *this;
+    }
+
+    input& operator>>(double& d) {
+        std::lock_guard<std::mutex> guard(_lock);
+        char buffer[64];
+        size_t size = 0;
+        int c = skip_spaces();
+
+        while (c != EOF && size + 1 < sizeof(buffer)
+           &&  (is_digit(c) || c == '.' || c == '-' || c == '+'
+             || c == 'e' || c == 'E'))
+        {
+            buffer[size++] = (char)c;
+            _position++;
+            c = peek();
+        }
+        buffer[size] = '\0';
+
+        d = strtod(buffer, NULL);
+        return *this;
+    }
+};
+
+output out;
+input in(out);
+
+}
+
+#endif
+
@@ -0,0 +1,215 @@
+#ifndef _ez_map_hpp_
+#define _ez_map_hpp_
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ez {
+
+/* EZ maps, hash tables with open addressing over flat storage.
+ *
+ * The entries are stored contiguously in `_entries`, so iterating over them
+ * (with `key_at` and `value_at`) is a plain array walk. The table itself,
+ * `_slots`, only holds entry indexes: it is probed linearly and kept at most
+ * half full, and stays small since its slots are 32 bits.
+ *
+ * Removing an entry moves the last one in its place: entries keep their
+ * insertion order until something is removed.
+ *
+ * Defining EZ_BOUNDS_CHECK makes the `key_at` and `value_at` accesses out of
+ * the map exit the program with an error instead of being undefined.
+ */
+template <typename K, typename V>
+class map {
+  private:
+    struct entry {
+        K key;
+        V value;
+        size_t hash;
+    };
+
+    enum : uint32_t { EMPTY = UINT32_MAX };
+
+    std::vector<entry> _entries;
+    std::vector<uint32_t> _slots;
+
+    /* std::hash is the identity for integers: mix it so that consecutive
+     * keys don't fill consecutive slots. */
+    static size_t hash(const K& key) {
+        uint64_t h = std::hash<K>()(key);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    size_t mask() const {
+        return _slots.size() - 1;
+    }
+
+    /* The slot holding `key`, or the empty slot where it would go. */
+    size_t find_slot(const K& key, size_t h) const {
+        size_t slot = h & mask();
+        while (_slots[slot] != EMPTY) {
+            const entry& e = _entries[_slots[slot]];
+            if (e.hash == h && e.key == key) {
+                break;
+            }
+            slot = (slot + 1) & mask();
+        }
+        return slot;
+    }
+
+    /* The slot holding the entry `index`. */
+    size_t slot_of(uint32_t index) const {
+        size_t slot = _entries[index].hash & mask();
+        while (_slots[slot] != index) {
+            slot = (slot + 1) & mask();
+        }
+        return slot;
+    }
+
+    const entry* find(const K& key) const {
+        if (_entries.empty()) {
+            return NULL;
+        }
+        uint32_t index = _slots[find_slot(key, hash(key))];
+        return index == EMPTY ? NULL : &_entries[index];
+    }
+
+    void rehash(size_t nslots) {
+        _slots.assign(nslots, EMPTY);
+        for (uint32_t i = 0; i < _entries.size(); i++) {
+            size_t slot = _entries[i].hash & mask();
+            while (_slots[slot] != EMPTY) {
+                slot = (slot + 1) & mask();
+            }
+            _slots[slot] = i;
+        }
+    }
+
+    void check_index(unsigned int n) const {
+#ifdef EZ_BOUNDS_CHECK
+        if (n >= _entries.size()) {
+            fprintf(stderr, "map index %u out of bounds (size %u)\n",
+                    n, size());
+            exit(EXIT_FAILURE);
+        }
+#else
+        (void)n;
+#endif
+    }
+
+    static void missing_key() {
+        fprintf(stderr, "accessing a missing map key\n");
+        exit(EXIT_FAILURE);
+    }
+
+  public:
+    /* Associates `value` to `key`, replacing its former value if any. */
+    template <typename KK, typename VV>
+    void put(KK&& key, VV&& value) {
+        if ((_entries.size() + 1) * 2 > _slots.size()) {
+            rehash(_slots.empty() ? 16 : _slots.size() * 2);
+        }
+
+        K k(std::forward<KK>(key));
+        const size_t h = hash(k);
+        const size_t slot = find_slot(k, h);
+        if (_slots[slot] != EMPTY) {
+            _entries[_slots[slot]].value = std::forward<VV>(value);
+            return;
+        }
+
+        /* The entry is built before being pushed, as `value` may be a value
+         * of this map, which pushing could move. */
+        entry e = {std::move(k), V(std::forward<VV>(value)), h};
+        _slots[slot] = _entries.size();
+        _entries.push_back(std::move(e));
+    }
+
+    const V& get(const K& key) const {
+        const entry* e = find(key);
+        if (!e) {
+            missing_key();
+        }
+        return e->value;
+    }
+
+    V& get(const K& key) {
+        return const_cast<V&>(static_cast<const map*>(this)->get(key));
+    }
+
+    bool has(const K& key) const {
+        return find(key) != NULL;
+    }
+
+    /* Removes `key` and its value, if it is in the map. */
+    void remove(const K& key) {
+        if (_entries.empty()) {
+            return;
+        }
+
+        size_t slot = find_slot(key, hash(key));
+        const uint32_t index = _slots[slot];
+        if (index == EMPTY) {
+            return;
+        }
+
+        /* Shift back the following entries of the probe sequence that
+         * could go in the freed slot, so no probe stops too early. */
+        size_t next = slot;
+        while (true) {
+            next = (next + 1) & mask();
+            if (_slots[next] == EMPTY) {
+                break;
+            }
+            size_t home = _entries[_slots[next]].hash & mask();
+            if (((next - home) & mask()) >= ((next - slot) & mask())) {
+                _slots[slot] = _slots[next];
+                slot = next;
+            }
+        }
+        _slots[slot] = EMPTY;
+
+        const uint32_t last = _entries.size() - 1;
+        if (index != last) {
+            _slots[slot_of(last)] = index;
+            _entries[index] = std::move(_entries[last]);
+        }
+        _entries.pop_back();
+    }
+
+    void clear() {
+        _entries.clear();
+        _slots.clear();
+    }
+
+    unsigned int size() const {
+        return _entries.size();
+    }
+
+    const K& key_at(unsigned int n) const {
+        check_index(n);
+        return _entries[n].key;
+    }
+
+    const V& value_at(unsigned int n) const {
+        check_index(n);
+        return _entries[n].value;
+    }
+
+    V& value_at(unsigned int n) {
+        check_index(n);
+        return _entries[n].value;
+    }
+};
+
+}
+
+#endif
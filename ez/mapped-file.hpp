@@ -0,0 +1,187 @@
+#ifndef _ez_mapped_file_hpp_
+#define _ez_mapped_file_hpp_
+
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ez {
+
+/* A whole file mapped read-only in memory. Its bytes are read in place,
+ * without being copied through a buffer.
+ *
+ * A mapped file owns its mapping: it can be moved, not copied. Empty files
+ * are mapped with no memory. Files are indexed by naturals, so the ones
+ * bigger than 4GiB can't be mapped.
+ */
+class MappedFile {
+  private:
+    const char* _data;
+    size_t _size;
+    bool _mapped;
+
+    void check_index(unsigned int n) const {
+#ifdef EZ_BOUNDS_CHECK
+        if (n >= _size) {
+            fprintf(stderr, "mapped file index %u out of bounds (size %u)\n",
+                    n, size());
+            exit(EXIT_FAILURE);
+        }
+#else
+        (void)n;
+#endif
+    }
+
+  public:
+    MappedFile() : _data(NULL), _size(0), _mapped(false) {
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : _data(other._data), _size(other._size), _mapped(other._mapped)
+    {
+        other._data = NULL;
+        other._size = 0;
+        other._mapped = false;
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            _data = other._data;
+            _size = other._size;
+            _mapped = other._mapped;
+            other._data = NULL;
+            other._size = 0;
+            other._mapped = false;
+        }
+        return *this;
+    }
+
+    ~MappedFile() {
+        unmap();
+    }
+
+    bool map(const std::string& path) {
+        unmap();
+
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) < 0 || (unsigned long long)st.st_size > UINT_MAX) {
+            ::close(fd);
+            return false;
+        }
+
+        if (st.st_size > 0) {
+            void* data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                ::close(fd);
+                return false;
+            }
+            madvise(data, st.st_size, MADV_SEQUENTIAL);
+            _data = (const char*)data;
+            _size = st.st_size;
+        }
+        /* The mapping stays valid once the file is closed. */
+        ::close(fd);
+        _mapped = true;
+        return true;
+    }
+
+    void unmap() {
+        if (_data) {
+            munmap((void*)_data, _size);
+        }
+        _data = NULL;
+        _size = 0;
+        _mapped = false;
+    }
+
+    bool is_mapped() const {
+        return _mapped;
+    }
+
+    unsigned int size() const {
+        return _size;
+    }
+
+    const char* data() const {
+        return _data;
+    }
+
+    char at(unsigned int n) const {
+        check_index(n);
+        return _data[n];
+    }
+
+    /* Index of the first `c` from `from`, or the size if there is none. */
+    unsigned int find(char c, unsigned int from) const {
+        if (from >= _size) {
+            return _size;
+        }
+        const char* found = (const char*)memchr(_data + from, c, _size - from);
+        return found ? found - _data : _size;
+    }
+
+    std::string substring(unsigned int from, unsigned int to) const {
+        if (to > _size) {
+            to = _size;
+        }
+        if (from >= to) {
+            return std::string();
+        }
+        return std::string(_data + from, to - from);
+    }
+};
+
+void map_file(const std::string& path, MappedFile& file) {
+    file.map(path);
+}
+
+bool is_file_mapped(const MappedFile& file) {
+    return file.is_mapped();
+}
+
+void unmap_file(MappedFile& file) {
+    file.unmap();
+}
+
+unsigned int mapped_file_size(const MappedFile& file) {
+    return file.size();
+}
+
+char mapped_file_char(const MappedFile& file, unsigned int index) {
+    return file.at(index);
+}
+
+unsigned int mapped_file_find(const MappedFile& file, char c,
+                              unsigned int from)
+{
+    return file.find(c, from);
+}
+
+unsigned int mapped_file_line_end(const MappedFile& file, unsigned int from) {
+    return file.find('\n', from);
+}
+
+std::string mapped_file_substring(const MappedFile& file,
+                                  unsigned int from, unsigned int to)
+{
+    return file.substring(from, to);
+}
+
+}
+
+#endif
@@ -3,70 +3,218 @@
 
 #include <cstdlib>
 #include <cstdio>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace ez {
 
+/* Whether the optionals of `T` keep their value on the heap. The compiler
+ * specializes it for the types that are incomplete where optionals of them
+ * are declared, like the structures containing optionals of themselves, or
+ * of arrays of themselves.
+ */
 template <typename T>
-class optional {
+struct optional_is_boxed : std::false_type {};
+
+template <typename T, bool Boxed = optional_is_boxed<T>::value>
+class optional_storage;
+
+/* The value is stored in the optional itself: no allocation. */
+template <typename T>
+class optional_storage<T, false> {
   private:
-    int* _refcount;
-    T* _value;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type _storage;
+    bool _set;
 
-  public:
-    optional() {
-        _refcount = new int;
-        *_refcount = 0;
-        _value = NULL;
+  protected:
+    optional_storage() : _set(false) {
     }
 
-    optional(const T& value) {
-        _refcount = new int;
-        *_refcount = 0;
-        set(value);
+    optional_storage(const optional_storage& other) : _set(false) {
+        if (other._set) {
+            assign(*other.value());
+        }
+    }
+
+    optional_storage(optional_storage&& other)
+        noexcept(std::is_nothrow_move_constructible<T>::value)
+        : _set(false)
+    {
+        if (other._set) {
+            assign(std::move(*other.value()));
+        }
     }
 
-    optional(const optional<T>& opt) {
-        _refcount = opt._refcount;
-        (*_refcount)++;
-        _value = opt._value;
+    ~optional_storage() {
+        reset();
     }
 
-    ~optional() {
-        if (*_refcount == 0 && _value) {
-            delete _value;
-            delete _refcount;
+    optional_storage& operator=(const optional_storage& other) {
+        if (other._set) {
+            assign(*other.value());
         } else {
-            (*_refcount)--;
+            reset();
         }
+        return *this;
     }
 
-    bool is_set() const {
+    optional_storage& operator=(optional_storage&& other) {
+        if (other._set) {
+            assign(std::move(*other.value()));
+        } else {
+            reset();
+        }
+        return *this;
+    }
+
+    bool has_value() const {
+        return _set;
+    }
+
+    T* value() {
+        return reinterpret_cast<T*>(&_storage);
+    }
+
+    const T* value() const {
+        return reinterpret_cast<const T*>(&_storage);
+    }
+
+    template <typename U>
+    void assign(U&& value) {
+        if (_set) {
+            *this->value() = std::forward<U>(value);
+        } else {
+            new (&_storage) T(std::forward<U>(value));
+            _set = true;
+        }
+    }
+
+    void reset() {
+        if (_set) {
+            value()->~T();
+            _set = false;
+        }
+    }
+};
+
+/* The value is owned through a pointer, so `T` may be incomplete where the
+ * optional is declared. Copies are deep, moves steal the pointer.
+ *
+ * The new value is always built before the old one is released, as it may
+ * be a part of it (`tree.set(tree.get().left.get())`).
+ */
+template <typename T>
+class optional_storage<T, true> {
+  private:
+    T* _value;
+
+  protected:
+    optional_storage() : _value(NULL) {
+    }
+
+    optional_storage(const optional_storage& other)
+        : _value(other._value ? new T(*other._value) : NULL)
+    {
+    }
+
+    optional_storage(optional_storage&& other) noexcept
+        : _value(other._value)
+    {
+        other._value = NULL;
+    }
+
+    ~optional_storage() {
+        delete _value;
+    }
+
+    optional_storage& operator=(const optional_storage& other) {
+        T* value = other._value ? new T(*other._value) : NULL;
+        delete _value;
+        _value = value;
+        return *this;
+    }
+
+    optional_storage& operator=(optional_storage&& other) noexcept {
+        T* value = other._value;
+        other._value = NULL;
+        delete _value;
+        _value = value;
+        return *this;
+    }
+
+    bool has_value() const {
         return _value != NULL;
     }
 
-    void set(const T& value) {
-        _value = new T;
-        *_value = value;
+    T* value() {
+        return _value;
     }
 
-    const T& get() const {
+    const T* value() const {
+        return _value;
+    }
+
+    template <typename U>
+    void assign(U&& value) {
+        T* copy = new T(std::forward<U>(value));
+        delete _value;
+        _value = copy;
+    }
+
+    void reset() {
+        delete _value;
+        _value = NULL;
+    }
+};
+
+/* EZ optionals have value semantics: copying an optional copies its value.
+ */
+template <typename T>
+class optional : private optional_storage<T> {
+  private:
+    void check_set() const {
         if (!is_set()) {
             fprintf(stderr, "accessing unset optional value\n");
             exit(EXIT_FAILURE);
         }
-        return *_value;
+    }
+
+  public:
+    optional() {
+    }
+
+    optional(const T& value) {
+        set(value);
+    }
+
+    optional(T&& value) {
+        set(std::move(value));
+    }
+
+    bool is_set() const {
+        return this->has_value();
+    }
+
+    void set(const T& value) {
+        this->assign(value);
+    }
+
+    void set(T&& value) {
+        this->assign(std::move(value));
+    }
+
+    const T& get() const {
+        check_set();
+        return *this->value();
     }
 
     T& get() {
-        if (!is_set()) {
-            fprintf(stderr, "accessing unset optional value\n");
-            exit(EXIT_FAILURE);
-        }
-        return *_value;
+        check_set();
+        return *this->value();
     }
 };
 
 }
 
 #endif
-
@@ -0,0 +1,315 @@
+#ifndef _ez_parallel_hpp_
+#define _ez_parallel_hpp_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ez {
+
+/* Size of the chunks the parallel vector operations are split in, so each
+ * one stays in the cache of the core running it. */
+#ifndef EZ_PARALLEL_CHUNK_BYTES
+#define EZ_PARALLEL_CHUNK_BYTES (32 * 1024)
+#endif
+
+template <typename T>
+size_t parallel_chunk_size() {
+    size_t size = EZ_PARALLEL_CHUNK_BYTES / sizeof(T);
+    return size > 0 ? size : 1;
+}
+
+/* A fixed-size pool of threads, one per core (the calling thread being one
+ * of them) unless the EZ_THREADS environment variable gives their number.
+ * It is started on first use and stopped when the program exits.
+ *
+ * The indexes of a job are split in one contiguous range per thread. A
+ * thread takes the indexes of its range in order, and once it is done steals
+ * the second half of the range of another one: neighbour indexes mostly run
+ * on the same thread, and uneven indexes are balanced between the threads.
+ *
+ * Only one job runs at a time: a job started while another one runs, or
+ * from a job (by any thread working on it, the one that started it too),
+ * runs sequentially in its calling thread.
+ */
+class thread_pool {
+  private:
+    /* The indexes [begin, end) left to a thread, packed in one word so they
+     * are taken and stolen with a compare-and-swap. The slots are padded to
+     * keep each one on its own cache line. */
+    struct slot {
+        std::atomic<uint64_t> bounds;
+        char padding[64 - sizeof(std::atomic<uint64_t>)];
+    };
+
+    struct job {
+        const std::function<void(size_t)>* func;
+        std::unique_ptr<slot[]> slots;
+        unsigned int nslots;
+        std::atomic<unsigned int> joined;
+        std::atomic<size_t> remaining;
+    };
+
+    std::vector<std::thread> _threads;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    std::atomic<bool> _busy;
+
+    job* _job;
+    unsigned int _generation;
+    unsigned int _active;
+    bool _stopping;
+
+    static uint64_t pack(uint64_t begin, uint64_t end) {
+        return begin << 32 | end;
+    }
+
+    /* Takes the first index left in `s`. */
+    static bool take(slot& s, size_t& i) {
+        uint64_t bounds = s.bounds.load();
+        while (true) {
+            uint64_t begin = bounds >> 32;
+            uint64_t end = bounds & UINT32_MAX;
+            if (begin >= end) {
+                return false;
+            }
+            if (s.bounds.compare_exchange_weak(bounds, pack(begin + 1, end))) {
+                i = begin;
+                return true;
+            }
+        }
+    }
+
+    /* Takes the second half of the indexes left in another slot: the first
+     * one is returned in `i`, the others are left in the empty slot `self`. */
+    static bool steal(job* j, unsigned int self, size_t& i) {
+        for (unsigned int k = 1; k < j->nslots; k++) {
+            slot& victim = j->slots[(self + k) % j->nslots];
+            uint64_t bounds = victim.bounds.load();
+
+            while (true) {
+                uint64_t begin = bounds >> 32;
+                uint64_t end = bounds & UINT32_MAX;
+                if (begin >= end) {
+                    break;
+                }
+
+                uint64_t middle = begin + (end - begin) / 2;
+                if (victim.bounds.compare_exchange_weak(bounds,
+                                                        pack(begin, middle)))
+                {
+                    i = middle;
+                    j->slots[self].bounds.store(pack(middle + 1, end));
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /* Whether the calling thread is working on a job. */
+    static bool& in_job() {
+        static thread_local bool inside = false;
+        return inside;
+    }
+
+    void work(job* j) {
+        const unsigned int self = j->joined++;
+        if (self >= j->nslots) {
+            return;
+        }
+
+        size_t i;
+        size_t done = 0;
+        in_job() = true;
+        while (take(j->slots[self], i) || steal(j, self, i)) {
+            (*j->func)(i);
+            done++;
+        }
+        in_job() = false;
+
+        if (done > 0 && (j->remaining -= done) == 0) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _done.notify_all();
+        }
+    }
+
+    void worker() {
+        unsigned int seen = 0;
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        while (true) {
+            _wake.wait(lock, [&]() {
+                return _stopping || (_job && _generation != seen);
+            });
+            if (_stopping) {
+                return;
+            }
+
+            seen = _generation;
+            job* j = _job;
+            _active++;
+            lock.unlock();
+
+            work(j);
+
+            lock.lock();
+            _active--;
+            _done.notify_all();
+        }
+    }
+
+    thread_pool()
+        : _busy(false), _job(NULL), _generation(0), _active(0)
+        , _stopping(false)
+    {
+        unsigned int cores = std::thread::hardware_concurrency();
+        const char* threads = getenv("EZ_THREADS");
+        if (threads && atoi(threads) > 0) {
+            cores = atoi(threads);
+        }
+
+        for (unsigned int i = 1; i < cores; i++) {
+            _threads.push_back(std::thread(&thread_pool::worker, this));
+        }
+    }
+
+  public:
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _wake.notify_all();
+        for (std::thread& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    static thread_pool& instance() {
+        static thread_pool pool;
+        return pool;
+    }
+
+    /* The number of threads running the jobs, the calling one included. */
+    unsigned int size() const {
+        return _threads.size() + 1;
+    }
+
+    /* Calls `func(i)` for each `i` in [0, count), and returns once all the
+     * calls are done. `count` must fit in 32 bits. */
+    template <typename F>
+    void run(size_t count, const F& func) {
+        if (count <= 1 || _threads.empty() || in_job() || _busy.exchange(true))
+        {
+            for (size_t i = 0; i < count; i++) {
+                func(i);
+            }
+            return;
+        }
+
+        const std::function<void(size_t)> erased = std::cref(func);
+        job j;
+        j.func = &erased;
+        j.nslots = size();
+        j.slots.reset(new slot[j.nslots]);
+        for (unsigned int s = 0; s < j.nslots; s++) {
+            j.slots[s].bounds = pack(count * s / j.nslots,
+                                     count * (s + 1) / j.nslots);
+        }
+        j.joined = 0;
+        j.remaining = count;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _job = &j;
+            _generation++;
+        }
+        _wake.notify_all();
+
+        work(&j);
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _done.wait(lock, [&]() { return j.remaining == 0; });
+            /* No thread may start on the job once it is done, and the ones
+             * that started must be over before it goes out of scope. */
+            _job = NULL;
+            _done.wait(lock, [&]() { return _active == 0; });
+        }
+        _busy = false;
+    }
+};
+
+/* Number of chunks per thread the `parallel for` loops are split in: enough
+ * for the stealing to balance uneven iterations, few enough for the cost of
+ * a chunk to vanish next to its iterations. */
+#ifndef EZ_PARALLEL_CHUNKS_PER_THREAD
+#define EZ_PARALLEL_CHUNKS_PER_THREAD 16
+#endif
+
+/* The range of a `parallel for` loop, [begin, end) split in chunks run on
+ * the thread pool.
+ */
+template <typename I>
+class parallel_range {
+  private:
+    I _begin;
+    I _end;
+    size_t _count;
+    size_t _chunks;
+
+    I chunk_begin(size_t chunk) const {
+        return _begin + (I)(_count * chunk / _chunks);
+    }
+
+  public:
+    parallel_range(I begin, I end)
+        : _begin(begin)
+        , _end(end < begin ? begin : end)
+        , _count((long long)_end - (long long)_begin)
+    {
+        size_t chunks = (size_t)thread_pool::instance().size()
+                      * EZ_PARALLEL_CHUNKS_PER_THREAD;
+        _chunks = _count < chunks ? _count : chunks;
+    }
+
+    /* The value of the loop subject after the loop. */
+    I end() const {
+        return _end;
+    }
+
+    size_t chunks() const {
+        return _chunks;
+    }
+
+    /* Storage for one partial result of a reduction per chunk. */
+    template <typename T>
+    std::unique_ptr<T[]> parts() const {
+        return std::unique_ptr<T[]>(new T[_chunks]);
+    }
+
+    /* Calls `body(chunk, from, to)` on each chunk [from, to) of the range,
+     * and returns once all the calls are done. */
+    template <typename F>
+    void run(const F& body) const {
+        thread_pool::instance().run(_chunks, [&](size_t chunk) {
+            body(chunk, chunk_begin(chunk), chunk_begin(chunk + 1));
+        });
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,212 @@
+#ifndef _ez_parse_hpp_
+#define _ez_parse_hpp_
+
+#include <cstdio>
+#include <cstdlib>
+#include <climits>
+#include <string>
+#include "vector.hpp"
+#include "optional.hpp"
+#include "mapped-file.hpp"
+
+namespace ez {
+
+/* Parsing of whole texts of numbers, in place. Numbers are separated by a
+ * delimiter or by line ends, and may be surrounded by spaces. Errors give
+ * the line of the number that couldn't be parsed.
+ *
+ * The programs are compiled as C++11, which has no std::from_chars: integers
+ * are parsed by hand, reals by strtod on a copy of the number only.
+ */
+class number_parser {
+  private:
+    const char* _it;
+    const char* _end;
+    char _delimiter;
+    unsigned int _line;
+
+    static bool is_space(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    void skip_spaces() {
+        while (_it < _end && is_space(*_it)) {
+            _it++;
+        }
+    }
+
+    /* Skips the blank lines, returns false at the end of the text. */
+    bool next_number() {
+        while (true) {
+            skip_spaces();
+            if (_it == _end) {
+                return false;
+            }
+            if (*_it != '\n') {
+                return true;
+            }
+            _line++;
+            _it++;
+        }
+    }
+
+    /* After a number: a delimiter followed by another number, a line end or
+     * the end. Returns the error, if any. */
+    const char* end_number() {
+        const char* start = _it;
+        skip_spaces();
+        if (_it == _end || *_it == '\n') {
+            return NULL;
+        }
+
+        if (*_it == _delimiter) {
+            _it++;
+            skip_spaces();
+        } else if (!is_space(_delimiter) || _it == start) {
+            return "expected a delimiter after a number";
+        }
+        if (_it == _end || *_it == '\n') {
+            return "expected a number after a delimiter";
+        }
+        return NULL;
+    }
+
+    optional<std::string> error(const char* what) const {
+        char message[64];
+        snprintf(message, sizeof(message), "line %u: %s", _line, what);
+        return optional<std::string>(std::string(message));
+    }
+
+    bool parse_integer(int& n) {
+        bool negative = false;
+        if (_it < _end && (*_it == '-' || *_it == '+')) {
+            negative = *_it == '-';
+            _it++;
+        }
+        if (_it == _end || *_it < '0' || *_it > '9') {
+            return false;
+        }
+
+        /* Accumulate negatively, INT_MIN having no positive counterpart. */
+        long long value = 0;
+        while (_it < _end && *_it >= '0' && *_it <= '9') {
+            value = value * 10 - (*_it - '0');
+            if (value < INT_MIN) {
+                return false;
+            }
+            _it++;
+        }
+        if (!negative && value < -INT_MAX) {
+            return false;
+        }
+        n = negative ? (int)value : (int)-value;
+        return true;
+    }
+
+    bool parse_real(double& d) {
+        char buffer[64];
+        size_t size = 0;
+        while (_it + size < _end && size < sizeof(buffer) - 1
+           &&  !is_space(_it[size]) && _it[size] != '\n'
+           &&  _it[size] != _delimiter)
+        {
+            buffer[size] = _it[size];
+            size++;
+        }
+        buffer[size] = '\0';
+
+        char* end;
+        d = strtod(buffer, &end);
+        if (size == 0 || end == buffer) {
+            return false;
+        }
+        _it += end - buffer;
+        return true;
+    }
+
+  public:
+    number_parser(const char* begin, const char* end, char delimiter)
+        : _it(begin), _end(end), _delimiter(delimiter), _line(1)
+    {
+    }
+
+    optional<std::string> parse(vector<int>& numbers) {
+        numbers.clear();
+        while (next_number()) {
+            int n;
+            if (!parse_integer(n)) {
+                return error("invalid integer");
+            }
+            if (const char* what = end_number()) {
+                return error(what);
+            }
+            numbers.push(n);
+        }
+        return optional<std::string>();
+    }
+
+    optional<std::string> parse(vector<double>& numbers) {
+        numbers.clear();
+        while (next_number()) {
+            double d;
+            if (!parse_real(d)) {
+                return error("invalid real");
+            }
+            if (const char* what = end_number()) {
+                return error(what);
+            }
+            numbers.push(d);
+        }
+        return optional<std::string>();
+    }
+};
+
+template <typename T>
+optional<std::string> parse_numbers(const std::string& text, char delimiter,
+                                    vector<T>& numbers)
+{
+    number_parser parser(text.data(), text.data() + text.size(), delimiter);
+    return parser.parse(numbers);
+}
+
+template <typename T>
+optional<std::string> load_numbers(const std::string& path, char delimiter,
+                                   vector<T>& numbers)
+{
+    MappedFile file;
+    if (!file.map(path)) {
+        numbers.clear();
+        return optional<std::string>("couldn't open " + path);
+    }
+
+    number_parser parser(file.data(), file.data() + file.size(), delimiter);
+    return parser.parse(numbers);
+}
+
+optional<std::string> parse_integers(const std::string& text, char delimiter,
+                                     vector<int>& numbers)
+{
+    return parse_numbers(text, delimiter, numbers);
+}
+
+optional<std::string> parse_reals(const std::string& text, char delimiter,
+                                  vector<double>& numbers)
+{
+    return parse_numbers(text, delimiter, numbers);
+}
+
+optional<std::string> load_integers(const std::string& path, char delimiter,
+                                    vector<int>& numbers)
+{
+    return load_numbers(path, delimiter, numbers);
+}
+
+optional<std::string> load_reals(const std::string& path, char delimiter,
+                                 vector<double>& numbers)
+{
+    return load_numbers(path, delimiter, numbers);
+}
+
+}
+
+#endif
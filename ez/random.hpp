@@ -0,0 +1,168 @@
+#ifndef _ez_random_hpp_
+#define _ez_random_hpp_
+
+#include <atomic>
+#include <cstdint>
+#include "vector.hpp"
+
+namespace ez {
+
+/* A xoshiro256** pseudo-random generator. Each generator has its own state,
+ * so generators used by different threads don't share anything.
+ *
+ * `jump` advances a generator by 2^128 draws: splitting a generator gives
+ * streams that won't overlap, to be used by parallel jobs.
+ */
+class Random {
+  private:
+    uint64_t _state[4];
+
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    /* splitmix64, to spread the seed bits over the whole state. */
+    static uint64_t splitmix(uint64_t& x) {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+  public:
+    Random() {
+        seed(0);
+    }
+
+    void seed(uint64_t seed) {
+        for (int i = 0; i < 4; i++) {
+            _state[i] = splitmix(seed);
+        }
+    }
+
+    uint64_t next() {
+        const uint64_t result = rotl(_state[1] * 5, 7) * 9;
+        const uint64_t t = _state[1] << 17;
+
+        _state[2] ^= _state[0];
+        _state[3] ^= _state[1];
+        _state[1] ^= _state[2];
+        _state[0] ^= _state[3];
+        _state[2] ^= t;
+        _state[3] = rotl(_state[3], 45);
+
+        return result;
+    }
+
+    void jump() {
+        static const uint64_t JUMP[] = {
+            0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+            0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+        };
+        uint64_t state[4] = {0, 0, 0, 0};
+
+        for (int i = 0; i < 4; i++) {
+            for (int b = 0; b < 64; b++) {
+                if (JUMP[i] & (1ULL << b)) {
+                    for (int j = 0; j < 4; j++) {
+                        state[j] ^= _state[j];
+                    }
+                }
+                next();
+            }
+        }
+        for (int j = 0; j < 4; j++) {
+            _state[j] = state[j];
+        }
+    }
+
+    /* Gives this generator's stream to `stream`, and jumps this generator
+     * past it. */
+    void split(Random& stream) {
+        stream = *this;
+        jump();
+    }
+
+    /* Uniform integer in [start, stop), without modulo bias (Lemire's
+     * multiply and reject method). Returns 0 for an empty range. */
+    int integer(int start, int stop) {
+        if (stop <= start) {
+            return 0;
+        }
+
+        const uint32_t range = (uint32_t)stop - (uint32_t)start;
+        uint64_t m = (next() >> 32) * range;
+        if ((uint32_t)m < range) {
+            const uint32_t threshold = -range % range;
+            while ((uint32_t)m < threshold) {
+                m = (next() >> 32) * range;
+            }
+        }
+        return (int)((uint32_t)start + (uint32_t)(m >> 32));
+    }
+
+    /* Uniform real in [0, 1). */
+    double real() {
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
+
+/* The generator of `random`, one per thread: the nth thread using it gets
+ * the stream of the unseeded generator jumped n times. */
+Random thread_stream(unsigned int index) {
+    Random random;
+    for (unsigned int i = 0; i < index; i++) {
+        random.jump();
+    }
+    return random;
+}
+
+Random& thread_random() {
+    static std::atomic<unsigned int> threads(0);
+    thread_local Random random = thread_stream(threads++);
+    return random;
+}
+
+int random(int start, int stop) {
+    return thread_random().integer(start, stop);
+}
+
+void set_random_seed(int seed) {
+    thread_random().seed(seed);
+}
+
+void seed_random(Random& random, int seed) {
+    random.seed(seed);
+}
+
+int random_integer(Random& random, int start, int stop) {
+    return random.integer(start, stop);
+}
+
+double random_real(Random& random) {
+    return random.real();
+}
+
+void split_random(Random& random, Random& stream) {
+    random.split(stream);
+}
+
+void fill_random_integers(Random& random, vector<int>& v, unsigned int count,
+                          int start, int stop)
+{
+    v.clear();
+    for (unsigned int i = 0; i < count; i++) {
+        v.push(random.integer(start, stop));
+    }
+}
+
+void fill_random_reals(Random& random, vector<double>& v, unsigned int count) {
+    v.clear();
+    for (unsigned int i = 0; i < count; i++) {
+        v.push(random.real());
+    }
+}
+
+}
+
+#endif
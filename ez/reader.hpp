@@ -0,0 +1,144 @@
+#ifndef _ez_reader_hpp_
+#define _ez_reader_hpp_
+
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace ez {
+
+/* Size of the blocks a reader reads ahead. */
+#ifndef EZ_READER_BUFFER_SIZE
+#define EZ_READER_BUFFER_SIZE (1024 * 1024)
+#endif
+
+/* A file opened for reading line by line. It reads the file by large blocks
+ * and copies the lines from them, so lines have no maximal length and there
+ * is no per-line system call.
+ *
+ * A reader owns its file: it can be moved, not copied.
+ */
+class Reader {
+  private:
+    int _fd;
+    std::unique_ptr<char[]> _buffer;
+    size_t _begin;
+    size_t _end;
+
+    bool fill() {
+        ssize_t size;
+        do {
+            size = ::read(_fd, _buffer.get(), EZ_READER_BUFFER_SIZE);
+        } while (size < 0 && errno == EINTR);
+
+        _begin = 0;
+        _end = size > 0 ? size : 0;
+        return _end > 0;
+    }
+
+  public:
+    Reader() : _fd(-1), _begin(0), _end(0) {
+    }
+
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    Reader(Reader&& other) noexcept
+        : _fd(other._fd), _buffer(std::move(other._buffer)),
+          _begin(other._begin), _end(other._end)
+    {
+        other._fd = -1;
+    }
+
+    Reader& operator=(Reader&& other) noexcept {
+        if (this != &other) {
+            close();
+            _fd = other._fd;
+            _buffer = std::move(other._buffer);
+            _begin = other._begin;
+            _end = other._end;
+            other._fd = -1;
+        }
+        return *this;
+    }
+
+    ~Reader() {
+        close();
+    }
+
+    bool open(const std::string& path) {
+        close();
+        _fd = ::open(path.c_str(), O_RDONLY);
+        if (_fd < 0) {
+            return false;
+        }
+#ifdef POSIX_FADV_SEQUENTIAL
+        posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+        if (!_buffer) {
+            _buffer.reset(new char[EZ_READER_BUFFER_SIZE]);
+        }
+        return true;
+    }
+
+    bool is_open() const {
+        return _fd >= 0;
+    }
+
+    void close() {
+        if (_fd >= 0) {
+            ::close(_fd);
+            _fd = -1;
+        }
+        _begin = _end = 0;
+    }
+
+    /* Reads the next line, with its '\n' if it has one, into `line`. The
+     * storage of `line` is reused. Returns false if the file is over. */
+    bool read_line(std::string& line) {
+        line.clear();
+        if (_fd < 0) {
+            return false;
+        }
+
+        while (true) {
+            if (_begin == _end && !fill()) {
+                return !line.empty();
+            }
+
+            const char* start = _buffer.get() + _begin;
+            const char* newline =
+                (const char*)memchr(start, '\n', _end - _begin);
+            if (newline) {
+                line.append(start, newline + 1 - start);
+                _begin += newline + 1 - start;
+                return true;
+            }
+            line.append(start, _end - _begin);
+            _begin = _end;
+        }
+    }
+};
+
+void open_reader(const std::string& path, Reader& reader) {
+    reader.open(path);
+}
+
+bool is_reader_open(const Reader& reader) {
+    return reader.is_open();
+}
+
+bool read_line(Reader& reader, std::string& line) {
+    return reader.read_line(line);
+}
+
+void close_reader(Reader& reader) {
+    reader.close();
+}
+
+}
+
+#endif
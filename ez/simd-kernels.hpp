@@ -0,0 +1,167 @@
+/* The numeric kernels of the vectors, written once over the packs of values
+ * `pack<T>` of the namespace including this file: simd.hpp includes it once
+ * per instruction set, so it has no include guard.
+ *
+ * A pack `P` holds `P::width` values of type `P::type`. The values left
+ * after the last whole pack are handled one by one.
+ */
+
+template <typename T>
+T sum_lanes(typename pack<T>::type p) {
+    T lanes[pack<T>::width];
+    pack<T>::store(lanes, p);
+    T result = lanes[0];
+    for (size_t k = 1; k < pack<T>::width; k++) {
+        result += lanes[k];
+    }
+    return result;
+}
+
+/* Two accumulators, so an addition doesn't wait for the previous one. */
+template <typename T>
+T sum(const T* x, size_t n) {
+    typedef pack<T> P;
+    const size_t w = P::width;
+    typename P::type s0 = P::zero();
+    typename P::type s1 = P::zero();
+
+    size_t i = 0;
+    for (; i + 2 * w <= n; i += 2 * w) {
+        s0 = P::add(s0, P::load(x + i));
+        s1 = P::add(s1, P::load(x + i + w));
+    }
+    for (; i + w <= n; i += w) {
+        s0 = P::add(s0, P::load(x + i));
+    }
+
+    T result = sum_lanes<T>(P::add(s0, s1));
+    for (; i < n; i++) {
+        result += x[i];
+    }
+    return result;
+}
+
+template <typename T>
+T dot(const T* x, const T* y, size_t n) {
+    typedef pack<T> P;
+    const size_t w = P::width;
+    typename P::type s0 = P::zero();
+    typename P::type s1 = P::zero();
+
+    size_t i = 0;
+    for (; i + 2 * w <= n; i += 2 * w) {
+        s0 = P::add(s0, P::mul(P::load(x + i), P::load(y + i)));
+        s1 = P::add(s1, P::mul(P::load(x + i + w), P::load(y + i + w)));
+    }
+    for (; i + w <= n; i += w) {
+        s0 = P::add(s0, P::mul(P::load(x + i), P::load(y + i)));
+    }
+
+    T result = sum_lanes<T>(P::add(s0, s1));
+    for (; i < n; i++) {
+        result += x[i] * y[i];
+    }
+    return result;
+}
+
+/* The smallest (or greatest) of the `n` values of `x`, `n` not being 0. */
+template <typename T, bool is_min>
+T extremum(const T* x, size_t n) {
+    typedef pack<T> P;
+    const size_t w = P::width;
+    T result = x[0];
+
+    size_t i = 0;
+    if (n >= w) {
+        typename P::type m = P::load(x);
+        for (i = w; i + w <= n; i += w) {
+            m = is_min ? P::min(m, P::load(x + i)) : P::max(m, P::load(x + i));
+        }
+
+        T lanes[P::width];
+        P::store(lanes, m);
+        for (size_t k = 0; k < w; k++) {
+            if (is_min ? lanes[k] < result : result < lanes[k]) {
+                result = lanes[k];
+            }
+        }
+    }
+    for (; i < n; i++) {
+        if (is_min ? x[i] < result : result < x[i]) {
+            result = x[i];
+        }
+    }
+    return result;
+}
+
+template <typename T>
+T min(const T* x, size_t n) {
+    return extremum<T, true>(x, n);
+}
+
+template <typename T>
+T max(const T* x, size_t n) {
+    return extremum<T, false>(x, n);
+}
+
+/* y = y + a * x */
+template <typename T>
+void axpy(T a, const T* x, T* y, size_t n) {
+    typedef pack<T> P;
+    const size_t w = P::width;
+    const typename P::type pa = P::set1(a);
+
+    size_t i = 0;
+    for (; i + w <= n; i += w) {
+        P::store(y + i, P::add(P::load(y + i), P::mul(pa, P::load(x + i))));
+    }
+    for (; i < n; i++) {
+        y[i] += a * x[i];
+    }
+}
+
+/* y = a * y */
+template <typename T>
+void scale(T a, T* y, size_t n) {
+    typedef pack<T> P;
+    const size_t w = P::width;
+    const typename P::type pa = P::set1(a);
+
+    size_t i = 0;
+    for (; i + w <= n; i += w) {
+        P::store(y + i, P::mul(pa, P::load(y + i)));
+    }
+    for (; i < n; i++) {
+        y[i] = a * y[i];
+    }
+}
+
+/* y = y + x, element-wise */
+template <typename T>
+void add(const T* x, T* y, size_t n) {
+    typedef pack<T> P;
+    const size_t w = P::width;
+
+    size_t i = 0;
+    for (; i + w <= n; i += w) {
+        P::store(y + i, P::add(P::load(y + i), P::load(x + i)));
+    }
+    for (; i < n; i++) {
+        y[i] += x[i];
+    }
+}
+
+/* y = y * x, element-wise */
+template <typename T>
+void mul(const T* x, T* y, size_t n) {
+    typedef pack<T> P;
+    const size_t w = P::width;
+
+    size_t i = 0;
+    for (; i + w <= n; i += w) {
+        P::store(y + i, P::mul(P::load(y + i), P::load(x + i)));
+    }
+    for (; i < n; i++) {
+        y[i] *= x[i];
+    }
+}
@@ -0,0 +1,232 @@
+#ifndef _ez_simd_hpp_
+#define _ez_simd_hpp_
+
+#include <cstddef>
+
+/* The SIMD kernels are built with GCC target pragmas, so that programs not
+ * built for a given instruction set can still use it when the processor
+ * running them has it. */
+#if (defined(__x86_64__) || defined(__i386__)) \
+ && defined(__GNUC__) && !defined(__clang__)
+#define EZ_SIMD_X86
+#include <immintrin.h>
+#endif
+
+#define EZ_SIMD_INLINE static inline __attribute__((always_inline))
+
+namespace ez {
+
+/* The numeric operations of the vectors of reals and integers.
+ *
+ * Their kernels (simd-kernels.hpp) are built for AVX2, for SSE4.1 and
+ * without SIMD instructions, the first one the processor has being chosen
+ * when the program runs. The kernels of other types are the scalar ones.
+ *
+ * The element-wise operations give the same results as a loop. Sums and dot
+ * products add their values in another order, so with reals they may
+ * differ in the last bits.
+ */
+namespace simd {
+
+namespace scalar {
+
+template <typename T>
+struct pack {
+    typedef T type;
+    static const size_t width = 1;
+
+    EZ_SIMD_INLINE type load(const T* p) { return *p; }
+    EZ_SIMD_INLINE void store(T* p, type a) { *p = a; }
+    EZ_SIMD_INLINE type set1(T a) { return a; }
+    EZ_SIMD_INLINE type zero() { return T(); }
+    EZ_SIMD_INLINE type add(type a, type b) { return a + b; }
+    EZ_SIMD_INLINE type mul(type a, type b) { return a * b; }
+    EZ_SIMD_INLINE type min(type a, type b) { return a < b ? a : b; }
+    EZ_SIMD_INLINE type max(type a, type b) { return b < a ? a : b; }
+};
+
+#include "simd-kernels.hpp"
+
+}
+
+#ifdef EZ_SIMD_X86
+
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+
+namespace sse41 {
+
+template <typename T>
+struct pack : scalar::pack<T> {
+};
+
+template <>
+struct pack<double> {
+    typedef __m128d type;
+    static const size_t width = 2;
+
+    EZ_SIMD_INLINE type load(const double* p) { return _mm_loadu_pd(p); }
+    EZ_SIMD_INLINE void store(double* p, type a) { _mm_storeu_pd(p, a); }
+    EZ_SIMD_INLINE type set1(double a) { return _mm_set1_pd(a); }
+    EZ_SIMD_INLINE type zero() { return _mm_setzero_pd(); }
+    EZ_SIMD_INLINE type add(type a, type b) { return _mm_add_pd(a, b); }
+    EZ_SIMD_INLINE type mul(type a, type b) { return _mm_mul_pd(a, b); }
+    EZ_SIMD_INLINE type min(type a, type b) { return _mm_min_pd(a, b); }
+    EZ_SIMD_INLINE type max(type a, type b) { return _mm_max_pd(a, b); }
+};
+
+template <>
+struct pack<int> {
+    typedef __m128i type;
+    static const size_t width = 4;
+
+    EZ_SIMD_INLINE type load(const int* p) {
+        return _mm_loadu_si128((const __m128i*)p);
+    }
+    EZ_SIMD_INLINE void store(int* p, type a) {
+        _mm_storeu_si128((__m128i*)p, a);
+    }
+    EZ_SIMD_INLINE type set1(int a) { return _mm_set1_epi32(a); }
+    EZ_SIMD_INLINE type zero() { return _mm_setzero_si128(); }
+    EZ_SIMD_INLINE type add(type a, type b) { return _mm_add_epi32(a, b); }
+    EZ_SIMD_INLINE type mul(type a, type b) { return _mm_mullo_epi32(a, b); }
+    EZ_SIMD_INLINE type min(type a, type b) { return _mm_min_epi32(a, b); }
+    EZ_SIMD_INLINE type max(type a, type b) { return _mm_max_epi32(a, b); }
+};
+
+#include "simd-kernels.hpp"
+
+}
+
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+namespace avx2 {
+
+template <typename T>
+struct pack : scalar::pack<T> {
+};
+
+template <>
+struct pack<double> {
+    typedef __m256d type;
+    static const size_t width = 4;
+
+    EZ_SIMD_INLINE type load(const double* p) { return _mm256_loadu_pd(p); }
+    EZ_SIMD_INLINE void store(double* p, type a) { _mm256_storeu_pd(p, a); }
+    EZ_SIMD_INLINE type set1(double a) { return _mm256_set1_pd(a); }
+    EZ_SIMD_INLINE type zero() { return _mm256_setzero_pd(); }
+    EZ_SIMD_INLINE type add(type a, type b) { return _mm256_add_pd(a, b); }
+    EZ_SIMD_INLINE type mul(type a, type b) { return _mm256_mul_pd(a, b); }
+    EZ_SIMD_INLINE type min(type a, type b) { return _mm256_min_pd(a, b); }
+    EZ_SIMD_INLINE type max(type a, type b) { return _mm256_max_pd(a, b); }
+};
+
+template <>
+struct pack<int> {
+    typedef __m256i type;
+    static const size_t width = 8;
+
+    EZ_SIMD_INLINE type load(const int* p) {
+        return _mm256_loadu_si256((const __m256i*)p);
+    }
+    EZ_SIMD_INLINE void store(int* p, type a) {
+        _mm256_storeu_si256((__m256i*)p, a);
+    }
+    EZ_SIMD_INLINE type set1(int a) { return _mm256_set1_epi32(a); }
+    EZ_SIMD_INLINE type zero() { return _mm256_setzero_si256(); }
+    EZ_SIMD_INLINE type add(type a, type b) { return _mm256_add_epi32(a, b); }
+    EZ_SIMD_INLINE type mul(type a, type b) {
+        return _mm256_mullo_epi32(a, b);
+    }
+    EZ_SIMD_INLINE type min(type a, type b) { return _mm256_min_epi32(a, b); }
+    EZ_SIMD_INLINE type max(type a, type b) { return _mm256_max_epi32(a, b); }
+};
+
+#include "simd-kernels.hpp"
+
+}
+
+#pragma GCC pop_options
+
+#endif
+
+enum level {
+    LEVEL_SCALAR,
+    LEVEL_SSE41,
+    LEVEL_AVX2,
+};
+
+/* The best instruction set of the processor, checked once. */
+inline level best_level() {
+#ifdef EZ_SIMD_X86
+    static const level best = __builtin_cpu_supports("avx2") ? LEVEL_AVX2
+                            : __builtin_cpu_supports("sse4.1") ? LEVEL_SSE41
+                            : LEVEL_SCALAR;
+    return best;
+#else
+    return LEVEL_SCALAR;
+#endif
+}
+
+#ifdef EZ_SIMD_X86
+#define EZ_SIMD_DISPATCH(call)                 \
+    switch (best_level()) {                    \
+      case LEVEL_AVX2:   return avx2::call;    \
+      case LEVEL_SSE41:  return sse41::call;   \
+      default:           return scalar::call;  \
+    }
+#else
+#define EZ_SIMD_DISPATCH(call) return scalar::call;
+#endif
+
+template <typename T>
+T sum(const T* x, size_t n) {
+    EZ_SIMD_DISPATCH(sum(x, n))
+}
+
+template <typename T>
+T dot(const T* x, const T* y, size_t n) {
+    EZ_SIMD_DISPATCH(dot(x, y, n))
+}
+
+template <typename T>
+T min(const T* x, size_t n) {
+    EZ_SIMD_DISPATCH(min(x, n))
+}
+
+template <typename T>
+T max(const T* x, size_t n) {
+    EZ_SIMD_DISPATCH(max(x, n))
+}
+
+template <typename T>
+void axpy(T a, const T* x, T* y, size_t n) {
+    EZ_SIMD_DISPATCH(axpy(a, x, y, n))
+}
+
+template <typename T>
+void scale(T a, T* y, size_t n) {
+    EZ_SIMD_DISPATCH(scale(a, y, n))
+}
+
+template <typename T>
+void add(const T* x, T* y, size_t n) {
+    EZ_SIMD_DISPATCH(add(x, y, n))
+}
+
+template <typename T>
+void mul(const T* x, T* y, size_t n) {
+    EZ_SIMD_DISPATCH(mul(x, y, n))
+}
+
+#undef EZ_SIMD_DISPATCH
+#undef EZ_SIMD_INLINE
+
+}
+
+}
+
+#endif
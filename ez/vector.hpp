@@ -1,77 +1,289 @@
 #ifndef _ez_vector_hpp_
 #define _ez_vector_hpp_
 
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
 #include <vector>
-#include <functional>
+#include <utility>
+#include <ostream>
+#include "parallel.hpp"
+#include "simd.hpp"
 
 namespace ez {
 
+/* EZ vectors, a thin layer over std::vector: no virtual function, copies and
+ * moves are the std::vector ones.
+ *
+ * Defining EZ_BOUNDS_CHECK makes the accesses out of the vector exit the
+ * program with an error instead of being undefined.
+ */
 template <typename T>
-class vector : private std::vector<T> {
-  public:
-    vector() : std::vector<T>() {
+class vector {
+  private:
+    std::vector<T> _elements;
 
+    void check_index(unsigned int n) const {
+#ifdef EZ_BOUNDS_CHECK
+        if (n >= _elements.size()) {
+            fprintf(stderr, "vector index %u out of bounds (size %u)\n",
+                    n, size());
+            exit(EXIT_FAILURE);
+        }
+#else
+        (void)n;
+#endif
     }
 
-    virtual ~vector() {
+    void check_same_size(const vector<T>& other, const char* operation) const
+    {
+        if (other.size() != size()) {
+            fprintf(stderr, "%s on vectors of different sizes (%u and %u)\n",
+                    operation, size(), other.size());
+            exit(EXIT_FAILURE);
+        }
+    }
 
+    void check_not_empty(const char* operation) const {
+        if (_elements.empty()) {
+            fprintf(stderr, "%s of an empty vector\n", operation);
+            exit(EXIT_FAILURE);
+        }
     }
 
+  public:
     T& at(unsigned int n) {
-        return (*this)[n];
+        check_index(n);
+        return _elements[n];
     }
 
     const T& at(unsigned int n) const {
-        return (*this)[n];
+        check_index(n);
+        return _elements[n];
     }
 
     void push(const T& v) {
-        std::vector<T>::push_back(v);
+        _elements.push_back(v);
+    }
+
+    void push(T&& v) {
+        _elements.push_back(std::move(v));
     }
 
     void pop() {
-        std::vector<T>::pop_back();
+#ifdef EZ_BOUNDS_CHECK
+        if (_elements.empty()) {
+            fprintf(stderr, "pop on an empty vector\n");
+            exit(EXIT_FAILURE);
+        }
+#endif
+        _elements.pop_back();
     }
 
     void insert(unsigned int n, const T& v) {
-        std::vector<T>::insert(n, v);
+        if (n != size()) {
+            check_index(n);
+        }
+        _elements.insert(_elements.begin() + n, v);
+    }
+
+    void insert(unsigned int n, T&& v) {
+        if (n != size()) {
+            check_index(n);
+        }
+        _elements.insert(_elements.begin() + n, std::move(v));
     }
 
     void remove(unsigned int n) {
-        std::vector<T>::erase(std::vector<T>::begin() + n);
+        check_index(n);
+        _elements.erase(_elements.begin() + n);
     }
 
     unsigned int size() const {
-        return std::vector<T>::size();
+        return _elements.size();
     }
 
     void clear() {
-        std::vector<T>::clear();
+        _elements.clear();
+    }
+
+    /* The numeric operations, for vectors of reals and integers (see
+     * simd.hpp). The operations between two vectors need them to have the
+     * same size. */
+    T sum() const {
+        return simd::sum(_elements.data(), _elements.size());
+    }
+
+    T dot(const vector<T>& other) const {
+        check_same_size(other, "dot");
+        return simd::dot(_elements.data(), other._elements.data(),
+                         _elements.size());
+    }
+
+    T min() const {
+        check_not_empty("min");
+        return simd::min(_elements.data(), _elements.size());
+    }
+
+    T max() const {
+        check_not_empty("max");
+        return simd::max(_elements.data(), _elements.size());
+    }
+
+    /* Adds `a` times `x` to this vector. */
+    void axpy(const T& a, const vector<T>& x) {
+        check_same_size(x, "axpy");
+        simd::axpy(a, x._elements.data(), _elements.data(), _elements.size());
+    }
+
+    void scale(const T& a) {
+        simd::scale(a, _elements.data(), _elements.size());
+    }
+
+    void add(const vector<T>& x) {
+        check_same_size(x, "add");
+        simd::add(x._elements.data(), _elements.data(), _elements.size());
     }
 
-    void map(const std::function<void(T&)>& func) {
-        for (int i = 0; i < size(); i++) {
-            func(at(i));
+    void mul(const vector<T>& x) {
+        check_same_size(x, "mul");
+        simd::mul(x._elements.data(), _elements.data(), _elements.size());
+    }
+
+    /* The functional operations are templates over the called function, so
+     * the lambdas given to them can be inlined. */
+    template <typename F>
+    void map(const F& func) {
+        for (T& element : _elements) {
+            func(element);
         }
     }
 
-    T reduce(const std::function<const T&(const T&, const T&)>& func,
-             const T& initial_value) const
-    {
+    template <typename F>
+    T reduce(const F& func, const T& initial_value) const {
         T current = initial_value;
-        for (unsigned int i = 0; i < size(); i++) {
-            current = func(at(i), current);
+        for (const T& element : _elements) {
+            current = func(element, current);
         }
         return current;
     }
 
-    void filter(const std::function<bool(const T&)>& func) {
-        for (unsigned int i = 0; i < size(); i++) {
-            if (func(at(i))) {
-                remove(i);
-                i--;
+    /* Remove the elements matching `func`, keeping the order of the other
+     * ones, in a single pass. */
+    template <typename F>
+    void filter(const F& func) {
+        _elements.erase(std::remove_if(_elements.begin(), _elements.end(),
+                                       func),
+                        _elements.end());
+    }
+
+    /* Copy the elements that `filter` would keep into `dest`. `dest` keeps
+     * its storage, so it isn't reallocated when it is reused. Into the
+     * vector itself, it is `filter`. */
+    template <typename F>
+    void filter_into(vector<T>& dest, const F& func) const {
+        if (&dest == this) {
+            dest.filter(func);
+            return;
+        }
+
+        dest.clear();
+        for (const T& element : _elements) {
+            if (!func(element)) {
+                dest.push(element);
+            }
+        }
+    }
+
+    /* Like `filter`, but the removed elements are moved into `dest`. Into
+     * the vector itself, the removed elements are moved back, so nothing
+     * changes. */
+    template <typename F>
+    void partition(vector<T>& dest, const F& func) {
+        if (&dest == this) {
+            return;
+        }
+
+        dest.clear();
+        size_t kept = 0;
+        for (size_t i = 0; i < _elements.size(); i++) {
+            if (func(_elements[i])) {
+                dest.push(std::move(_elements[i]));
+            } else {
+                if (kept != i) {
+                    _elements[kept] = std::move(_elements[i]);
+                }
+                kept++;
+            }
+        }
+        _elements.erase(_elements.begin() + kept, _elements.end());
+    }
+
+    /* The parallel operations split the vector in chunks spread over the
+     * thread pool. The function given to them runs concurrently on
+     * different elements, so it must not write anything else than the
+     * element it is given. */
+    template <typename F>
+    void parallel_map(const F& func) {
+        const size_t chunk = parallel_chunk_size<T>();
+        const size_t count = (_elements.size() + chunk - 1) / chunk;
+
+        thread_pool::instance().run(count, [&](size_t c) {
+            const size_t end = std::min(_elements.size(), (c + 1) * chunk);
+            for (size_t i = c * chunk; i < end; i++) {
+                func(_elements[i]);
+            }
+        });
+    }
+
+    /* Chunks are reduced separately from `identity`, then their results
+     * are reduced in order: `func` must be associative, and `identity` its
+     * identity element, for the result to be the `reduce` one. */
+    template <typename F>
+    T parallel_reduce(const F& func, const T& identity) const {
+        const size_t chunk = parallel_chunk_size<T>();
+        const size_t count = (_elements.size() + chunk - 1) / chunk;
+        std::vector<T> results(count, identity);
+
+        thread_pool::instance().run(count, [&](size_t c) {
+            const size_t end = std::min(_elements.size(), (c + 1) * chunk);
+            T current = identity;
+            for (size_t i = c * chunk; i < end; i++) {
+                current = func(_elements[i], current);
             }
+            results[c] = std::move(current);
+        });
+
+        T current = identity;
+        for (const T& result : results) {
+            current = func(result, current);
         }
+        return current;
+    }
+
+    /* Each chunk is filtered in place, then the kept elements are moved
+     * together in order. */
+    template <typename F>
+    void parallel_filter(const F& func) {
+        const size_t chunk = parallel_chunk_size<T>();
+        const size_t count = (_elements.size() + chunk - 1) / chunk;
+        std::vector<size_t> ends(count);
+
+        thread_pool::instance().run(count, [&](size_t c) {
+            const size_t end = std::min(_elements.size(), (c + 1) * chunk);
+            ends[c] = std::remove_if(_elements.begin() + c * chunk,
+                                     _elements.begin() + end, func)
+                    - _elements.begin();
+        });
+
+        size_t kept = count > 0 ? ends[0] : 0;
+        for (size_t c = 1; c < count; c++) {
+            kept = std::move(_elements.begin() + c * chunk,
+                             _elements.begin() + ends[c],
+                             _elements.begin() + kept)
+                 - _elements.begin();
+        }
+        _elements.erase(_elements.begin() + kept, _elements.end());
     }
 };
 
@@ -91,4 +303,3 @@ std::ostream& operator<<(std::ostream& os, const vector<T>& v) {
 }
 
 #endif
-
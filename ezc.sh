@@ -1,7 +1,12 @@
 #!/bin/bash
 
 help() {
-    echo "ezc.sh [ez source file] [cpp source file] [executable]"
+    echo "ezc.sh [-p profile] [ez source file] [cpp source file] [executable]"
+    echo "profiles are:"
+    echo "  debug           no optimization, debug informations, vector bounds"
+    echo "                  checks (the default)"
+    echo "  release         -O2, link time optimization"
+    echo "  release-native  -O3 for the building machine, link time optimization"
     exit 1
 }
 
@@ -19,6 +24,27 @@ check_have_ezc() {
     fi
 }
 
+profile=debug
+while getopts "p:h" opt; do
+    case $opt in
+        p) profile=$OPTARG ;;
+        *) help ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+# The generated program is a single translation unit with a header-only
+# runtime, so it is already a unity build.
+case $profile in
+    debug)          cxxflags="-O0 -g -DEZ_BOUNDS_CHECK" ;;
+    release)        cxxflags="-O2 -flto -DNDEBUG" ;;
+    release-native) cxxflags="-O3 -march=native -flto -DNDEBUG" ;;
+    *)
+        echo "Unknown profile $profile"
+        help
+        ;;
+esac
+
 if [ $# -lt 2 ]; then
     help
 fi
@@ -30,11 +56,20 @@ exe=$3
 check_ez_source_exist $ez_source
 check_have_ezc
 
-./ezc $ez_source > $cpp_source
+# The checked program is cached as an EZ object next to its source, and
+# reused as long as neither the source nor the compiler changed.
+ez_object="${ez_source%.ez}.ezo"
+if [ -f "$ez_object" ] && [ "$ez_object" -nt "$ez_source" ] \
+                      && [ "$ez_object" -nt "ezc" ] \
+                      && [ "$ez_object" -nt "ez-builtins.ez" ]; then
+    ./ezc $ez_object > $cpp_source
+else
+    ./ezc -c $ez_object $ez_source > $cpp_source
+fi
 if [ ! $? -eq 0 ]; then
     echo "Compilation failure"
     exit 1
 fi
 
-g++ -Wall -std=c++11 $cpp_source -o $exe
+g++ -Wall -std=c++11 -pthread $cxxflags $cpp_source -o $exe
 
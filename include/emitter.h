@@ -0,0 +1,69 @@
+#ifndef _emitter_h_
+#define _emitter_h_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+/**
+ * An emitter is a growable character buffer used to generate code. Text is
+ * appended in memory and written out at once with `emitter_flush`.
+ *
+ * The emitter tracks an indentation level: every line started while the level
+ * is `n` is prefixed with `n * EMITTER_INDENT_WIDTH` spaces.
+ */
+#define EMITTER_INDENT_WIDTH    4
+
+typedef struct emitter {
+    size_t  reserved;
+    size_t  size;
+    char*   buffer;
+    int     indent;
+    bool    line_start;
+} emitter_t;
+
+void emitter_init(emitter_t* emitter, size_t reserved);
+
+void emitter_wipe(emitter_t* emitter);
+
+emitter_t* emitter_new(size_t reserved);
+
+void emitter_delete(emitter_t* emitter);
+
+void emitter_write(emitter_t* emitter, const char* s, size_t length);
+
+void emitter_puts(emitter_t* emitter, const char* s);
+
+void emitter_putc(emitter_t* emitter, char c);
+
+void emitter_put_int(emitter_t* emitter, long value);
+
+void emitter_put_uint(emitter_t* emitter, unsigned long value);
+
+void emitter_printf(emitter_t* emitter, const char* format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+void emitter_indent(emitter_t* emitter);
+
+void emitter_dedent(emitter_t* emitter);
+
+/**
+ * Returns the emitted text. It is always NUL terminated, and stays valid until
+ * the next append to the emitter.
+ */
+const char* emitter_data(const emitter_t* emitter);
+
+size_t emitter_size(const emitter_t* emitter);
+
+/**
+ * Clear the emitter content (the indentation level is kept).
+ */
+void emitter_clear(emitter_t* emitter);
+
+/**
+ * Write the emitter content into `output` with a single call, then clear it.
+ * Returns false if the write failed.
+ */
+bool emitter_flush(emitter_t* emitter, FILE* output);
+
+#endif
@@ -5,6 +5,8 @@
 
 void error_print(FILE* input);
 
+void warning_print(FILE* input);
+
 void error_identifier_is_keyword(FILE* input, const identifier_t* id);
 
 void error_identifier_exists(FILE* input, const identifier_t* id);
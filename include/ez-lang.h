@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include "vector.h"
+#include "emitter.h"
 
 #define IDENTIFIER_SIZE             32
 
@@ -33,6 +34,7 @@ bool identifier_is_reserved(const identifier_t* id);
 
 typedef struct symbol symbol_t;
 typedef struct structure structure_t;
+typedef struct enumeration enumeration_t;
 typedef struct type type_t;
 typedef struct context context_t;
 typedef struct expression expression_t;
@@ -54,7 +56,7 @@ void parameters_add(parameters_t* params, expression_t* expr);
 
 void parameters_wipe(parameters_t* params);
 
-void parameters_print(FILE* output, const context_t* ctx,
+void parameters_print(emitter_t* output, const context_t* ctx,
                       const parameters_t* params);
 
 /**
@@ -70,12 +72,16 @@ void parameters_print(FILE* output, const context_t* ctx,
  *
  * If 'is_funccall' is true, then the valref is a function call with
  * 'parameters' as function arguments.
+ *
+ * If 'is_last_use' is true, the valref is a local variable which is not read
+ * after this point, so its value is moved instead of being copied.
  */
 typedef struct valref {
     identifier_t  identifier;
 
     bool         is_funccall;
     bool         is_builtin;
+    bool         is_last_use;
     parameters_t parameters;
 
     struct valref* next;
@@ -85,7 +91,7 @@ valref_t* valref_new(const identifier_t* identifier);
 
 void valref_delete(valref_t* valref);
 
-void valref_print(FILE* output, const context_t* ctx, const valref_t* value);
+void valref_print(emitter_t* output, const context_t* ctx, const valref_t* value);
 
 const type_t* valref_get_type(const context_t* ctx, const valref_t* valref);
 
@@ -119,6 +125,10 @@ typedef struct value {
         valref_t*    valref;
         type_t*      empty_type;
     };
+
+    /* A natural printed as a C++ unsigned literal: the optimizer propagates
+     * the natural constants, which are unsigned in the generated code. */
+    bool is_unsigned;
 } value_t;
 
 void value_wipe(value_t* value);
@@ -131,7 +141,7 @@ void valref_set_is_funccall(valref_t* v, bool is_funccall);
 void valref_set_has_indexing(valref_t* v, bool has_indexing);
 void valref_add_index(valref_t* v, expression_t* index);
 
-void value_print(FILE* output, const context_t* ctx, const value_t* value);
+void value_print(emitter_t* output, const context_t* ctx, const value_t* value);
 
 /* ---------------------------- expressions --------------------------------- */
 
@@ -193,7 +203,12 @@ void expression_delete(expression_t* expr);
 
 int expression_predecence(const expression_t* expr);
 
-void expression_print(FILE* output, const context_t* ctx,
+/**
+ * The C++ operator of the expressions of kind `type`.
+ */
+const char* expression_type_symbol(expression_type_t type);
+
+void expression_print(emitter_t* output, const context_t* ctx,
                       const expression_t* expr);
 
 /* -------------------------- types & symbols ------------------------------ */
@@ -257,6 +272,28 @@ typedef enum {
      */
     TYPE_TYPE_FUNCTION,
 
+    /**
+     * Hash map type, associating values to keys.
+     * When a `type_t` has this type, it has a `key_type`, which is a
+     * primitive type or a string, and a `value_type`.
+     */
+    TYPE_TYPE_MAP,
+
+    /**
+     * Fixed-size array, stored inline in its variable or structure.
+     * When a `type_t` has this type, it has an `array_type`, the type of its
+     * elements, and an `array_size`, its number of elements known at compile
+     * time.
+     */
+    TYPE_TYPE_ARRAY,
+
+    /**
+     * Enumeration type.
+     * When a `type_t` has this type, it must have a valid `enumeration_type`
+     * child.
+     */
+    TYPE_TYPE_ENUMERATION,
+
     /* TODO TYPE_TYPE_REFERENCE (to have control on when puttin reference or
             not when using local or globals. */
 } type_type_t;
@@ -278,6 +315,19 @@ struct structure {
     vector_t members;   /* of symbol_t* */
 };
 
+/**
+ * An enumeration is a type whose values are its named `members`. They are
+ * numbered from 0 in declaration order, so the C++ enumeration generated for
+ * it is dense, and a `match` on it can be compiled to a jump table.
+ * Members are used in expressions by their bare identifier, `type` is the
+ * type of these expressions.
+ */
+struct enumeration {
+    identifier_t identifier;
+    vector_t members;   /* of identifier_t* */
+    type_t* type;
+};
+
 /**
  * The type data structure. Have a look to type_type_t enumeration for more
  * details.
@@ -286,9 +336,18 @@ struct type {
     type_type_t type;
     union {
         structure_t* structure_type;
+        enumeration_t* enumeration_type;
         type_t* vector_type;
         type_t* optional_type;
         function_signature_t* signature;
+        struct {
+            type_t* key_type;
+            type_t* value_type;
+        };
+        struct {
+            type_t* array_type;
+            unsigned int array_size;
+        };
     };
 };
 
@@ -304,8 +363,24 @@ type_t *type_vector_new(type_t *of);
 type_t* type_structure_new(structure_t* s);
 type_t* type_optional_new(type_t* of);
 type_t* type_function_new(function_signature_t* signature);
+type_t* type_map_new(type_t* key, type_t* value);
+type_t* type_array_new(type_t* of, unsigned int size);
+type_t* type_enumeration_new(enumeration_t* e);
+
+/**
+ * Returns true if `type` can be the key type of a map: a primitive type or a
+ * string.
+ */
+bool type_is_map_key(const type_t* type);
 
-void type_print(FILE* output, const context_t* ctx, const type_t* type);
+void type_print(emitter_t* output, const context_t* ctx, const type_t* type);
+
+/**
+ * Returns true if values of this type are cheap to copy (scalars and small
+ * builtin structures), so `in` arguments of this type are passed by value in
+ * the generated code instead of by const reference.
+ */
+bool type_is_passed_by_value(const context_t* ctx, const type_t* type);
 
 bool types_are_equals(const type_t* a, const type_t* b);
 
@@ -333,7 +408,7 @@ extern type_t* type_string;
 symbol_t *symbol_new(const identifier_t *identifier, type_t *is);
 void symbol_delete(symbol_t *symbol);
 
-void symbol_print(FILE* output, const context_t* ctx, const symbol_t* symbol);
+void symbol_print(emitter_t* output, const context_t* ctx, const symbol_t* symbol);
 
 bool symbol_is(const symbol_t* sym, const identifier_t* id);
 
@@ -345,11 +420,33 @@ bool structure_has_member(const structure_t* structure, const identifier_t* id);
 symbol_t* structure_find_member(const structure_t* structure,
                                 const identifier_t* id);
 
-void structure_print(FILE* output, const context_t* ctx,
+void structure_print(emitter_t* output, const context_t* ctx,
                      const structure_t* structure);
 
 bool structure_is(const structure_t* structure, const identifier_t* id);
 
+enumeration_t* enumeration_new(const identifier_t* identifier);
+void enumeration_delete(enumeration_t* enumeration);
+
+void enumeration_add_member(enumeration_t* enumeration,
+                            const identifier_t* member);
+
+/**
+ * Returns the index of the member `id` of `enumeration`, its value in the
+ * generated code, or -1 if it isn't one of its members.
+ */
+int enumeration_find_member(const enumeration_t* enumeration,
+                            const identifier_t* id);
+
+/**
+ * Print the C++ enumeration of `enumeration`, and the `ez::output` operator
+ * printing its members by name.
+ */
+void enumeration_print(emitter_t* output, const context_t* ctx,
+                       const enumeration_t* enumeration);
+
+bool enumeration_is(const enumeration_t* enumeration, const identifier_t* id);
+
 /* ---------------------------- instructions ------------------------------- */
 
 typedef struct instruction instruction_t;
@@ -369,7 +466,7 @@ elsif_instr_t* elsif_instr_new(expression_t* coundition);
 
 void elsif_instr_delete(elsif_instr_t* elsif);
 
-void elsif_instr_print(FILE* output, const context_t* ctx,
+void elsif_instr_print(emitter_t* output, const context_t* ctx,
                        const elsif_instr_t* elsif);
 
 /**
@@ -389,7 +486,7 @@ if_instr_t* if_instr_new(expression_t* coundition);
 
 void if_instr_delete(if_instr_t* if_instr);
 
-void if_instr_print(FILE* output, const context_t* ctx,
+void if_instr_print(emitter_t* output, const context_t* ctx,
                     const if_instr_t* if_instr);
 
 /**
@@ -406,7 +503,7 @@ loop_instr_t* loop_instr_new(expression_t* coundition);
 
 void loop_instr_delete(loop_instr_t* loop);
 
-void loop_instr_print(FILE* output, const context_t* ctx,
+void loop_instr_print(emitter_t* output, const context_t* ctx,
                       const loop_instr_t* loop_instr);
 
 /**
@@ -423,7 +520,7 @@ while_instr_t* while_instr_new(expression_t* coundition);
 
 void while_instr_delete(while_instr_t* while_instr);
 
-void while_instr_print(FILE* output, const context_t* ctx,
+void while_instr_print(emitter_t* output, const context_t* ctx,
                        const while_instr_t* while_instr);
 
 /**
@@ -439,7 +536,7 @@ on_instr_t* on_instr_new(expression_t* coundition);
 
 void on_instr_delete(on_instr_t* on_instr);
 
-void on_instr_print(FILE* output, const context_t* ctx,
+void on_instr_print(emitter_t* output, const context_t* ctx,
                     const on_instr_t* on_instr);
 
 typedef struct range {
@@ -450,12 +547,18 @@ typedef struct range {
 /**
  * The `for` instruction allows to iterates a variable `subject` on a given
  * range, and to execute `instructions` each iteration.
+ * A `parallel for` runs its iterations concurrently on the thread pool of
+ * the runtime (see parallel_for_is_valid).
  * TODO remove subject
  */
 typedef struct for_instr {
     identifier_t subject;
     range_t      range;
     vector_t     instructions;  /* of instruction_t */
+    bool         is_parallel;
+
+    /* Set by program_hoist_loop_bounds when `range.to` is loop invariant. */
+    bool         is_bound_invariant;
 } for_instr_t;
 
 for_instr_t* for_instr_new(const identifier_t* subject);
@@ -467,9 +570,97 @@ void range_set_to(range_t* range, expression_t* to);
 
 void for_instr_delete(for_instr_t* for_instr);
 
-void for_instr_print(FILE* output, const context_t* ctx,
+void for_instr_print(emitter_t* output, const context_t* ctx,
                      const for_instr_t* for_instr);
 
+/**
+ * Check that the iterations of the `parallel for` instruction `for_instr`
+ * of the function of `ctx` can run concurrently. The variables its body
+ * writes must be:
+ * - locals always assigned before being read in an iteration, which are
+ *   private to each iteration,
+ * - variables only updated by accumulations, like `x = x + e` (with `+`,
+ *   `*`, `and` or `or`), which are reductions,
+ * - vectors only written at the loop subject index, like `v[i] = e`.
+ * Variables given to calls as `inout` arguments are warned about. The body
+ * can't print, read or return.
+ * Errors and warnings are printed on the standard error, false is returned
+ * if there are errors.
+ */
+bool parallel_for_is_valid(FILE* input, const context_t* ctx,
+                           const for_instr_t* for_instr);
+
+/**
+ * A reduction of a `parallel for`: each chunk of the loop accumulates its
+ * own part of `variable` with `operator`, the parts are combined after the
+ * loop.
+ */
+typedef struct parallel_reduction {
+    const identifier_t* variable;
+    const type_t*       type;
+    expression_type_t   operator;
+} parallel_reduction_t;
+
+/**
+ * How the code of a valid `parallel for` shares its variables: the private
+ * locals, and the reductions. The other variables are shared.
+ */
+typedef struct parallel_plan {
+    vector_t    privates;   /* of const symbol_t* */
+    vector_t    reductions; /* of parallel_reduction_t* */
+} parallel_plan_t;
+
+void parallel_plan_init(parallel_plan_t* plan, const context_t* ctx,
+                        const for_instr_t* for_instr);
+
+void parallel_plan_wipe(parallel_plan_t* plan);
+
+/**
+ * A case of a `match` instruction: its `instructions` are executed when the
+ * subject of the `match` has one of the `values`, which are literals or
+ * enumeration members.
+ */
+typedef struct match_case {
+    vector_t values;        /* of expression_t* */
+    vector_t instructions;  /* of instruction_t* */
+} match_case_t;
+
+match_case_t* match_case_new(void);
+
+void match_case_delete(match_case_t* match_case);
+
+/**
+ * The `match` instruction executes the case having the value of `subject`,
+ * or `else_instrs` when there is no such case. The subject is an
+ * enumeration, an integer, a natural or a char, so the `match` is compiled
+ * to a C++ `switch`, that the C++ compiler can turn into a jump table.
+ */
+typedef struct match_instr {
+    expression_t* subject;
+    vector_t      cases;        /* of match_case_t* */
+    vector_t      else_instrs;  /* of instruction_t* */
+    bool          has_else;
+} match_instr_t;
+
+match_instr_t* match_instr_new(expression_t* subject);
+
+void match_instr_delete(match_instr_t* match_instr);
+
+void match_instr_print(emitter_t* output, const context_t* ctx,
+                       const match_instr_t* match_instr);
+
+/**
+ * Check the `match` instruction `match_instr` in the function of `ctx`: its
+ * subject must have a type it can match, its case values must be literals
+ * of this type (members for an enumeration) and appear in a single case.
+ * A `match` on an enumeration without `else` must have a case for each of
+ * its members.
+ * Errors are printed on the standard error, false is returned if there are
+ * errors.
+ */
+bool match_instr_is_valid(FILE* input, const context_t* ctx,
+                          const match_instr_t* match_instr);
+
 /**
  * Different kinds of flowcontrol instructions (see above for description of
  * these instructions).
@@ -480,6 +671,7 @@ typedef enum {
     FLOWCONTROL_TYPE_LOOP,
     FLOWCONTROL_TYPE_ON,
     FLOWCONTROL_TYPE_FOR,
+    FLOWCONTROL_TYPE_MATCH,
 } flowcontrol_type_t;
 
 /**
@@ -494,12 +686,13 @@ typedef struct flowcontrol {
         loop_instr_t*   loop_instr;
         on_instr_t*     on_instr;
         for_instr_t*    for_instr;
+        match_instr_t*  match_instr;
     };
 } flowcontrol_t;
 
 void flowcontrol_wipe(flowcontrol_t* fc);
 
-void flowcontrol_print(FILE* output, const context_t* ctx,
+void flowcontrol_print(emitter_t* output, const context_t* ctx,
                        const flowcontrol_t* fc_instr);
 
 /**
@@ -513,7 +706,7 @@ typedef struct affectation_instr {
 
 void affectation_instr_wipe(affectation_instr_t* affectation);
 
-void affectation_instr_print(FILE* output, const context_t* ctx,
+void affectation_instr_print(emitter_t* output, const context_t* ctx,
                              const affectation_instr_t* aff);
 
 /**
@@ -571,10 +764,10 @@ instruction_t* instruction_new(instruction_type_t type);
 
 void instruction_delete(instruction_t* instr);
 
-void instruction_print(FILE* output, const context_t* ctx,
+void instruction_print(emitter_t* output, const context_t* ctx,
                        const instruction_t* instr);
 
-void instructions_print(FILE* output, const context_t* ctx,
+void instructions_print(emitter_t* output, const context_t* ctx,
                         const vector_t* instrs);
 
 /* ------------------------------ functions -------------------------------- */
@@ -602,6 +795,14 @@ typedef enum {
 
 const char* access_type_print_ez(access_type_t at, char* buf);
 
+/**
+ * Print the C++ type used to pass an argument of type `type` with the
+ * `access` access type: `T` or `const T&` for `in` arguments, `T&` for `out`
+ * and `inout` ones.
+ */
+void type_print_argument(emitter_t* output, const context_t* ctx,
+                         const type_t* type, access_type_t access);
+
 /**
  * Function argument.
  */
@@ -615,7 +816,7 @@ function_arg_t* function_arg_new(access_type_t access_type,
 
 void function_arg_delete(function_arg_t* func_arg);
 
-void function_arg_print(FILE* output, const context_t* ctx,
+void function_arg_print(emitter_t* output, const context_t* ctx,
                         const function_arg_t* arg);
 
 /**
@@ -663,7 +864,7 @@ function_t* function_new(const identifier_t* id);
 
 void function_delete(function_t* function);
 
-void function_print(FILE* output, const context_t* ctx,
+void function_print(emitter_t* output, const context_t* ctx,
                     const function_t* function);
 
 void function_set_args(function_t* func, vector_t* args);
@@ -703,7 +904,7 @@ constant_t* constant_new(symbol_t* symbol, expression_t* value);
 
 void constant_delete(constant_t* constant);
 
-void constant_print(FILE* output, const context_t* ctx,
+void constant_print(emitter_t* output, const context_t* ctx,
                     const constant_t* constant);
 
 bool constant_is(const constant_t* constant, const identifier_t* id);
@@ -716,6 +917,7 @@ typedef struct program {
     vector_t    globals;    /* of symbol_t* */
     vector_t    constants;  /* of constant_t* */
     vector_t    structures; /* of structure_t* */
+    vector_t    enumerations; /* of enumeration_t* */
     vector_t    functions;  /* of function_t* */
     vector_t    procedures; /* of function_t* */
 
@@ -728,7 +930,22 @@ program_t* program_new(const identifier_t* id);
 
 void program_delete(program_t* prg);
 
-void program_print(FILE* output, const program_t* prg);
+/**
+ * Code generation options.
+ * If 'template_lambdas' is true, the functions and procedures taking `in`
+ * function arguments are generated as templates over these arguments, so
+ * the lambdas given to them can be inlined instead of being called through
+ * a std::function.
+ */
+typedef struct codegen_options {
+    bool    template_lambdas;
+} codegen_options_t;
+
+/**
+ * Print the C++ code of `prg`, `options` may be NULL for the default ones.
+ */
+void program_print(emitter_t* output, const program_t* prg,
+                   const codegen_options_t* options);
 
 void program_add_global(program_t* prg, symbol_t* global);
 bool program_has_global(const program_t* prg, const identifier_t* id);
@@ -743,6 +960,17 @@ bool program_has_structure(const program_t* prg, const identifier_t* id);
 structure_t* program_find_structure(const program_t* prg,
                                     const identifier_t* id);
 
+void program_add_enumeration(program_t* prg, enumeration_t* enumeration);
+bool program_has_enumeration(const program_t* prg, const identifier_t* id);
+enumeration_t* program_find_enumeration(const program_t* prg,
+                                        const identifier_t* id);
+
+/**
+ * Returns the enumeration having `id` as a member, or NULL.
+ */
+enumeration_t* program_find_enumeration_member(const program_t* prg,
+                                               const identifier_t* id);
+
 void program_add_function(program_t* prg, function_t* function);
 bool program_has_function(const program_t* prg, const identifier_t* id);
 function_t* program_find_function(program_t* prg, const identifier_t* id);
@@ -773,6 +1001,7 @@ bool program_main_function_is_valid(const program_t* prg);
 struct context {
     program_t* program;
     function_t* function;
+    const codegen_options_t* options;
 
     bool error_prg;
 };
@@ -786,6 +1015,9 @@ bool context_has_function(const context_t* ctx, const identifier_t* id);
 structure_t* context_find_structure(const context_t* ctx,
                                     const identifier_t* structure_id);
 
+enumeration_t* context_find_enumeration(const context_t* ctx,
+                                        const identifier_t* enumeration_id);
+
 identifier_t context_get_program_identifier(context_t* ctx);
 
 const type_t* context_value_get_type(const context_t* ctx, const value_t* value);
@@ -825,6 +1057,55 @@ access_type_t context_valref_get_access_type(const context_t* ctx,
 function_signature_t* context_find_lambda_function(const context_t* ctx,
                                                    const identifier_t* id);
 
+/* ---------------------------- optimizations ------------------------------ */
+
+/**
+ * Simplify a checked program before code generation:
+ * - literal arithmetic, comparisons and boolean logic are folded,
+ * - `x + 0`, `x * 1`, `true and x`... are reduced to `x`,
+ * - constants with a literal value are replaced by this value,
+ * - `if`, `elsif`, `on`, `while` and `loop` with a constant coundition are
+ *   replaced by the instructions they would execute.
+ * Literals are only folded when the result is the one the generated C++ code
+ * would compute.
+ */
+void program_optimize(program_t* prg);
+
+/**
+ * Evaluates `expr` if it is only made of literals and constants, folding it
+ * like program_optimize does. The evaluated value is put in `value`, which
+ * must then be wiped. Returns false if `expr` can't be evaluated.
+ */
+bool expression_evaluate(const context_t* ctx, const expression_t* expr,
+                         value_t* value);
+
+/**
+ * Remove the functions, procedures, constants, globals and structures that
+ * can't be reached from the program main function, so they are not
+ * generated.
+ */
+void program_remove_unreachable(program_t* prg);
+
+/**
+ * Returns true if the instructions `instrs` of `function` print or read,
+ * directly or through the functions, procedures and lambdas they call.
+ */
+bool instructions_reach_io(program_t* prg, const function_t* function,
+                           const vector_t* instrs);
+
+/**
+ * Mark the last uses of the function locals that are worth moving instead of
+ * being copied: a local affected to a variable, or given to a builtin method
+ * storing it (like the vector `push`), when it is not read afterward.
+ */
+void program_mark_last_uses(program_t* prg);
+
+/**
+ * Mark the `for` loops whose bound can't change while they run, so it is
+ * computed once before the loop instead of on each iteration.
+ */
+void program_hoist_loop_bounds(program_t* prg);
+
 /* ------------------------ Language builtins ------------------------------ */
 
 #define EZ_BUILTINS_FILE    "ez-builtins.ez"
@@ -835,6 +1116,14 @@ bool vector_function_call_is_valid(const context_t* ctx,
                                    const valref_t* valref,
                                    const type_t* vector_type);
 
+/**
+ * Returns false if the vector method call `valref`, a part of the valref
+ * `subject`, writes into the vector it is called on, like
+ * `v.filter_into(v, p)`.
+ */
+bool vector_function_destination_is_valid(const valref_t* subject,
+                                          const valref_t* valref);
+
 const type_t* vector_function_get_type(const valref_t* valref,
                                        const type_t* vector_type);
 
@@ -848,4 +1137,65 @@ bool optional_function_call_is_valid(const context_t* ctx,
 const type_t* optional_function_get_type(const valref_t* valref,
                                          const type_t* vector_type);
 
+
+bool map_function_exists(const identifier_t* id);
+
+bool map_function_call_is_valid(const context_t* ctx,
+                                const valref_t* valref,
+                                const type_t* map_type);
+
+const type_t* map_function_get_type(const valref_t* valref,
+                                    const type_t* map_type);
+
+
+bool array_function_exists(const identifier_t* id);
+
+bool array_function_call_is_valid(const context_t* ctx,
+                                  const valref_t* valref,
+                                  const type_t* array_type);
+
+/**
+ * Returns false if the array method call `valref` accesses an element at a
+ * constant index (see expression_evaluate) out of the array.
+ */
+bool array_function_index_is_valid(const context_t* ctx,
+                                   const valref_t* valref,
+                                   const type_t* array_type);
+
+const type_t* array_function_get_type(const valref_t* valref,
+                                      const type_t* array_type);
+
+/**
+ * Returns true if the builtin method `method` (like the vector `size`) doesn't
+ * modify its subject, and doesn't call any function.
+ */
+bool builtin_method_is_const(const identifier_t* method);
+
+/**
+ * Returns true if the builtin method `method` (like the vector `filter_into`)
+ * writes its parameter number `index`.
+ */
+bool builtin_method_writes_parameter(const identifier_t* method, int index);
+
+/**
+ * Returns true if the builtin method `method` (like the vector `push`) stores
+ * its parameter number `index`, which could then be moved into it.
+ */
+bool builtin_method_keeps_parameter(const identifier_t* method, int index);
+
+/**
+ * Returns true if the builtin method `method` (like the vector `push`) may
+ * modify its subject.
+ */
+bool builtin_method_writes_subject(const identifier_t* method);
+
+/**
+ * Returns true if the builtin method `method` (like the vector `clear`)
+ * replaces the whole value of its subject.
+ */
+bool builtin_method_clears_subject(const identifier_t* method);
+
+bool builtin_structure_is_passed_by_value(const context_t* ctx,
+                                          const structure_t* structure);
+
 #endif
@@ -0,0 +1,49 @@
+/* Module       : ez-object
+ * Description  : Binary serialization of validated EZ programs
+ * Copyright    : (c) Timothée Napoli, Kevin Hivert, 2016
+ * License      : WTFPL
+ * Maintainer   : meg@caca.paris
+ * Stability    : burn with it or don't try.
+ * Portability  : POSIX
+ *
+ * An EZ object (`.ezo`) file holds a whole `program_t` (builtins included)
+ * once it has been parsed and checked, so it can be reloaded without going
+ * through the parser again.
+ *
+ * The format is a magic string followed by a version number, then the
+ * program entities. Integers are written as LEB128 varints (zigzag encoded
+ * when signed), reals as little-endian IEEE 754 doubles, and strings as a
+ * varint length followed by their bytes. Enumerations and structures are
+ * referenced by their index in the program, so they are all declared before
+ * anything using them.
+ */
+#ifndef _ez_object_h_
+#define _ez_object_h_
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "ez-lang.h"
+
+#define EZ_OBJECT_MAGIC     "EZO\n"
+#define EZ_OBJECT_VERSION   5
+
+/**
+ * Returns true if `input` starts with the EZ object magic string. The stream
+ * offset of `input` is preserved.
+ */
+bool program_is_object(FILE* input);
+
+/**
+ * Write the program `prg` as an EZ object into `output`.
+ * Returns false if the object couldn't be written.
+ */
+bool program_write_object(FILE* output, const program_t* prg);
+
+/**
+ * Read back a program written by `program_write_object`.
+ * Returns NULL (and prints the reason on stderr) if `input` is not a valid
+ * EZ object or has been written by an incompatible ezc version.
+ */
+program_t* program_read_object(FILE* input);
+
+#endif
@@ -83,6 +83,9 @@ parser_status_t for_parser(FILE* input, context_t* ctx,
 parser_status_t loop_parser(FILE* input, context_t* ctx,
                             loop_instr_t** loop_instr);
 
+parser_status_t match_parser(FILE* input, context_t* ctx,
+                             match_instr_t** match_instr);
+
 parser_status_t flowcontrol_parser(FILE* input, context_t* ctx,
                                    flowcontrol_t* flowcontrol);
 
@@ -99,6 +102,10 @@ parser_status_t structure_parser(FILE* input,
                                  context_t* ctx,
                                  structure_t** structure);
 
+parser_status_t enumeration_parser(FILE* input,
+                                   context_t* ctx,
+                                   enumeration_t** enumeration);
+
 parser_status_t structure_member_parser(FILE* input,
                                         context_t* ctx,
                                         symbol_t** symbol);
@@ -12,6 +12,7 @@
 #define _cparser_parser_h_
 
 #include <stdio.h>
+#include <stdbool.h>
 
 /* Enumeration for parser function return code. */
 typedef enum {
@@ -20,6 +21,15 @@ typedef enum {
     PARSER_FATAL,
 } parser_status_t;
 
+/* A slice is a (offset, length) view on the input stream of a parser. It lets
+ * parsers remember where a token is without copying its characters, the
+ * token being copied only once when it is materialized with `slice_copy`.
+ */
+typedef struct parser_slice {
+    long   offset;
+    size_t length;
+} parser_slice_t;
+
 /* A parser is a simple function that, taking as input a FILE* will read a
  * sequence of chars. It returns the number of chars read. */
 typedef parser_status_t (*parser_func_t)(FILE*, const void*, void*, int*);
@@ -50,17 +60,23 @@ void get_file_coordinates(FILE* f, int* line, int* column, char* c);
     }
 
 /* Parse using a parser func. If the function failed, return PARSER_FATAL and
- * print the given error message.
+ * print the given error message. A fatal error of the function, already
+ * reported, is returned as is.
  */
 #define PARSE_ERR(_parser, _err_msg) \
-    if ((_parser) == PARSER_FAILURE) { \
-        int _line, _column; \
-        char _c; \
-        /* TODO input in PARSE_ERR args */ \
-        get_file_coordinates(input, &_line, &_column, &_c); \
-        fprintf(stderr, "error (line %d column %d at '%c'): " _err_msg "\n", \
-                _line, _column, _c); \
-        return PARSER_FATAL; \
+    { \
+        long _status = (_parser); \
+        if (_status == PARSER_FAILURE) { \
+            int _line, _column; \
+            char _c; \
+            /* TODO input in PARSE_ERR args */ \
+            get_file_coordinates(input, &_line, &_column, &_c); \
+            fprintf(stderr, "error (line %d column %d at '%c'): " \
+                            _err_msg "\n", _line, _column, _c); \
+            return PARSER_FATAL; \
+        } else if (_status == PARSER_FATAL) { \
+            return PARSER_FATAL; \
+        } \
     }
 
 #define PARSER_LANG_ERR(_fmt, ...) \
@@ -115,5 +131,28 @@ parser_status_t until_char_parser(FILE* input, const char* c, char** output);
 parser_status_t until_word_parser(FILE* input, const char* word,
                                   char** output);
 
+/* Same as `chars_parser`, but the accepted characters are recorded as a slice
+ * of `input` instead of being copied. */
+parser_status_t chars_slice_parser(FILE* input, const char* allowed,
+                                   parser_slice_t* slice);
+
+/* Same as `until_char_parser`, but the skipped characters are recorded as a
+ * slice of `input` instead of being copied. */
+parser_status_t until_char_slice_parser(FILE* input, const char* c,
+                                        parser_slice_t* slice);
+
+/* Extend `slice` so it ends at the current offset of `input`. */
+void slice_extend(FILE* input, parser_slice_t* slice);
+
+/* Copy the characters of `slice` into `output` (of `size` bytes, including
+ * the final '\0'). The stream offset of `input` is preserved.
+ * Returns false if the slice doesn't fit in `output`.
+ */
+bool slice_copy(FILE* input, const parser_slice_t* slice,
+                char* output, size_t size);
+
+/* Allocate a string holding the characters of `slice`. */
+char* slice_dup(FILE* input, const parser_slice_t* slice);
+
 
 #endif
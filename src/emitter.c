@@ -0,0 +1,179 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include "emitter.h"
+
+void emitter_init(emitter_t* emitter, size_t reserved) {
+    emitter->reserved   = (reserved > 0) ? reserved : 1;
+    emitter->size       = 0;
+    emitter->indent     = 0;
+    emitter->line_start = true;
+    emitter->buffer     = malloc(emitter->reserved);
+    if (!emitter->buffer) {
+        fprintf(stderr, "couldn't allocate emitter buffer\n");
+        abort();
+    }
+    emitter->buffer[0] = '\0';
+}
+
+void emitter_wipe(emitter_t* emitter) {
+    free(emitter->buffer);
+}
+
+emitter_t* emitter_new(size_t reserved) {
+    emitter_t* emitter = malloc(sizeof(emitter_t));
+    if (!emitter) {
+        fprintf(stderr, "couldn't allocate emitter\n");
+        return NULL;
+    }
+    emitter_init(emitter, reserved);
+    return emitter;
+}
+
+void emitter_delete(emitter_t* emitter) {
+    if (emitter) {
+        emitter_wipe(emitter);
+        free(emitter);
+    }
+}
+
+/* Make room for `length` more characters plus the final NUL. */
+static void emitter_reserve(emitter_t* emitter, size_t length) {
+    size_t needed = emitter->size + length + 1;
+    if (needed <= emitter->reserved) {
+        return;
+    }
+
+    size_t reserved = emitter->reserved;
+    while (reserved < needed) {
+        reserved *= 2;
+    }
+
+    char* buffer = realloc(emitter->buffer, reserved);
+    if (!buffer) {
+        fprintf(stderr, "couldn't grow emitter buffer\n");
+        abort();
+    }
+    emitter->buffer   = buffer;
+    emitter->reserved = reserved;
+}
+
+static void emitter_raw(emitter_t* emitter, const char* s, size_t length) {
+    emitter_reserve(emitter, length);
+    memcpy(emitter->buffer + emitter->size, s, length);
+    emitter->size += length;
+    emitter->buffer[emitter->size] = '\0';
+}
+
+static void emitter_pad(emitter_t* emitter) {
+    size_t width = emitter->indent * EMITTER_INDENT_WIDTH;
+    emitter_reserve(emitter, width);
+    memset(emitter->buffer + emitter->size, ' ', width);
+    emitter->size += width;
+    emitter->buffer[emitter->size] = '\0';
+    emitter->line_start = false;
+}
+
+void emitter_write(emitter_t* emitter, const char* s, size_t length) {
+    while (length > 0) {
+        const char* eol = memchr(s, '\n', length);
+        size_t line_length = eol ? (size_t)(eol - s) + 1 : length;
+
+        if (emitter->line_start && emitter->indent > 0 && *s != '\n') {
+            emitter_pad(emitter);
+        }
+        emitter_raw(emitter, s, line_length);
+        emitter->line_start = (eol != NULL);
+
+        s += line_length;
+        length -= line_length;
+    }
+}
+
+void emitter_puts(emitter_t* emitter, const char* s) {
+    emitter_write(emitter, s, strlen(s));
+}
+
+void emitter_putc(emitter_t* emitter, char c) {
+    emitter_write(emitter, &c, 1);
+}
+
+void emitter_put_uint(emitter_t* emitter, unsigned long value) {
+    char digits[24];
+    size_t i = sizeof(digits);
+
+    do {
+        digits[--i] = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+
+    emitter_write(emitter, digits + i, sizeof(digits) - i);
+}
+
+void emitter_put_int(emitter_t* emitter, long value) {
+    if (value < 0) {
+        emitter_putc(emitter, '-');
+        emitter_put_uint(emitter, -(unsigned long)value);
+    } else {
+        emitter_put_uint(emitter, value);
+    }
+}
+
+void emitter_printf(emitter_t* emitter, const char* format, ...) {
+    char small[128];
+    va_list args;
+
+    va_start(args, format);
+    int length = vsnprintf(small, sizeof(small), format, args);
+    va_end(args);
+    if (length < 0) {
+        return;
+    }
+
+    if (length < sizeof(small)) {
+        emitter_write(emitter, small, length);
+        return;
+    }
+
+    char* large = malloc(length + 1);
+    if (!large) {
+        fprintf(stderr, "couldn't allocate emitter format buffer\n");
+        abort();
+    }
+    va_start(args, format);
+    vsnprintf(large, length + 1, format, args);
+    va_end(args);
+    emitter_write(emitter, large, length);
+    free(large);
+}
+
+void emitter_indent(emitter_t* emitter) {
+    emitter->indent++;
+}
+
+void emitter_dedent(emitter_t* emitter) {
+    if (emitter->indent > 0) {
+        emitter->indent--;
+    }
+}
+
+const char* emitter_data(const emitter_t* emitter) {
+    return emitter->buffer;
+}
+
+size_t emitter_size(const emitter_t* emitter) {
+    return emitter->size;
+}
+
+void emitter_clear(emitter_t* emitter) {
+    emitter->size       = 0;
+    emitter->line_start = true;
+    emitter->buffer[0]  = '\0';
+}
+
+bool emitter_flush(emitter_t* emitter, FILE* output) {
+    bool written = fwrite(emitter->buffer, 1, emitter->size, output)
+                == emitter->size;
+    emitter_clear(emitter);
+    return written;
+}
@@ -13,20 +13,46 @@ enum {
     VECTOR_FUNC_MAP,
     VECTOR_FUNC_REDUCE,
     VECTOR_FUNC_FILTER,
+    VECTOR_FUNC_FILTER_INTO,
+    VECTOR_FUNC_PARTITION,
+    VECTOR_FUNC_PARALLEL_MAP,
+    VECTOR_FUNC_PARALLEL_REDUCE,
+    VECTOR_FUNC_PARALLEL_FILTER,
+    VECTOR_FUNC_SUM,
+    VECTOR_FUNC_DOT,
+    VECTOR_FUNC_MIN,
+    VECTOR_FUNC_MAX,
+    VECTOR_FUNC_AXPY,
+    VECTOR_FUNC_SCALE,
+    VECTOR_FUNC_ADD,
+    VECTOR_FUNC_MUL,
     VECTOR_FUNC_NFUNCTIONS,
 };
 
 static const char* vector_functions[VECTOR_FUNC_NFUNCTIONS] = {
-    [VECTOR_FUNC_PUSH]   = "push",
-    [VECTOR_FUNC_INSERT] = "insert",
-    [VECTOR_FUNC_REMOVE] = "remove",
-    [VECTOR_FUNC_POP]    = "pop",
-    [VECTOR_FUNC_CLEAR]  = "clear",
-    [VECTOR_FUNC_SIZE]   = "size",
-    [VECTOR_FUNC_AT]     = "at",
-    [VECTOR_FUNC_MAP]    = "map",
-    [VECTOR_FUNC_REDUCE] = "reduce",
-    [VECTOR_FUNC_FILTER] = "filter",
+    [VECTOR_FUNC_PUSH]            = "push",
+    [VECTOR_FUNC_INSERT]          = "insert",
+    [VECTOR_FUNC_REMOVE]          = "remove",
+    [VECTOR_FUNC_POP]             = "pop",
+    [VECTOR_FUNC_CLEAR]           = "clear",
+    [VECTOR_FUNC_SIZE]            = "size",
+    [VECTOR_FUNC_AT]              = "at",
+    [VECTOR_FUNC_MAP]             = "map",
+    [VECTOR_FUNC_REDUCE]          = "reduce",
+    [VECTOR_FUNC_FILTER]          = "filter",
+    [VECTOR_FUNC_FILTER_INTO]     = "filter_into",
+    [VECTOR_FUNC_PARTITION]       = "partition",
+    [VECTOR_FUNC_PARALLEL_MAP]    = "parallel_map",
+    [VECTOR_FUNC_PARALLEL_REDUCE] = "parallel_reduce",
+    [VECTOR_FUNC_PARALLEL_FILTER] = "parallel_filter",
+    [VECTOR_FUNC_SUM]             = "sum",
+    [VECTOR_FUNC_DOT]             = "dot",
+    [VECTOR_FUNC_MIN]             = "min",
+    [VECTOR_FUNC_MAX]             = "max",
+    [VECTOR_FUNC_AXPY]            = "axpy",
+    [VECTOR_FUNC_SCALE]           = "scale",
+    [VECTOR_FUNC_ADD]             = "add",
+    [VECTOR_FUNC_MUL]             = "mul",
 };
 
 static int vector_get_function(const identifier_t* func) {
@@ -42,6 +68,91 @@ bool vector_function_exists(const identifier_t* func) {
     return vector_get_function(func) >= 0;
 }
 
+/* A predicate given to the filtering functions. */
+static bool vector_predicate_is_valid(const context_t* ctx,
+                                      const expression_t* expr,
+                                      const type_t* vector_type)
+{
+    const type_t* arg_type = context_expression_get_type(ctx, expr);
+
+    if (arg_type->type != TYPE_TYPE_FUNCTION) {
+        return false;
+    }
+
+    const function_signature_t* signature = arg_type->signature;
+    if (!types_are_equals(signature->return_type, type_boolean)) {
+        return false;
+    }
+    if (signature->args_types.size != 1) {
+        return false;
+    }
+    if (!types_are_equals(vector_type->vector_type,
+                          signature->args_types.elements[0]))
+    {
+        return false;
+    }
+
+    access_type_t at = (access_type_t)signature->args_access.elements[0];
+    return at == ACCESS_TYPE_INPUT;
+}
+
+/* A vector variable written by the filtering functions: it can't be an
+ * `in` argument. */
+static bool vector_destination_is_valid(const context_t* ctx,
+                                        const expression_t* expr,
+                                        const type_t* vector_type)
+{
+    if (expr->type != EXPRESSION_TYPE_VALUE
+    ||  expr->value.type != VALUE_TYPE_VALREF
+    ||  expr->value.valref->is_funccall)
+    {
+        return false;
+    }
+
+    if (ctx->function) {
+        const function_arg_t* arg =
+            function_find_arg(ctx->function, &expr->value.valref->identifier);
+        if (arg && arg->access_type == ACCESS_TYPE_INPUT) {
+            return false;
+        }
+    }
+
+    return types_are_equals(context_expression_get_type(ctx, expr),
+                            vector_type);
+}
+
+/* The numeric functions are for vectors of reals and integers, which the
+ * runtime has SIMD kernels for. Their parameters are either numbers or
+ * vectors of the same type. */
+static bool vector_numeric_call_is_valid(const context_t* ctx,
+                                         const valref_t* valref,
+                                         const type_t* vector_type,
+                                         int nnumbers, int nvectors)
+{
+    const vector_t* params = &valref->parameters.parameters;
+    const type_t* element_type = vector_type->vector_type;
+
+    if (element_type->type != TYPE_TYPE_REAL
+    &&  element_type->type != TYPE_TYPE_INTEGER)
+    {
+        return false;
+    }
+    if (params->size != nnumbers + nvectors) {
+        return false;
+    }
+
+    for (int i = 0; i < params->size; i++) {
+        const type_t* arg_type =
+            context_expression_get_type(ctx, params->elements[i]);
+        if (i < nnumbers ? !type_is_number(arg_type)
+                         : !types_are_equals(arg_type, vector_type))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool vector_function_call_is_valid(const context_t* ctx,
                                    const valref_t* valref,
                                    const type_t* vector_type)
@@ -135,7 +246,8 @@ bool vector_function_call_is_valid(const context_t* ctx,
         break;
       }
 
-      case VECTOR_FUNC_MAP: {
+      case VECTOR_FUNC_MAP:
+      case VECTOR_FUNC_PARALLEL_MAP: {
         if (valref->parameters.parameters.size != 1) {
             return false;
         }
@@ -168,7 +280,8 @@ bool vector_function_call_is_valid(const context_t* ctx,
         break;
       }
 
-      case VECTOR_FUNC_REDUCE: {
+      case VECTOR_FUNC_REDUCE:
+      case VECTOR_FUNC_PARALLEL_REDUCE: {
         if (valref->parameters.parameters.size != 2) {
             return false;
         }
@@ -208,44 +321,82 @@ bool vector_function_call_is_valid(const context_t* ctx,
         break;
       }
 
-      case VECTOR_FUNC_FILTER: {
+      case VECTOR_FUNC_FILTER:
+      case VECTOR_FUNC_PARALLEL_FILTER: {
         if (valref->parameters.parameters.size != 1) {
             return false;
         }
-        const type_t* arg_type =
-            context_expression_get_type(ctx,
-                                valref->parameters.parameters.elements[0]);
-
-        if (arg_type->type != TYPE_TYPE_FUNCTION) {
+        if (!vector_predicate_is_valid(ctx,
+                                    valref->parameters.parameters.elements[0],
+                                    vector_type))
+        {
             return false;
         }
+        break;
+      }
 
-        const function_signature_t* signature = arg_type->signature;
-        if (!types_are_equals(signature->return_type, type_boolean)) {
-            return false;
-        }
-        if (signature->args_types.size != 1) {
+      case VECTOR_FUNC_FILTER_INTO:
+      case VECTOR_FUNC_PARTITION: {
+        if (valref->parameters.parameters.size != 2) {
             return false;
         }
-        if (!types_are_equals(vector_type->vector_type,
-                              signature->args_types.elements[0]))
+        if (!vector_destination_is_valid(ctx,
+                                    valref->parameters.parameters.elements[0],
+                                    vector_type)
+        ||  !vector_predicate_is_valid(ctx,
+                                    valref->parameters.parameters.elements[1],
+                                    vector_type))
         {
             return false;
         }
-
-        access_type_t at = (access_type_t)signature->args_access.elements[0];
-        if (at != ACCESS_TYPE_INPUT) {
-            return false;
-        }
-
         break;
       }
 
+      case VECTOR_FUNC_SUM:
+      case VECTOR_FUNC_MIN:
+      case VECTOR_FUNC_MAX:
+        return vector_numeric_call_is_valid(ctx, valref, vector_type, 0, 0);
+
+      case VECTOR_FUNC_DOT:
+      case VECTOR_FUNC_ADD:
+      case VECTOR_FUNC_MUL:
+        return vector_numeric_call_is_valid(ctx, valref, vector_type, 0, 1);
+
+      case VECTOR_FUNC_AXPY:
+        return vector_numeric_call_is_valid(ctx, valref, vector_type, 1, 1);
+
+      case VECTOR_FUNC_SCALE:
+        return vector_numeric_call_is_valid(ctx, valref, vector_type, 1, 0);
+
     }
 
     return true;
 }
 
+/* Only a destination written exactly like the vector is found here: the
+ * runtime handles the other ones, like an `inout` argument given twice. */
+bool vector_function_destination_is_valid(const valref_t* subject,
+                                          const valref_t* valref)
+{
+    int func = vector_get_function(&valref->identifier);
+    if (func != VECTOR_FUNC_FILTER_INTO && func != VECTOR_FUNC_PARTITION) {
+        return true;
+    }
+
+    const expression_t* dest = valref->parameters.parameters.elements[0];
+    const valref_t* d = dest->value.valref;
+    for (const valref_t* s = subject; s != valref; s = s->next) {
+        if (!d || s->is_funccall || d->is_funccall
+        ||  strcmp(s->identifier.value, d->identifier.value) != 0)
+        {
+            return true;
+        }
+        d = d->next;
+    }
+
+    return d != NULL;
+}
+
 const type_t* vector_function_get_type(const valref_t* valref,
                                        const type_t* vector_type)
 {
@@ -259,6 +410,11 @@ const type_t* vector_function_get_type(const valref_t* valref,
         return type_natural;
 
       case VECTOR_FUNC_REDUCE:
+      case VECTOR_FUNC_PARALLEL_REDUCE:
+      case VECTOR_FUNC_SUM:
+      case VECTOR_FUNC_DOT:
+      case VECTOR_FUNC_MIN:
+      case VECTOR_FUNC_MAX:
         return vector_type->vector_type;
 
       default:
@@ -359,3 +515,353 @@ const type_t* optional_function_get_type(const valref_t* valref,
     return NULL;
 }
 
+enum {
+    MAP_FUNC_PUT,
+    MAP_FUNC_GET,
+    MAP_FUNC_HAS,
+    MAP_FUNC_REMOVE,
+    MAP_FUNC_CLEAR,
+    MAP_FUNC_SIZE,
+    MAP_FUNC_KEY_AT,
+    MAP_FUNC_VALUE_AT,
+    MAP_FUNC_NFUNCTIONS,
+};
+
+static const char* map_functions[MAP_FUNC_NFUNCTIONS] = {
+    [MAP_FUNC_PUT]      = "put",
+    [MAP_FUNC_GET]      = "get",
+    [MAP_FUNC_HAS]      = "has",
+    [MAP_FUNC_REMOVE]   = "remove",
+    [MAP_FUNC_CLEAR]    = "clear",
+    [MAP_FUNC_SIZE]     = "size",
+    [MAP_FUNC_KEY_AT]   = "key_at",
+    [MAP_FUNC_VALUE_AT] = "value_at",
+};
+
+static int map_get_function(const identifier_t* func) {
+    for (int i = 0; i < MAP_FUNC_NFUNCTIONS; i++) {
+        if (strcmp(func->value, map_functions[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool map_function_exists(const identifier_t* func) {
+    return map_get_function(func) >= 0;
+}
+
+/* Checks that the parameters of a map method call have the given types, a
+ * NULL type being any number. */
+static bool map_parameters_are_valid(const context_t* ctx,
+                                     const valref_t* valref,
+                                     int nparameters,
+                                     const type_t* first,
+                                     const type_t* second)
+{
+    const vector_t* params = &valref->parameters.parameters;
+    const type_t* types[2] = {first, second};
+
+    if (params->size != nparameters) {
+        return false;
+    }
+
+    for (int i = 0; i < nparameters; i++) {
+        const type_t* arg_type =
+            context_expression_get_type(ctx, params->elements[i]);
+        if (types[i] ? !types_are_equivalent(arg_type, types[i])
+                     : !type_is_number(arg_type))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool map_function_call_is_valid(const context_t* ctx,
+                                const valref_t* valref,
+                                const type_t* map_type)
+{
+    assert (valref->is_funccall);
+    assert (map_function_exists(&valref->identifier));
+
+    switch (map_get_function(&valref->identifier)) {
+      case MAP_FUNC_PUT:
+        return map_parameters_are_valid(ctx, valref, 2, map_type->key_type,
+                                        map_type->value_type);
+
+      case MAP_FUNC_GET:
+      case MAP_FUNC_HAS:
+      case MAP_FUNC_REMOVE:
+        return map_parameters_are_valid(ctx, valref, 1, map_type->key_type,
+                                        NULL);
+
+      case MAP_FUNC_CLEAR:
+      case MAP_FUNC_SIZE:
+        return map_parameters_are_valid(ctx, valref, 0, NULL, NULL);
+
+      case MAP_FUNC_KEY_AT:
+      case MAP_FUNC_VALUE_AT:
+        return map_parameters_are_valid(ctx, valref, 1, NULL, NULL);
+    }
+
+    return false;
+}
+
+const type_t* map_function_get_type(const valref_t* valref,
+                                    const type_t* map_type)
+{
+    switch (map_get_function(&valref->identifier)) {
+      case MAP_FUNC_GET:
+      case MAP_FUNC_VALUE_AT:
+        return map_type->value_type;
+
+      case MAP_FUNC_KEY_AT:
+        return map_type->key_type;
+
+      case MAP_FUNC_HAS:
+        return type_boolean;
+
+      case MAP_FUNC_SIZE:
+        return type_natural;
+
+      default:
+        return NULL;
+    }
+}
+
+enum {
+    ARRAY_FUNC_AT,
+    ARRAY_FUNC_SIZE,
+    ARRAY_FUNC_NFUNCTIONS,
+};
+
+static const char* array_functions[ARRAY_FUNC_NFUNCTIONS] = {
+    [ARRAY_FUNC_AT]   = "at",
+    [ARRAY_FUNC_SIZE] = "size",
+};
+
+static int array_get_function(const identifier_t* func) {
+    for (int i = 0; i < ARRAY_FUNC_NFUNCTIONS; i++) {
+        if (strcmp(func->value, array_functions[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool array_function_exists(const identifier_t* func) {
+    return array_get_function(func) >= 0;
+}
+
+bool array_function_call_is_valid(const context_t* ctx,
+                                  const valref_t* valref,
+                                  const type_t* array_type)
+{
+    assert (valref->is_funccall);
+    assert (array_function_exists(&valref->identifier));
+
+    const vector_t* params = &valref->parameters.parameters;
+
+    switch (array_get_function(&valref->identifier)) {
+      case ARRAY_FUNC_AT:
+        return params->size == 1
+            && type_is_number(context_expression_get_type(ctx,
+                                                        params->elements[0]));
+
+      case ARRAY_FUNC_SIZE:
+        return params->size == 0;
+    }
+
+    return false;
+}
+
+/* Only constant indexes are checked, the other ones are checked by the
+ * runtime. */
+bool array_function_index_is_valid(const context_t* ctx,
+                                   const valref_t* valref,
+                                   const type_t* array_type)
+{
+    value_t index;
+    bool valid = true;
+
+    if (array_get_function(&valref->identifier) != ARRAY_FUNC_AT
+    ||  !expression_evaluate(ctx, valref->parameters.parameters.elements[0],
+                             &index))
+    {
+        return true;
+    }
+
+    switch (index.type) {
+      case VALUE_TYPE_NATURAL:
+        valid = index.natural < array_type->array_size;
+        break;
+
+      case VALUE_TYPE_INTEGER:
+        valid = index.integer >= 0
+             && (unsigned int)index.integer < array_type->array_size;
+        break;
+
+      default:
+        break;
+    }
+
+    value_wipe(&index);
+    return valid;
+}
+
+const type_t* array_function_get_type(const valref_t* valref,
+                                      const type_t* array_type)
+{
+    switch (array_get_function(&valref->identifier)) {
+      case ARRAY_FUNC_AT:
+        return array_type->array_type;
+
+      case ARRAY_FUNC_SIZE:
+        return type_natural;
+
+      default:
+        return NULL;
+    }
+}
+
+/* The builtin methods that neither modify their subject nor call a function
+ * given to them. */
+bool builtin_method_is_const(const identifier_t* method) {
+    switch (vector_get_function(method)) {
+      case VECTOR_FUNC_SIZE:
+      case VECTOR_FUNC_AT:
+      case VECTOR_FUNC_SUM:
+      case VECTOR_FUNC_DOT:
+      case VECTOR_FUNC_MIN:
+      case VECTOR_FUNC_MAX:
+        return true;
+
+      default:
+        break;
+    }
+
+    switch (map_get_function(method)) {
+      case MAP_FUNC_GET:
+      case MAP_FUNC_HAS:
+      case MAP_FUNC_SIZE:
+      case MAP_FUNC_KEY_AT:
+      case MAP_FUNC_VALUE_AT:
+        return true;
+
+      default:
+        break;
+    }
+
+    switch (optional_get_function(method)) {
+      case OPTIONAL_FUNC_IS_SET:
+      case OPTIONAL_FUNC_GET:
+        return true;
+
+      default:
+        return false;
+    }
+}
+
+/* The builtin methods writing one of their parameters. */
+bool builtin_method_writes_parameter(const identifier_t* method, int index) {
+    switch (vector_get_function(method)) {
+      case VECTOR_FUNC_FILTER_INTO:
+      case VECTOR_FUNC_PARTITION:
+        return index == 0;
+
+      default:
+        return false;
+    }
+}
+
+/* The builtin methods storing one of their parameters in their subject. */
+bool builtin_method_keeps_parameter(const identifier_t* method, int index) {
+    switch (vector_get_function(method)) {
+      case VECTOR_FUNC_PUSH:
+        return index == 0;
+
+      case VECTOR_FUNC_INSERT:
+        return index == 1;
+
+      default:
+        break;
+    }
+
+    if (map_get_function(method) == MAP_FUNC_PUT) {
+        return true;
+    }
+    return optional_get_function(method) == OPTIONAL_FUNC_SET && index == 0;
+}
+
+/* The builtin methods that may modify their subject. */
+bool builtin_method_writes_subject(const identifier_t* method) {
+    switch (vector_get_function(method)) {
+      case VECTOR_FUNC_SIZE:
+      case VECTOR_FUNC_AT:
+      case VECTOR_FUNC_REDUCE:
+      case VECTOR_FUNC_FILTER_INTO:
+      case VECTOR_FUNC_PARALLEL_REDUCE:
+      case VECTOR_FUNC_SUM:
+      case VECTOR_FUNC_DOT:
+      case VECTOR_FUNC_MIN:
+      case VECTOR_FUNC_MAX:
+        return false;
+
+      case -1:
+        break;
+
+      default:
+        return true;
+    }
+
+    switch (map_get_function(method)) {
+      case MAP_FUNC_GET:
+      case MAP_FUNC_HAS:
+      case MAP_FUNC_SIZE:
+      case MAP_FUNC_KEY_AT:
+      case MAP_FUNC_VALUE_AT:
+        return false;
+
+      case -1:
+        break;
+
+      default:
+        return true;
+    }
+
+    return optional_get_function(method) == OPTIONAL_FUNC_SET;
+}
+
+/* The builtin methods replacing the whole value of their subject. */
+bool builtin_method_clears_subject(const identifier_t* method) {
+    return vector_get_function(method) == VECTOR_FUNC_CLEAR
+        || map_get_function(method) == MAP_FUNC_CLEAR;
+}
+
+
+/* Builtin structures that are handles or small plain values in the runtime,
+ * so they are cheaper to pass by value than by reference. */
+static const char* builtin_structures_by_value[] = {
+    "File",
+    "Color",
+};
+
+bool builtin_structure_is_passed_by_value(const context_t* ctx,
+                                          const structure_t* structure)
+{
+    if (!program_has_builtin_structure(ctx->program, &structure->identifier)) {
+        return false;
+    }
+
+    for (int i = 0; i < sizeof(builtin_structures_by_value)
+                        / sizeof(builtin_structures_by_value[0]); i++)
+    {
+        if (strcmp(structure->identifier.value,
+                   builtin_structures_by_value[i]) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
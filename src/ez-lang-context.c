@@ -6,6 +6,7 @@
 void context_init(context_t* ctx) {
     ctx->program = NULL;
     ctx->function = NULL;
+    ctx->options = NULL;
     ctx->error_prg = false;
 }
 
@@ -35,6 +36,8 @@ bool context_has_identifier(const context_t* ctx,
     if (program_has_global(ctx->program, id)
     ||  program_has_constant(ctx->program, id)
     ||  program_has_structure(ctx->program, id)
+    ||  program_has_enumeration(ctx->program, id)
+    ||  program_find_enumeration_member(ctx->program, id)
     ||  program_has_function(ctx->program, id)
     ||  program_has_procedure(ctx->program, id))
     {
@@ -50,6 +53,12 @@ structure_t* context_find_structure(const context_t* ctx,
     return program_find_structure(ctx->program, structure_id);
 }
 
+enumeration_t* context_find_enumeration(const context_t* ctx,
+                                        const identifier_t* enumeration_id)
+{
+    return program_find_enumeration(ctx->program, enumeration_id);
+}
+
 bool context_has_function(const context_t* ctx, const identifier_t* id) {
     if (function_is(ctx->function, id)) {
         return true;
@@ -96,7 +105,9 @@ bool context_funccall_is_valid(const context_t* ctx,
     return true;
 }
 
+/* `subject` is the whole valref, `valref` the part of it being checked. */
 static bool _context_valref_is_valid(const context_t* ctx,
+                                     const valref_t* subject,
                                      const valref_t* valref,
                                      const type_t* type,
                                      char* error_msg)
@@ -147,7 +158,7 @@ static bool _context_valref_is_valid(const context_t* ctx,
         } else {
             type = context_find_identifier_type(ctx, &valref->identifier);
         }
-        return _context_valref_is_valid(ctx, valref->next, type, error_msg);
+        return _context_valref_is_valid(ctx, subject, valref->next, type, error_msg);
     } else {
         if (valref->is_funccall) {
             if (type->type == TYPE_TYPE_VECTOR) {
@@ -162,13 +173,19 @@ static bool _context_valref_is_valid(const context_t* ctx,
                             valref->identifier.value);
                     return false;
                 }
+                if (!vector_function_destination_is_valid(subject, valref)) {
+                    sprintf(error_msg, "the vector given to '%s' can't be "
+                                       "the vector it is called on",
+                            valref->identifier.value);
+                    return false;
+                }
                 type = vector_function_get_type(valref, type);
                 if (!type && valref->next) {
                     sprintf(error_msg, "trying to access member of something "
                                        "that is not a structure or an object");
                     return false;
                 }
-                return _context_valref_is_valid(ctx, valref->next, type,
+                return _context_valref_is_valid(ctx, subject, valref->next, type,
                                                 error_msg);
             } else
             if (type->type == TYPE_TYPE_OPTIONAL) {
@@ -190,7 +207,47 @@ static bool _context_valref_is_valid(const context_t* ctx,
                                        "that is not a structure or an object");
                     return false;
                 }
-                return _context_valref_is_valid(ctx, valref->next, type,
+                return _context_valref_is_valid(ctx, subject, valref->next, type,
+                                                error_msg);
+            } else
+            if (type->type == TYPE_TYPE_MAP) {
+                if (!map_function_exists(&valref->identifier)) {
+                    sprintf(error_msg, "map has no method called '%s'",
+                            valref->identifier.value);
+                    return false;
+                }
+                if (!map_function_call_is_valid(ctx, valref, type)) {
+                    sprintf(error_msg, "invalid map function '%s' call",
+                            valref->identifier.value);
+                    return false;
+                }
+                type = map_function_get_type(valref, type);
+                if (!type && valref->next) {
+                    sprintf(error_msg, "trying to access member of something "
+                                       "that is not a structure or an object");
+                    return false;
+                }
+                return _context_valref_is_valid(ctx, subject, valref->next, type,
+                                                error_msg);
+            } else
+            if (type->type == TYPE_TYPE_ARRAY) {
+                if (!array_function_exists(&valref->identifier)) {
+                    sprintf(error_msg, "array has no method called '%s'",
+                            valref->identifier.value);
+                    return false;
+                }
+                if (!array_function_call_is_valid(ctx, valref, type)) {
+                    sprintf(error_msg, "invalid array function '%s' call",
+                            valref->identifier.value);
+                    return false;
+                }
+                if (!array_function_index_is_valid(ctx, valref, type)) {
+                    sprintf(error_msg, "index out of the bounds of an array "
+                                       "of %u elements", type->array_size);
+                    return false;
+                }
+                type = array_function_get_type(valref, type);
+                return _context_valref_is_valid(ctx, subject, valref->next, type,
                                                 error_msg);
             }
             return false;
@@ -216,7 +273,7 @@ static bool _context_valref_is_valid(const context_t* ctx,
                 return false;
             }
 
-            return _context_valref_is_valid(ctx, valref->next, member->is,
+            return _context_valref_is_valid(ctx, subject, valref->next, member->is,
                                             error_msg);
         }
     }
@@ -227,7 +284,7 @@ static bool _context_valref_is_valid(const context_t* ctx,
 bool context_valref_is_valid(const context_t* ctx, const valref_t* valref,
                              char* error_msg)
 {
-    return _context_valref_is_valid(ctx, valref, NULL, error_msg);
+    return _context_valref_is_valid(ctx, valref, valref, NULL, error_msg);
 }
 
 bool context_value_is_valid(const context_t* ctx, const value_t* value,
@@ -450,6 +507,12 @@ static const type_t* _context_valref_get_type(const context_t* ctx,
             } else
             if (type->type == TYPE_TYPE_OPTIONAL) {
                 type = optional_function_get_type(valref, type);
+            } else
+            if (type->type == TYPE_TYPE_MAP) {
+                type = map_function_get_type(valref, type);
+            } else
+            if (type->type == TYPE_TYPE_ARRAY) {
+                type = array_function_get_type(valref, type);
             }
             return _context_valref_get_type(ctx, valref->next, type);
         } else {
@@ -579,7 +642,9 @@ access_type_t context_valref_get_access_type(const context_t* ctx,
     if (ctx->program) {
         constant_t* constant = program_find_constant(ctx->program,
                                                 &v->identifier);
-        if (!constant) {
+        enumeration_t* enumeration =
+            program_find_enumeration_member(ctx->program, &v->identifier);
+        if (!constant && !enumeration) {
             return ACCESS_TYPE_INPUT_OUTPUT;
         }
     }
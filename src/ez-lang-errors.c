@@ -10,6 +10,14 @@ void error_print(FILE *input) {
   fprintf(stderr, "error (line %d): ", line);
 }
 
+void warning_print(FILE *input) {
+  int line, column;
+  char c;
+  get_file_coordinates(input, &line, &column, &c);
+
+  fprintf(stderr, "warning (line %d): ", line);
+}
+
 void error_identifier_is_keyword(FILE* input, const identifier_t* id) {
   error_print(input);
   fprintf(stderr, "symbol %s is a keyword\n", id->value);
@@ -28,18 +36,28 @@ void error_identifier_not_found(FILE* input, const identifier_t* id) {
 
 void error_valref_not_found(FILE* input, const context_t* ctx,
                             const valref_t* valref) {
+    emitter_t emitter;
+    emitter_init(&emitter, 128);
+
     error_print(input);
-    fprintf(stderr, "valref ");
-    valref_print(stderr, ctx, valref);
-    fprintf(stderr, " not found in this context\n");
+    emitter_puts(&emitter, "valref ");
+    valref_print(&emitter, ctx, valref);
+    emitter_puts(&emitter, " not found in this context\n");
+    emitter_flush(&emitter, stderr);
+    emitter_wipe(&emitter);
 }
 
 void error_valref_not_valid(FILE* input, const context_t* ctx,
                             const valref_t* valref, const char* suberr) {
+    emitter_t emitter;
+    emitter_init(&emitter, 128);
+
     error_print(input);
-    fprintf(stderr, "valref ");
-    valref_print(stderr, ctx, valref);
-    fprintf(stderr, " is not valid: %s\n", suberr);
+    emitter_puts(&emitter, "valref ");
+    valref_print(&emitter, ctx, valref);
+    emitter_printf(&emitter, " is not valid: %s\n", suberr);
+    emitter_flush(&emitter, stderr);
+    emitter_wipe(&emitter);
 }
 
 void error_no_main_function(const identifier_t* id) {
@@ -57,28 +75,43 @@ void error_invalid_main_function(const identifier_t* id) {
 void error_expression_not_valid(FILE* input, const context_t* ctx,
                                 const expression_t* expr, const char* suberr)
 {
+    emitter_t emitter;
+    emitter_init(&emitter, 128);
+
     error_print(input);
-    fprintf(stderr, "expression ");
-    expression_print(stderr, ctx, expr);
-    fprintf(stderr, " is not valid: %s\n", suberr);
+    emitter_puts(&emitter, "expression ");
+    expression_print(&emitter, ctx, expr);
+    emitter_printf(&emitter, " is not valid: %s\n", suberr);
+    emitter_flush(&emitter, stderr);
+    emitter_wipe(&emitter);
 }
 
 void error_parameters_not_valid(FILE* input, const context_t* ctx,
                                 const parameters_t* parameters)
 {
+    emitter_t emitter;
+    emitter_init(&emitter, 128);
+
     error_print(input);
-    fprintf(stderr, "parameters \n");
-    parameters_print(stderr, ctx, parameters);
-    fprintf(stderr, " are not valid in this context\n");
+    emitter_puts(&emitter, "parameters \n");
+    parameters_print(&emitter, ctx, parameters);
+    emitter_puts(&emitter, " are not valid in this context\n");
+    emitter_flush(&emitter, stderr);
+    emitter_wipe(&emitter);
 };
 
 void error_value_not_valid(FILE* input, const context_t* ctx,
                            const value_t* value, const char* suberr)
 {
+    emitter_t emitter;
+    emitter_init(&emitter, 128);
+
     error_print(input);
-    fprintf(stderr, "value ");
-    value_print(stderr, ctx, value);
-    fprintf(stderr, " is not valid: %s\n", suberr);
+    emitter_puts(&emitter, "value ");
+    value_print(&emitter, ctx, value);
+    emitter_printf(&emitter, " is not valid: %s\n", suberr);
+    emitter_flush(&emitter, stderr);
+    emitter_wipe(&emitter);
 }
 
 void error_decleration_not_valid(FILE* input) {
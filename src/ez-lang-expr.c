@@ -90,21 +90,25 @@ static char* expression_type_symbols[EXPRESSION_TYPE_SIZE] = {
     [EXPRESSION_TYPE_ARITHMETIC_OP_MOD]         = "%",
 };
 
-void lambda_print(FILE* output, const context_t* ctx, const function_t* func)
+const char* expression_type_symbol(expression_type_t type) {
+    return expression_type_symbols[type];
+}
+
+void lambda_print(emitter_t* output, const context_t* ctx, const function_t* func)
 {
-    fprintf(output, "[&](");
+    emitter_puts(output, "[&](");
     for (int i = 0; i < func->args.size; i++) {
         function_arg_print(output, ctx, func->args.elements[i]);
         if (i + 1 < func->args.size) {
-            fprintf(output, ", ");
+            emitter_puts(output, ", ");
         }
     }
-    fprintf(output, ") { ");
+    emitter_puts(output, ") { ");
     instruction_print(output, ctx, func->instructions.elements[0]);
-    fprintf(output, "}");
+    emitter_puts(output, "}");
 }
 
-void expression_print(FILE* output, const context_t* ctx,
+void expression_print(emitter_t* output, const context_t* ctx,
                       const expression_t* expr)
 {
     if (!expr) {
@@ -118,20 +122,20 @@ void expression_print(FILE* output, const context_t* ctx,
         lambda_print(output, ctx, expr->lambda);
     } else {
         if (expr->left) {
-            fputc('(', output);
+            emitter_putc(output, '(');
             expression_print(output, ctx, expr->left);
-            fputc(')', output);
+            emitter_putc(output, ')');
         }
 
-        fprintf(output, " %s ", expression_type_symbols[expr->type]);
+        emitter_printf(output, " %s ", expression_type_symbols[expr->type]);
         if (expr->type == EXPRESSION_TYPE_VALUE) {
             value_print(output, ctx, &expr->value);
         }
 
         if (expr->right) {
-            fputc('(', output);
+            emitter_putc(output, '(');
             expression_print(output, ctx, expr->right);
-            fputc(')', output);
+            emitter_putc(output, ')');
         }
     }
 }
@@ -19,6 +19,7 @@ bool identifier_is_reserved(const identifier_t* id) {
         "program",
         "structure"
         "constant",
+        "enumeration",
         "local",
         "global",
         "is",
@@ -35,6 +36,7 @@ bool identifier_is_reserved(const identifier_t* id) {
         "begin",
         "end",
         "for",
+        "parallel",
         "in",
         "do",
         "endfor",
@@ -47,6 +49,9 @@ bool identifier_is_reserved(const identifier_t* id) {
         "elsif",
         "else",
         "endif",
+        "match",
+        "case",
+        "endmatch",
         "print",
         "read",
         "lambda",
@@ -22,16 +22,20 @@ void elsif_instr_delete(elsif_instr_t* elsif) {
     free(elsif);
 }
 
-void elsif_instr_print(FILE* output, const context_t* ctx,
+void elsif_instr_print(emitter_t* output, const context_t* ctx,
                        const elsif_instr_t* elsif)
 {
-    fprintf(output, "else if (");
+    emitter_puts(output, "else if (");
     expression_print(output, ctx, elsif->coundition);
-    fprintf(output, ") {\n");
+    emitter_puts(output, ") {\n");
+
+    emitter_indent(output);
 
     instructions_print(output, ctx, &elsif->instructions);
 
-    fprintf(output, "}\n");
+    emitter_dedent(output);
+
+    emitter_puts(output, "}\n");
 }
 
 if_instr_t* if_instr_new(expression_t* coundition) {
@@ -58,24 +62,30 @@ void if_instr_delete(if_instr_t* if_instr) {
     free(if_instr);
 }
 
-void if_instr_print(FILE* output, const context_t* ctx,
+void if_instr_print(emitter_t* output, const context_t* ctx,
                     const if_instr_t* if_instr)
 {
-    fprintf(output, "if (");
+    emitter_puts(output, "if (");
     expression_print(output, ctx, if_instr->coundition);
-    fprintf(output, ") {\n");
+    emitter_puts(output, ") {\n");
+
+    emitter_indent(output);
 
     instructions_print(output, ctx, &if_instr->instructions);
-    fprintf(output, "}\n");
+
+    emitter_dedent(output);
+    emitter_puts(output, "}\n");
 
     for (int i = 0; i < if_instr->elsifs.size; i++) {
         elsif_instr_print(output, ctx, if_instr->elsifs.elements[i]);
     }
 
     if (if_instr->else_instrs.size) {
-        fprintf(output, "else {\n");
+        emitter_puts(output, "else {\n");
+        emitter_indent(output);
         instructions_print(output, ctx, &if_instr->else_instrs);
-        fprintf(output, "}\n");
+        emitter_dedent(output);
+        emitter_puts(output, "}\n");
     }
 }
 
@@ -98,14 +108,16 @@ void loop_instr_delete(loop_instr_t* loop) {
     free(loop);
 }
 
-void loop_instr_print(FILE* output, const context_t* ctx,
+void loop_instr_print(emitter_t* output, const context_t* ctx,
                       const loop_instr_t* loop_instr)
 {
-    fprintf(output, "do {\n");
+    emitter_puts(output, "do {\n");
+    emitter_indent(output);
     instructions_print(output, ctx, &loop_instr->instructions);
-    fprintf(output, "} while (!(");
+    emitter_dedent(output);
+    emitter_puts(output, "} while (!(");
     expression_print(output, ctx, loop_instr->coundition);
-    fprintf(output, "));\n");
+    emitter_puts(output, "));\n");
 }
 
 while_instr_t* while_instr_new(expression_t* coundition) {
@@ -127,14 +139,16 @@ void while_instr_delete(while_instr_t* while_instr) {
     free(while_instr);
 }
 
-void while_instr_print(FILE* output, const context_t* ctx,
+void while_instr_print(emitter_t* output, const context_t* ctx,
                        const while_instr_t* while_instr)
 {
-    fprintf(output, "while (");
+    emitter_puts(output, "while (");
     expression_print(output, ctx, while_instr->coundition);
-    fprintf(output, ") {\n");
+    emitter_puts(output, ") {\n");
+    emitter_indent(output);
     instructions_print(output, ctx, &while_instr->instructions);
-    fprintf(output, "}\n");
+    emitter_dedent(output);
+    emitter_puts(output, "}\n");
 }
 
 on_instr_t* on_instr_new(expression_t* coundition) {
@@ -156,14 +170,16 @@ void on_instr_delete(on_instr_t* on_instr) {
     free(on_instr);
 }
 
-void on_instr_print(FILE* output, const context_t* ctx,
+void on_instr_print(emitter_t* output, const context_t* ctx,
                     const on_instr_t* on_instr)
 {
-    fprintf(output, "if (");
+    emitter_puts(output, "if (");
     expression_print(output, ctx, on_instr->coundition);
-    fprintf(output, ") {\n");
+    emitter_puts(output, ") {\n");
+    emitter_indent(output);
     instruction_print(output, ctx, on_instr->instruction);
-    fprintf(output, "}\n");
+    emitter_dedent(output);
+    emitter_puts(output, "}\n");
 }
 
 for_instr_t* for_instr_new(const identifier_t* subject) {
@@ -173,6 +189,8 @@ for_instr_t* for_instr_new(const identifier_t* subject) {
     instr->range.from = NULL;
     instr->range.to   = NULL;
     vector_init(&instr->instructions, 0);
+    instr->is_parallel = false;
+    instr->is_bound_invariant = false;
 
     return instr;
 }
@@ -193,16 +211,272 @@ void for_instr_delete(for_instr_t* for_instr) {
     free(for_instr);
 }
 
-void for_instr_print(FILE* output, const context_t* ctx,
-                     const for_instr_t* for_instr)
+static void reduction_identity_print(emitter_t* output,
+                                     const parallel_reduction_t* reduction)
 {
-    fprintf(output, "for (%s = ", for_instr->subject.value);
+    switch (reduction->operator) {
+      case EXPRESSION_TYPE_BOOL_OP_AND:
+        emitter_puts(output, "{true}");
+        break;
+
+      case EXPRESSION_TYPE_BOOL_OP_OR:
+        emitter_puts(output, "{false}");
+        break;
+
+      case EXPRESSION_TYPE_ARITHMETIC_OP_MUL:
+        emitter_puts(output, "{1}");
+        break;
+
+      default:
+        emitter_puts(output, "{}");
+        break;
+    }
+}
+
+/* The range is split in chunks run by the runtime thread pool. In each
+ * chunk, the private locals and the parts of the reductions are locals of
+ * the same name: the last chunk gives the private locals their final value,
+ * and the parts are combined in order after the loop. */
+static void parallel_for_print(emitter_t* output, const context_t* ctx,
+                               const for_instr_t* for_instr)
+{
+    const char* subject = for_instr->subject.value;
+    const type_t* type = context_find_identifier_type(ctx,
+                                                      &for_instr->subject);
+    parallel_plan_t plan;
+    parallel_plan_init(&plan, ctx, for_instr);
+
+    emitter_puts(output, "{\n");
+    emitter_indent(output);
+    emitter_puts(output, "const ez::parallel_range< ");
+    type_print(output, ctx, type);
+    emitter_printf(output, " > _ez_%s_range(", subject);
     expression_print(output, ctx, for_instr->range.from);
-    fprintf(output, "; %s < ", for_instr->subject.value);
+    emitter_puts(output, ", ");
     expression_print(output, ctx, for_instr->range.to);
-    fprintf(output, "; %s++) {\n", for_instr->subject.value);
+    emitter_puts(output, ");\n");
+
+    for (int i = 0; i < plan.reductions.size; i++) {
+        const parallel_reduction_t* reduction = plan.reductions.elements[i];
+        emitter_printf(output, "const auto _ez_%s_parts = "
+                               "_ez_%s_range.parts< ",
+                       reduction->variable->value, subject);
+        type_print(output, ctx, reduction->type);
+        emitter_puts(output, " >();\n");
+    }
+    for (int i = 0; i < plan.privates.size; i++) {
+        const symbol_t* local = plan.privates.elements[i];
+        emitter_printf(output, "auto& _ez_%s_outer = %s;\n",
+                       local->identifier.value, local->identifier.value);
+    }
+
+    emitter_printf(output, "_ez_%s_range.run([&](size_t _ez_chunk, ",
+                   subject);
+    type_print(output, ctx, type);
+    emitter_printf(output, " _ez_%s_from, ", subject);
+    type_print(output, ctx, type);
+    emitter_printf(output, " _ez_%s_to) {\n", subject);
+    emitter_indent(output);
+
+    for (int i = 0; i < plan.privates.size; i++) {
+        const symbol_t* local = plan.privates.elements[i];
+        symbol_print(output, ctx, local);
+        emitter_puts(output, "{};\n");
+    }
+    for (int i = 0; i < plan.reductions.size; i++) {
+        const parallel_reduction_t* reduction = plan.reductions.elements[i];
+        type_print(output, ctx, reduction->type);
+        emitter_printf(output, " %s", reduction->variable->value);
+        reduction_identity_print(output, reduction);
+        emitter_puts(output, ";\n");
+    }
+
+    emitter_puts(output, "for (");
+    type_print(output, ctx, type);
+    emitter_printf(output, " %s = _ez_%s_from; %s < _ez_%s_to; %s++) {\n",
+                   subject, subject, subject, subject, subject);
+    emitter_indent(output);
     instructions_print(output, ctx, &for_instr->instructions);
-    fprintf(output, "}\n");
+    emitter_dedent(output);
+    emitter_puts(output, "}\n");
+
+    for (int i = 0; i < plan.reductions.size; i++) {
+        const parallel_reduction_t* reduction = plan.reductions.elements[i];
+        emitter_printf(output, "_ez_%s_parts[_ez_chunk] = std::move(%s);\n",
+                       reduction->variable->value,
+                       reduction->variable->value);
+    }
+    if (plan.privates.size > 0) {
+        emitter_printf(output, "if (_ez_chunk + 1 == _ez_%s_range.chunks()) "
+                               "{\n", subject);
+        emitter_indent(output);
+        for (int i = 0; i < plan.privates.size; i++) {
+            const symbol_t* local = plan.privates.elements[i];
+            emitter_printf(output, "_ez_%s_outer = std::move(%s);\n",
+                           local->identifier.value, local->identifier.value);
+        }
+        emitter_dedent(output);
+        emitter_puts(output, "}\n");
+    }
+    emitter_dedent(output);
+    emitter_puts(output, "});\n");
+
+    if (plan.reductions.size > 0) {
+        emitter_printf(output, "for (size_t _ez_chunk = 0; "
+                               "_ez_chunk < _ez_%s_range.chunks(); "
+                               "_ez_chunk++) {\n", subject);
+        emitter_indent(output);
+        for (int i = 0; i < plan.reductions.size; i++) {
+            const parallel_reduction_t* reduction =
+                plan.reductions.elements[i];
+            const char* variable = reduction->variable->value;
+            emitter_printf(output, "%s = %s %s _ez_%s_parts[_ez_chunk];\n",
+                           variable, variable,
+                           expression_type_symbol(reduction->operator),
+                           variable);
+        }
+        emitter_dedent(output);
+        emitter_puts(output, "}\n");
+    }
+
+    emitter_printf(output, "%s = _ez_%s_range.end();\n", subject, subject);
+    emitter_dedent(output);
+    emitter_puts(output, "}\n");
+
+    parallel_plan_wipe(&plan);
+}
+
+void for_instr_print(emitter_t* output, const context_t* ctx,
+                     const for_instr_t* for_instr)
+{
+    const char* subject = for_instr->subject.value;
+
+    if (for_instr->is_parallel) {
+        parallel_for_print(output, ctx, for_instr);
+        return;
+    }
+
+    if (!for_instr->is_bound_invariant) {
+        emitter_printf(output, "for (%s = ", subject);
+        expression_print(output, ctx, for_instr->range.from);
+        emitter_printf(output, "; %s < ", subject);
+        expression_print(output, ctx, for_instr->range.to);
+        emitter_printf(output, "; %s++) {\n", subject);
+        emitter_indent(output);
+        instructions_print(output, ctx, &for_instr->instructions);
+        emitter_dedent(output);
+        emitter_puts(output, "}\n");
+        return;
+    }
+
+    /* The bound is computed once, in its own block so loops on the same
+     * subject don't clash. */
+    emitter_puts(output, "{\n");
+    emitter_indent(output);
+    emitter_printf(output, "const auto _ez_%s_end = ", subject);
+    expression_print(output, ctx, for_instr->range.to);
+    emitter_puts(output, ";\n");
+    emitter_printf(output, "for (%s = ", subject);
+    expression_print(output, ctx, for_instr->range.from);
+    emitter_printf(output, "; %s < _ez_%s_end; %s++) {\n",
+                   subject, subject, subject);
+    emitter_indent(output);
+    instructions_print(output, ctx, &for_instr->instructions);
+    emitter_dedent(output);
+    emitter_puts(output, "}\n");
+    emitter_dedent(output);
+    emitter_puts(output, "}\n");
+}
+
+match_case_t* match_case_new(void) {
+    match_case_t* match_case = malloc(sizeof(match_case_t));
+    if (!match_case) {
+        fprintf(stderr, "couldn't allocate match case\n");
+        return NULL;
+    }
+
+    vector_init(&match_case->values, 0);
+    vector_init(&match_case->instructions, 0);
+
+    return match_case;
+}
+
+void match_case_delete(match_case_t* match_case) {
+    vector_wipe(&match_case->values, (delete_func_t)&expression_delete);
+    vector_wipe(&match_case->instructions,
+                (delete_func_t)&instruction_delete);
+    free(match_case);
+}
+
+match_instr_t* match_instr_new(expression_t* subject) {
+    match_instr_t* match_instr = malloc(sizeof(match_instr_t));
+    if (!match_instr) {
+        fprintf(stderr, "couldn't allocate match instruction\n");
+        return NULL;
+    }
+
+    match_instr->subject = subject;
+    vector_init(&match_instr->cases, 0);
+    vector_init(&match_instr->else_instrs, 0);
+    match_instr->has_else = false;
+
+    return match_instr;
+}
+
+void match_instr_delete(match_instr_t* match_instr) {
+    expression_delete(match_instr->subject);
+    vector_wipe(&match_instr->cases, (delete_func_t)&match_case_delete);
+    vector_wipe(&match_instr->else_instrs,
+                (delete_func_t)&instruction_delete);
+    free(match_instr);
+}
+
+/* Each case is a block ending with a `break`, the values of a case are
+ * consecutive labels of its block. */
+void match_instr_print(emitter_t* output, const context_t* ctx,
+                       const match_instr_t* match_instr)
+{
+    emitter_puts(output, "switch (");
+    expression_print(output, ctx, match_instr->subject);
+    emitter_puts(output, ") {\n");
+
+    for (int i = 0; i < match_instr->cases.size; i++) {
+        const match_case_t* match_case = match_instr->cases.elements[i];
+
+        for (int j = 0; j < match_case->values.size; j++) {
+            emitter_puts(output, "case ");
+            expression_print(output, ctx, match_case->values.elements[j]);
+            emitter_puts(output, (j + 1 < match_case->values.size)
+                                 ? ":\n" : ": {\n");
+        }
+        emitter_indent(output);
+        instructions_print(output, ctx, &match_case->instructions);
+        emitter_puts(output, "break;\n");
+        emitter_dedent(output);
+        emitter_puts(output, "}\n");
+    }
+
+    if (match_instr->has_else) {
+        emitter_puts(output, "default: {\n");
+        emitter_indent(output);
+        instructions_print(output, ctx, &match_instr->else_instrs);
+        emitter_puts(output, "break;\n");
+        emitter_dedent(output);
+        emitter_puts(output, "}\n");
+    } else {
+        /* The checker made sure a match on an enumeration without `else`
+         * has a case for each member. */
+        const type_t* type = context_expression_get_type(ctx,
+                                                         match_instr->subject);
+        if (type && type->type == TYPE_TYPE_ENUMERATION) {
+            emitter_puts(output, "default:\n");
+            emitter_indent(output);
+            emitter_puts(output, "__builtin_unreachable();\n");
+            emitter_dedent(output);
+        }
+    }
+
+    emitter_puts(output, "}\n");
 }
 
 void flowcontrol_wipe(flowcontrol_t* fc) {
@@ -227,10 +501,14 @@ void flowcontrol_wipe(flowcontrol_t* fc) {
         for_instr_delete(fc->for_instr);
         break;
 
+      case FLOWCONTROL_TYPE_MATCH:
+        match_instr_delete(fc->match_instr);
+        break;
+
     }
 }
 
-void flowcontrol_print(FILE* output, const context_t* ctx,
+void flowcontrol_print(emitter_t* output, const context_t* ctx,
                        const flowcontrol_t* fc_instr)
 {
     switch (fc_instr->type) {
@@ -254,6 +532,10 @@ void flowcontrol_print(FILE* output, const context_t* ctx,
         for_instr_print(output, ctx, fc_instr->for_instr);
         break;
 
+      case FLOWCONTROL_TYPE_MATCH:
+        match_instr_print(output, ctx, fc_instr->match_instr);
+        break;
+
     }
 }
 
@@ -262,13 +544,13 @@ void affectation_instr_wipe(affectation_instr_t* affectation) {
     expression_delete(affectation->expression);
 }
 
-void affectation_instr_print(FILE* output, const context_t* ctx,
+void affectation_instr_print(emitter_t* output, const context_t* ctx,
                              const affectation_instr_t* aff)
 {
     valref_print(output, ctx, aff->lvalue);
-    fprintf(output, " = ");
+    emitter_puts(output, " = ");
     expression_print(output, ctx, aff->expression);
-    fprintf(output, ";\n");
+    emitter_puts(output, ";\n");
 }
 
 instruction_t* instruction_new(instruction_type_t type) {
@@ -281,6 +563,10 @@ instruction_t* instruction_new(instruction_type_t type) {
 }
 
 void instruction_delete(instruction_t* instr) {
+    if (!instr) {
+        return;
+    }
+
     switch (instr->type) {
       case INSTRUCTION_TYPE_PRINT:
         parameters_wipe(&instr->parameters);
@@ -307,34 +593,35 @@ void instruction_delete(instruction_t* instr) {
     free(instr);
 }
 
-void instruction_print(FILE* output, const context_t* ctx,
+void instruction_print(emitter_t* output, const context_t* ctx,
                        const instruction_t* instr)
 {
     switch (instr->type) {
       case INSTRUCTION_TYPE_PRINT:
-        fprintf(output, "std::cout << ");
+        emitter_puts(output, "ez::out << ");
         for (int i = 0; i < instr->parameters.parameters.size; i++) {
             expression_print(output, ctx,
                              instr->parameters.parameters.elements[i]);
             if (i + 1 < instr->parameters.parameters.size) {
-                fprintf(output, " << ");
+                emitter_puts(output, " << ");
             }
         }
-        fprintf(output, ";\n");
+        emitter_puts(output, ";\n");
         break;
 
       case INSTRUCTION_TYPE_READ:
-        fprintf(output, "std::cin >> ");
+        emitter_puts(output, "ez::in >> ");
         valref_print(output, ctx,
                      instr->valref);
-        fprintf(output, ";\n");
+        emitter_puts(output, ";\n");
         break;
 
       case INSTRUCTION_TYPE_RETURN:
-        fprintf(output, "return ");
+        emitter_puts(output, "return ");
         expression_print(output, ctx,
                          instr->expression);
-        fprintf(output, ";\n");
+        emitter_puts(output, ";\n");
+        break;
 
       case INSTRUCTION_TYPE_FLOWCONTROL:
         flowcontrol_print(output, ctx, &instr->flowcontrol);
@@ -342,7 +629,7 @@ void instruction_print(FILE* output, const context_t* ctx,
 
       case INSTRUCTION_TYPE_EXPRESSION:
         expression_print(output, ctx, instr->expression);
-        fprintf(output, ";\n");
+        emitter_puts(output, ";\n");
         break;
 
       case INSTRUCTION_TYPE_AFFECTATION:
@@ -351,7 +638,7 @@ void instruction_print(FILE* output, const context_t* ctx,
     }
 }
 
-void instructions_print(FILE* output, const context_t* ctx,
+void instructions_print(emitter_t* output, const context_t* ctx,
                         const vector_t* instrs)
 {
     for (int i = 0; i < instrs->size; i++) {
@@ -0,0 +1,528 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ez-lang.h"
+
+/* Backward liveness analysis of the locals of a function.
+ *
+ * A live set is an array of booleans indexed like `function->locals`: a local
+ * is live at some point if its current value could still be read later.
+ * The instructions are walked backward from the end of the function, loops
+ * are iterated until their live sets are stable.
+ *
+ * Locals are the only candidates to be moved: `in` arguments are const
+ * references, and `out` or `inout` ones belong to the caller.
+ */
+typedef struct liveness {
+    const context_t*    ctx;
+    const function_t*   function;
+    size_t              size;
+} liveness_t;
+
+static bool* live_set_new(const liveness_t* l) {
+    bool* set = calloc(l->size + 1, sizeof(bool));
+    if (!set) {
+        fprintf(stderr, "couldn't allocate live set\n");
+        abort();
+    }
+    return set;
+}
+
+static bool* live_set_copy(const liveness_t* l, const bool* set) {
+    bool* copy = live_set_new(l);
+    memcpy(copy, set, l->size * sizeof(bool));
+    return copy;
+}
+
+/* Add `from` into `to`, returns true if `to` changed. */
+static bool live_set_merge(const liveness_t* l, bool* to, const bool* from) {
+    bool changed = false;
+    for (size_t i = 0; i < l->size; i++) {
+        if (from[i] && !to[i]) {
+            to[i] = true;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+static int local_index(const liveness_t* l, const identifier_t* id) {
+    if (function_has_arg(l->function, id)) {
+        return -1;
+    }
+
+    for (int i = 0; i < l->function->locals.size; i++) {
+        if (symbol_is(l->function->locals.elements[i], id)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* ------------------------------- uses ------------------------------------ */
+
+static void gen_expression(const liveness_t* l, const expression_t* expr,
+                           bool* live);
+
+static void gen_valref(const liveness_t* l, const valref_t* valref,
+                       bool* live)
+{
+    int index = local_index(l, &valref->identifier);
+    if (index >= 0) {
+        live[index] = true;
+    }
+
+    for (; valref; valref = valref->next) {
+        for (int i = 0; i < valref->parameters.parameters.size; i++) {
+            gen_expression(l, valref->parameters.parameters.elements[i], live);
+        }
+    }
+}
+
+/* Lambdas can't see the function locals, they are not walked. */
+static void gen_expression(const liveness_t* l, const expression_t* expr,
+                           bool* live)
+{
+    if (!expr || expr->type == EXPRESSION_TYPE_LAMBDA) {
+        return;
+    }
+
+    if (expr->type == EXPRESSION_TYPE_VALUE) {
+        if (expr->value.type == VALUE_TYPE_VALREF) {
+            gen_valref(l, expr->value.valref, live);
+        }
+        return;
+    }
+
+    gen_expression(l, expr->left, live);
+    gen_expression(l, expr->right, live);
+}
+
+static void gen_parameters(const liveness_t* l, const parameters_t* params,
+                           bool* live)
+{
+    for (int i = 0; i < params->parameters.size; i++) {
+        gen_expression(l, params->parameters.elements[i], live);
+    }
+}
+
+/* Count the uses of the local `index` in an instruction. */
+static int count_expression(const liveness_t* l, const expression_t* expr,
+                            int index);
+
+static int count_valref(const liveness_t* l, const valref_t* valref,
+                        int index)
+{
+    int count = (local_index(l, &valref->identifier) == index);
+
+    for (; valref; valref = valref->next) {
+        for (int i = 0; i < valref->parameters.parameters.size; i++) {
+            count += count_expression(l,
+                                      valref->parameters.parameters.elements[i],
+                                      index);
+        }
+    }
+    return count;
+}
+
+static int count_expression(const liveness_t* l, const expression_t* expr,
+                            int index)
+{
+    if (!expr || expr->type == EXPRESSION_TYPE_LAMBDA) {
+        return 0;
+    }
+
+    if (expr->type == EXPRESSION_TYPE_VALUE) {
+        if (expr->value.type == VALUE_TYPE_VALREF) {
+            return count_valref(l, expr->value.valref, index);
+        }
+        return 0;
+    }
+
+    return count_expression(l, expr->left, index)
+         + count_expression(l, expr->right, index);
+}
+
+/* ------------------------------- moves ----------------------------------- */
+
+/* If `expr` is a whole local read for the last time in its instruction
+ * (`uses` is its number of uses there), mark it to be moved. */
+static void mark_last_use(const liveness_t* l, expression_t* expr,
+                          const bool* live_after, int uses)
+{
+    if (expr->type != EXPRESSION_TYPE_VALUE
+    ||  expr->value.type != VALUE_TYPE_VALREF)
+    {
+        return;
+    }
+
+    valref_t* valref = expr->value.valref;
+    if (valref->next || valref->is_funccall) {
+        return;
+    }
+
+    int index = local_index(l, &valref->identifier);
+    if (index < 0 || live_after[index] || uses != 1) {
+        return;
+    }
+
+    const symbol_t* local = l->function->locals.elements[index];
+    if (type_is_passed_by_value(l->ctx, local->is)) {
+        return;
+    }
+
+    valref->is_last_use = true;
+}
+
+/* Mark the parameters given to builtin methods that keep them, like
+ * `v.push(x)`, in the valrefs of an expression instruction. */
+static void mark_method_parameters(const liveness_t* l, const expression_t* instr,
+                                   expression_t* expr, const bool* live_after)
+{
+    if (!expr || expr->type == EXPRESSION_TYPE_LAMBDA) {
+        return;
+    }
+
+    if (expr->type != EXPRESSION_TYPE_VALUE) {
+        mark_method_parameters(l, instr, expr->left, live_after);
+        mark_method_parameters(l, instr, expr->right, live_after);
+        return;
+    }
+
+    if (expr->value.type != VALUE_TYPE_VALREF) {
+        return;
+    }
+
+    valref_t* head = expr->value.valref;
+    for (valref_t* valref = head; valref; valref = valref->next) {
+        parameters_t* params = &valref->parameters;
+
+        for (int i = 0; i < params->parameters.size; i++) {
+            expression_t* param = params->parameters.elements[i];
+
+            if (valref != head
+            &&  builtin_method_keeps_parameter(&valref->identifier, i)
+            &&  param->type == EXPRESSION_TYPE_VALUE
+            &&  param->value.type == VALUE_TYPE_VALREF)
+            {
+                int index = local_index(l, &param->value.valref->identifier);
+                if (index >= 0) {
+                    mark_last_use(l, param, live_after,
+                                  count_expression(l, instr, index));
+                }
+            }
+            mark_method_parameters(l, instr, param, live_after);
+        }
+    }
+}
+
+/* ---------------------------- instructions ------------------------------- */
+
+static void live_instructions(const liveness_t* l, const vector_t* instrs,
+                              bool* live, bool mark);
+
+/* A write to a whole local kills it, a write to a part of it (a member or
+ * an element) is also a use. */
+static void kill_valref(const liveness_t* l, const valref_t* lvalue,
+                        bool* live)
+{
+    int index = local_index(l, &lvalue->identifier);
+    if (index >= 0 && !lvalue->next) {
+        live[index] = false;
+    }
+}
+
+static void gen_lvalue(const liveness_t* l, const valref_t* lvalue,
+                       bool* live)
+{
+    int index = local_index(l, &lvalue->identifier);
+    if (index >= 0 && lvalue->next) {
+        live[index] = true;
+    }
+
+    for (; lvalue; lvalue = lvalue->next) {
+        gen_parameters(l, &lvalue->parameters, live);
+    }
+}
+
+static void live_while(const liveness_t* l, const while_instr_t* while_instr,
+                       bool* live, bool mark)
+{
+    /* `header` is live at the coundition check: after the loop, in the
+     * coundition, or at the start of the body. */
+    bool* header = live_set_copy(l, live);
+    gen_expression(l, while_instr->coundition, header);
+
+    bool changed = true;
+    while (changed) {
+        bool* body = live_set_copy(l, header);
+        live_instructions(l, &while_instr->instructions, body, false);
+        changed = live_set_merge(l, header, body);
+        free(body);
+    }
+
+    if (mark) {
+        bool* body = live_set_copy(l, header);
+        live_instructions(l, &while_instr->instructions, body, true);
+        free(body);
+    }
+
+    memcpy(live, header, l->size * sizeof(bool));
+    free(header);
+}
+
+static void live_loop(const liveness_t* l, const loop_instr_t* loop_instr,
+                      bool* live, bool mark)
+{
+    /* `end` is live at the end of the body: after the loop, in the
+     * coundition, or at the start of the body. */
+    bool* end = live_set_copy(l, live);
+    gen_expression(l, loop_instr->coundition, end);
+
+    bool* start = NULL;
+    bool changed = true;
+    while (changed) {
+        free(start);
+        start = live_set_copy(l, end);
+        live_instructions(l, &loop_instr->instructions, start, false);
+        changed = live_set_merge(l, end, start);
+    }
+
+    if (mark) {
+        bool* body = live_set_copy(l, end);
+        live_instructions(l, &loop_instr->instructions, body, true);
+        free(body);
+    }
+
+    memcpy(live, start, l->size * sizeof(bool));
+    free(start);
+    free(end);
+}
+
+static void live_for(const liveness_t* l, const for_instr_t* for_instr,
+                     bool* live, bool mark)
+{
+    /* `header` is live at the `subject < to` check. */
+    int subject = local_index(l, &for_instr->subject);
+    bool* header = live_set_copy(l, live);
+    gen_expression(l, for_instr->range.to, header);
+    if (subject >= 0) {
+        header[subject] = true;
+    }
+
+    bool changed = true;
+    while (changed) {
+        bool* body = live_set_copy(l, header);
+        live_instructions(l, &for_instr->instructions, body, false);
+        changed = live_set_merge(l, header, body);
+        free(body);
+    }
+
+    if (mark) {
+        bool* body = live_set_copy(l, header);
+        live_instructions(l, &for_instr->instructions, body, true);
+        free(body);
+    }
+
+    memcpy(live, header, l->size * sizeof(bool));
+    if (subject >= 0) {
+        live[subject] = false;
+    }
+    gen_expression(l, for_instr->range.from, live);
+    free(header);
+}
+
+static void live_instruction(const liveness_t* l, const instruction_t* instr,
+                             bool* live, bool mark);
+
+static void live_if(const liveness_t* l, const if_instr_t* if_instr,
+                    bool* live, bool mark)
+{
+    bool* before = live_set_copy(l, live);
+    bool* branch = NULL;
+
+    branch = live_set_copy(l, live);
+    live_instructions(l, &if_instr->instructions, branch, mark);
+    live_set_merge(l, before, branch);
+    free(branch);
+
+    for (int i = 0; i < if_instr->elsifs.size; i++) {
+        const elsif_instr_t* elsif = if_instr->elsifs.elements[i];
+
+        branch = live_set_copy(l, live);
+        live_instructions(l, &elsif->instructions, branch, mark);
+        live_set_merge(l, before, branch);
+        free(branch);
+        gen_expression(l, elsif->coundition, before);
+    }
+
+    /* Without `else`, what is live after the `if` stays live before it. */
+    branch = live_set_copy(l, live);
+    live_instructions(l, &if_instr->else_instrs, branch, mark);
+    live_set_merge(l, before, branch);
+    free(branch);
+
+    gen_expression(l, if_instr->coundition, before);
+
+    memcpy(live, before, l->size * sizeof(bool));
+    free(before);
+}
+
+static void live_match(const liveness_t* l, const match_instr_t* match_instr,
+                       bool* live, bool mark)
+{
+    bool* before = live_set_copy(l, live);
+    bool* branch = NULL;
+
+    for (int i = 0; i < match_instr->cases.size; i++) {
+        const match_case_t* match_case = match_instr->cases.elements[i];
+
+        branch = live_set_copy(l, live);
+        live_instructions(l, &match_case->instructions, branch, mark);
+        live_set_merge(l, before, branch);
+        free(branch);
+    }
+
+    /* Like a `if`, without `else` what is live after the `match` stays live
+     * before it. */
+    branch = live_set_copy(l, live);
+    live_instructions(l, &match_instr->else_instrs, branch, mark);
+    live_set_merge(l, before, branch);
+    free(branch);
+
+    gen_expression(l, match_instr->subject, before);
+
+    memcpy(live, before, l->size * sizeof(bool));
+    free(before);
+}
+
+static void live_on(const liveness_t* l, const on_instr_t* on_instr,
+                    bool* live, bool mark)
+{
+    bool* branch = live_set_copy(l, live);
+
+    live_instruction(l, on_instr->instruction, branch, mark);
+    live_set_merge(l, live, branch);
+    gen_expression(l, on_instr->coundition, live);
+
+    free(branch);
+}
+
+/* On call, `live` is the set of locals live after `instr`. It is updated to
+ * the set of locals live before it. */
+static void live_instruction(const liveness_t* l, const instruction_t* instr,
+                             bool* live, bool mark)
+{
+    switch (instr->type) {
+      case INSTRUCTION_TYPE_PRINT:
+        gen_parameters(l, &instr->parameters, live);
+        break;
+
+      case INSTRUCTION_TYPE_READ:
+        kill_valref(l, instr->valref, live);
+        gen_lvalue(l, instr->valref, live);
+        break;
+
+      case INSTRUCTION_TYPE_RETURN:
+        memset(live, 0, l->size * sizeof(bool));
+        gen_expression(l, instr->expression, live);
+        break;
+
+      case INSTRUCTION_TYPE_EXPRESSION:
+        if (mark) {
+            mark_method_parameters(l, instr->expression, instr->expression,
+                                   live);
+        }
+        gen_expression(l, instr->expression, live);
+        break;
+
+      case INSTRUCTION_TYPE_AFFECTATION: {
+        const affectation_instr_t* aff = &instr->affectation;
+
+        if (mark && aff->expression->type == EXPRESSION_TYPE_VALUE
+        &&  aff->expression->value.type == VALUE_TYPE_VALREF)
+        {
+            int index = local_index(l,
+                                &aff->expression->value.valref->identifier);
+            if (index >= 0) {
+                int uses = count_valref(l, aff->lvalue, index)
+                         + count_expression(l, aff->expression, index);
+                mark_last_use(l, aff->expression, live, uses);
+            }
+        }
+
+        kill_valref(l, aff->lvalue, live);
+        gen_lvalue(l, aff->lvalue, live);
+        gen_expression(l, aff->expression, live);
+        break;
+      }
+
+      case INSTRUCTION_TYPE_FLOWCONTROL:
+        switch (instr->flowcontrol.type) {
+          case FLOWCONTROL_TYPE_IF:
+            live_if(l, instr->flowcontrol.if_instr, live, mark);
+            break;
+
+          case FLOWCONTROL_TYPE_WHILE:
+            live_while(l, instr->flowcontrol.while_instr, live, mark);
+            break;
+
+          case FLOWCONTROL_TYPE_LOOP:
+            live_loop(l, instr->flowcontrol.loop_instr, live, mark);
+            break;
+
+          case FLOWCONTROL_TYPE_ON:
+            live_on(l, instr->flowcontrol.on_instr, live, mark);
+            break;
+
+          case FLOWCONTROL_TYPE_FOR:
+            live_for(l, instr->flowcontrol.for_instr, live, mark);
+            break;
+
+          case FLOWCONTROL_TYPE_MATCH:
+            live_match(l, instr->flowcontrol.match_instr, live, mark);
+            break;
+        }
+        break;
+    }
+}
+
+static void live_instructions(const liveness_t* l, const vector_t* instrs,
+                              bool* live, bool mark)
+{
+    for (int i = instrs->size - 1; i >= 0; i--) {
+        live_instruction(l, instrs->elements[i], live, mark);
+    }
+}
+
+static void function_mark_last_uses(const context_t* ctx,
+                                    function_t* function)
+{
+    context_t function_ctx = *ctx;
+    function_ctx.function = function;
+
+    const liveness_t l = (liveness_t){
+        .ctx = &function_ctx,
+        .function = function,
+        .size = function->locals.size,
+    };
+
+    /* Nothing is live once the function returns. */
+    bool* live = live_set_new(&l);
+    live_instructions(&l, &function->instructions, live, true);
+    free(live);
+}
+
+void program_mark_last_uses(program_t* prg) {
+    const context_t ctx = (context_t){
+        .program = prg,
+        .function = NULL
+    };
+
+    for (int i = 0; i < prg->functions.size; i++) {
+        function_mark_last_uses(&ctx, prg->functions.elements[i]);
+    }
+    for (int i = 0; i < prg->procedures.size; i++) {
+        function_mark_last_uses(&ctx, prg->procedures.elements[i]);
+    }
+}
@@ -0,0 +1,400 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ez-lang.h"
+
+/* A `for` bound is hoisted out of its loop when it can't change while the
+ * loop runs: none of the variables it reads are written in the loop body,
+ * and it only calls builtin methods that don't modify their subject.
+ *
+ * Locals and `in` arguments passed by value are private to the function.
+ * Other variables (globals, and arguments passed by reference) are shared:
+ * they could be aliases of each other, and be modified by any call to a
+ * program function or by any lambda.
+ */
+typedef struct hoisting {
+    const context_t*    ctx;
+    const function_t*   function;
+} hoisting_t;
+
+/* The variables written in a loop body. */
+typedef struct loop_writes {
+    vector_t    written;            /* of const identifier_t* */
+    bool        may_write_shared;
+} loop_writes_t;
+
+static bool identifier_equals(const identifier_t* a, const identifier_t* b) {
+    return strcmp(a->value, b->value) == 0;
+}
+
+static bool variable_is_private(const hoisting_t* h, const identifier_t* id) {
+    const function_arg_t* arg = function_find_arg(h->function, id);
+    if (arg) {
+        return arg->access_type == ACCESS_TYPE_INPUT
+            && type_is_passed_by_value(h->ctx, arg->symbol->is);
+    }
+
+    return function_has_local(h->function, id)
+        || program_has_constant(h->ctx->program, id);
+}
+
+static bool valref_calls_program(const hoisting_t* h, const valref_t* valref)
+{
+    const program_t* prg = h->ctx->program;
+
+    return valref->is_funccall
+        && (vector_contains(&prg->functions, &valref->identifier,
+                            (cmp_func_t)&function_is)
+        ||  vector_contains(&prg->procedures, &valref->identifier,
+                            (cmp_func_t)&function_is));
+}
+
+/* ------------------------------ writes ----------------------------------- */
+
+static void write_variable(const hoisting_t* h, loop_writes_t* writes,
+                           const identifier_t* id)
+{
+    if (!variable_is_private(h, id)) {
+        writes->may_write_shared = true;
+    }
+    vector_push(&writes->written, (void*)id);
+}
+
+static void collect_expression(const hoisting_t* h, loop_writes_t* writes,
+                               const expression_t* expr);
+
+static void collect_valref(const hoisting_t* h, loop_writes_t* writes,
+                           const valref_t* valref)
+{
+    if (valref->is_funccall) {
+        /* Program functions can write any shared variable, any function
+         * can write the variables given to its `out` arguments. */
+        if (valref_calls_program(h, valref)) {
+            writes->may_write_shared = true;
+        }
+
+        const parameters_t* params = &valref->parameters;
+        for (int i = 0; i < params->parameters.size; i++) {
+            const expression_t* param = params->parameters.elements[i];
+            if (param->type == EXPRESSION_TYPE_VALUE
+            &&  param->value.type == VALUE_TYPE_VALREF)
+            {
+                write_variable(h, writes, &param->value.valref->identifier);
+            }
+        }
+    }
+
+    for (const valref_t* it = valref; it; it = it->next) {
+        if (it != valref && it->is_funccall
+        &&  !builtin_method_is_const(&it->identifier))
+        {
+            write_variable(h, writes, &valref->identifier);
+        }
+
+        const parameters_t* params = &it->parameters;
+        for (int i = 0; i < params->parameters.size; i++) {
+            const expression_t* param = params->parameters.elements[i];
+
+            if (it != valref
+            &&  builtin_method_writes_parameter(&it->identifier, i)
+            &&  param->type == EXPRESSION_TYPE_VALUE
+            &&  param->value.type == VALUE_TYPE_VALREF)
+            {
+                write_variable(h, writes, &param->value.valref->identifier);
+            }
+            collect_expression(h, writes, param);
+        }
+    }
+}
+
+static void collect_expression(const hoisting_t* h, loop_writes_t* writes,
+                               const expression_t* expr)
+{
+    if (!expr) {
+        return;
+    }
+
+    switch (expr->type) {
+      case EXPRESSION_TYPE_VALUE:
+        if (expr->value.type == VALUE_TYPE_VALREF) {
+            collect_valref(h, writes, expr->value.valref);
+        }
+        break;
+
+      case EXPRESSION_TYPE_LAMBDA:
+        /* Lambdas can write the globals. */
+        writes->may_write_shared = true;
+        break;
+
+      default:
+        collect_expression(h, writes, expr->left);
+        collect_expression(h, writes, expr->right);
+        break;
+    }
+}
+
+static void collect_instructions(const hoisting_t* h, loop_writes_t* writes,
+                                 const vector_t* instrs);
+
+static void collect_instruction(const hoisting_t* h, loop_writes_t* writes,
+                                const instruction_t* instr)
+{
+    switch (instr->type) {
+      case INSTRUCTION_TYPE_PRINT:
+        for (int i = 0; i < instr->parameters.parameters.size; i++) {
+            collect_expression(h, writes,
+                               instr->parameters.parameters.elements[i]);
+        }
+        break;
+
+      case INSTRUCTION_TYPE_READ:
+        write_variable(h, writes, &instr->valref->identifier);
+        collect_valref(h, writes, instr->valref);
+        break;
+
+      case INSTRUCTION_TYPE_RETURN:
+      case INSTRUCTION_TYPE_EXPRESSION:
+        collect_expression(h, writes, instr->expression);
+        break;
+
+      case INSTRUCTION_TYPE_AFFECTATION:
+        write_variable(h, writes, &instr->affectation.lvalue->identifier);
+        collect_valref(h, writes, instr->affectation.lvalue);
+        collect_expression(h, writes, instr->affectation.expression);
+        break;
+
+      case INSTRUCTION_TYPE_FLOWCONTROL: {
+        const flowcontrol_t* fc = &instr->flowcontrol;
+
+        switch (fc->type) {
+          case FLOWCONTROL_TYPE_IF:
+            collect_expression(h, writes, fc->if_instr->coundition);
+            collect_instructions(h, writes, &fc->if_instr->instructions);
+            for (int i = 0; i < fc->if_instr->elsifs.size; i++) {
+                const elsif_instr_t* elsif = fc->if_instr->elsifs.elements[i];
+                collect_expression(h, writes, elsif->coundition);
+                collect_instructions(h, writes, &elsif->instructions);
+            }
+            collect_instructions(h, writes, &fc->if_instr->else_instrs);
+            break;
+
+          case FLOWCONTROL_TYPE_WHILE:
+            collect_expression(h, writes, fc->while_instr->coundition);
+            collect_instructions(h, writes, &fc->while_instr->instructions);
+            break;
+
+          case FLOWCONTROL_TYPE_LOOP:
+            collect_expression(h, writes, fc->loop_instr->coundition);
+            collect_instructions(h, writes, &fc->loop_instr->instructions);
+            break;
+
+          case FLOWCONTROL_TYPE_ON:
+            collect_expression(h, writes, fc->on_instr->coundition);
+            collect_instruction(h, writes, fc->on_instr->instruction);
+            break;
+
+          case FLOWCONTROL_TYPE_FOR:
+            write_variable(h, writes, &fc->for_instr->subject);
+            collect_expression(h, writes, fc->for_instr->range.from);
+            collect_expression(h, writes, fc->for_instr->range.to);
+            collect_instructions(h, writes, &fc->for_instr->instructions);
+            break;
+
+          case FLOWCONTROL_TYPE_MATCH:
+            collect_expression(h, writes, fc->match_instr->subject);
+            for (int i = 0; i < fc->match_instr->cases.size; i++) {
+                const match_case_t* match_case =
+                    fc->match_instr->cases.elements[i];
+                collect_instructions(h, writes, &match_case->instructions);
+            }
+            collect_instructions(h, writes, &fc->match_instr->else_instrs);
+            break;
+        }
+        break;
+      }
+    }
+}
+
+static void collect_instructions(const hoisting_t* h, loop_writes_t* writes,
+                                 const vector_t* instrs)
+{
+    for (int i = 0; i < instrs->size; i++) {
+        collect_instruction(h, writes, instrs->elements[i]);
+    }
+}
+
+/* ------------------------------ bounds ----------------------------------- */
+
+static bool expression_is_invariant(const hoisting_t* h,
+                                    const loop_writes_t* writes,
+                                    const identifier_t* subject,
+                                    const expression_t* expr);
+
+static bool valref_is_invariant(const hoisting_t* h,
+                                const loop_writes_t* writes,
+                                const identifier_t* subject,
+                                const valref_t* valref)
+{
+    const identifier_t* id = &valref->identifier;
+
+    /* Even builtin functions, like `random`, could give another result. */
+    if (valref->is_funccall
+    ||  identifier_equals(id, subject)
+    ||  vector_contains(&writes->written, id, (cmp_func_t)&identifier_equals)
+    ||  (writes->may_write_shared && !variable_is_private(h, id)))
+    {
+        return false;
+    }
+
+    for (const valref_t* it = valref; it; it = it->next) {
+        if (it->is_funccall && !builtin_method_is_const(&it->identifier)) {
+            return false;
+        }
+
+        const parameters_t* params = &it->parameters;
+        for (int i = 0; i < params->parameters.size; i++) {
+            if (!expression_is_invariant(h, writes, subject,
+                                         params->parameters.elements[i]))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool expression_is_invariant(const hoisting_t* h,
+                                    const loop_writes_t* writes,
+                                    const identifier_t* subject,
+                                    const expression_t* expr)
+{
+    if (!expr) {
+        return true;
+    }
+
+    switch (expr->type) {
+      case EXPRESSION_TYPE_VALUE:
+        return expr->value.type != VALUE_TYPE_VALREF
+            || valref_is_invariant(h, writes, subject, expr->value.valref);
+
+      case EXPRESSION_TYPE_LAMBDA:
+        return false;
+
+      default:
+        return expression_is_invariant(h, writes, subject, expr->left)
+            && expression_is_invariant(h, writes, subject, expr->right);
+    }
+}
+
+/* Only bounds reading a member or calling a method are worth a local, the
+ * C++ compiler already keeps the plain variables in registers. */
+static bool expression_is_worth_hoisting(const expression_t* expr) {
+    if (!expr || expr->type == EXPRESSION_TYPE_LAMBDA) {
+        return false;
+    }
+
+    if (expr->type == EXPRESSION_TYPE_VALUE) {
+        return expr->value.type == VALUE_TYPE_VALREF
+            && expr->value.valref->next != NULL;
+    }
+
+    return expression_is_worth_hoisting(expr->left)
+        || expression_is_worth_hoisting(expr->right);
+}
+
+/* --------------------------- instructions -------------------------------- */
+
+static void hoist_instructions(const hoisting_t* h, const vector_t* instrs);
+
+static void hoist_for(const hoisting_t* h, for_instr_t* for_instr) {
+    hoist_instructions(h, &for_instr->instructions);
+
+    if (!expression_is_worth_hoisting(for_instr->range.to)) {
+        return;
+    }
+
+    loop_writes_t writes = (loop_writes_t){
+        .may_write_shared = false,
+    };
+    vector_init(&writes.written, 0);
+
+    collect_instructions(h, &writes, &for_instr->instructions);
+    for_instr->is_bound_invariant =
+        expression_is_invariant(h, &writes, &for_instr->subject,
+                                for_instr->range.to);
+
+    vector_wipe(&writes.written, NULL);
+}
+
+static void hoist_instruction(const hoisting_t* h, instruction_t* instr) {
+    if (instr->type != INSTRUCTION_TYPE_FLOWCONTROL) {
+        return;
+    }
+
+    flowcontrol_t* fc = &instr->flowcontrol;
+    switch (fc->type) {
+      case FLOWCONTROL_TYPE_IF:
+        hoist_instructions(h, &fc->if_instr->instructions);
+        for (int i = 0; i < fc->if_instr->elsifs.size; i++) {
+            const elsif_instr_t* elsif = fc->if_instr->elsifs.elements[i];
+            hoist_instructions(h, &elsif->instructions);
+        }
+        hoist_instructions(h, &fc->if_instr->else_instrs);
+        break;
+
+      case FLOWCONTROL_TYPE_WHILE:
+        hoist_instructions(h, &fc->while_instr->instructions);
+        break;
+
+      case FLOWCONTROL_TYPE_LOOP:
+        hoist_instructions(h, &fc->loop_instr->instructions);
+        break;
+
+      case FLOWCONTROL_TYPE_ON:
+        hoist_instruction(h, fc->on_instr->instruction);
+        break;
+
+      case FLOWCONTROL_TYPE_FOR:
+        hoist_for(h, fc->for_instr);
+        break;
+
+      case FLOWCONTROL_TYPE_MATCH:
+        for (int i = 0; i < fc->match_instr->cases.size; i++) {
+            const match_case_t* match_case = fc->match_instr->cases.elements[i];
+            hoist_instructions(h, &match_case->instructions);
+        }
+        hoist_instructions(h, &fc->match_instr->else_instrs);
+        break;
+    }
+}
+
+static void hoist_instructions(const hoisting_t* h, const vector_t* instrs) {
+    for (int i = 0; i < instrs->size; i++) {
+        hoist_instruction(h, instrs->elements[i]);
+    }
+}
+
+static void function_hoist_loop_bounds(const context_t* ctx,
+                                       const function_t* function)
+{
+    const hoisting_t h = (hoisting_t){
+        .ctx = ctx,
+        .function = function,
+    };
+
+    hoist_instructions(&h, &function->instructions);
+}
+
+void program_hoist_loop_bounds(program_t* prg) {
+    const context_t ctx = (context_t){
+        .program = prg,
+        .function = NULL
+    };
+
+    for (int i = 0; i < prg->functions.size; i++) {
+        function_hoist_loop_bounds(&ctx, prg->functions.elements[i]);
+    }
+    for (int i = 0; i < prg->procedures.size; i++) {
+        function_hoist_loop_bounds(&ctx, prg->procedures.elements[i]);
+    }
+}
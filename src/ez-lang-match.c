@@ -0,0 +1,205 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "ez-lang.h"
+#include "ez-lang-errors.h"
+
+static bool type_can_be_matched(const type_t* type) {
+    return type
+        && (type->type == TYPE_TYPE_ENUMERATION
+        ||  type->type == TYPE_TYPE_INTEGER
+        ||  type->type == TYPE_TYPE_NATURAL
+        ||  type->type == TYPE_TYPE_CHAR);
+}
+
+/* What the values of a case must be, for the error messages. */
+static const char* case_values_kind(const type_t* type) {
+    switch (type->type) {
+      case TYPE_TYPE_ENUMERATION:
+        return "members of the enumeration";
+
+      case TYPE_TYPE_INTEGER:
+        return "integer literals";
+
+      case TYPE_TYPE_NATURAL:
+        return "natural literals";
+
+      default:
+        return "char literals";
+    }
+}
+
+/* Get in `value` the value of the case `expr` of a match on `type`, the one
+ * the C++ `switch` compares (the index of a member for enumerations).
+ * Returns false if `expr` can't be a case of this match.
+ */
+static bool case_get_value(const type_t* type, const expression_t* expr,
+                           long* value)
+{
+    if (expr->type != EXPRESSION_TYPE_VALUE) {
+        return false;
+    }
+
+    const value_t* v = &expr->value;
+    switch (type->type) {
+      case TYPE_TYPE_ENUMERATION:
+        if (v->type != VALUE_TYPE_VALREF
+        ||  v->valref->is_funccall || v->valref->next)
+        {
+            return false;
+        }
+        *value = enumeration_find_member(type->enumeration_type,
+                                         &v->valref->identifier);
+        return *value >= 0;
+
+      case TYPE_TYPE_INTEGER:
+        if (v->type == VALUE_TYPE_INTEGER) {
+            *value = v->integer;
+            return true;
+        }
+        if (v->type == VALUE_TYPE_NATURAL) {
+            *value = v->natural;
+            return true;
+        }
+        return false;
+
+      case TYPE_TYPE_NATURAL:
+        if (v->type == VALUE_TYPE_NATURAL) {
+            *value = v->natural;
+            return true;
+        }
+        return false;
+
+      case TYPE_TYPE_CHAR:
+        if (v->type == VALUE_TYPE_CHAR) {
+            *value = v->character;
+            return true;
+        }
+        return false;
+
+      default:
+        return false;
+    }
+}
+
+static bool value_equals(const void* a, const void* b) {
+    return a == b;
+}
+
+static void case_error(FILE* input, const context_t* ctx,
+                       const expression_t* expr, const char* message)
+{
+    emitter_t emitter;
+    emitter_init(&emitter, 128);
+    expression_print(&emitter, ctx, expr);
+
+    error_print(input);
+    fprintf(stderr, "'%s' %s\n", emitter_data(&emitter), message);
+
+    emitter_wipe(&emitter);
+}
+
+/* Without `else`, a match on an enumeration must handle all its members. */
+static bool match_is_exhaustive(FILE* input, const type_t* type,
+                                const bool* handled)
+{
+    const enumeration_t* enumeration = type->enumeration_type;
+    int nmissing = 0;
+
+    for (int i = 0; i < enumeration->members.size; i++) {
+        if (handled[i]) {
+            continue;
+        }
+        const identifier_t* member = enumeration->members.elements[i];
+        if (nmissing == 0) {
+            error_print(input);
+            fprintf(stderr, "the match on '%s' has no case for '%s'",
+                    enumeration->identifier.value, member->value);
+        } else {
+            fprintf(stderr, ", '%s'", member->value);
+        }
+        nmissing++;
+    }
+
+    if (nmissing > 0) {
+        fprintf(stderr, ", it needs these cases or an 'else'\n");
+    }
+    return nmissing == 0;
+}
+
+bool match_instr_is_valid(FILE* input, const context_t* ctx,
+                          const match_instr_t* match_instr)
+{
+    const type_t* type = context_expression_get_type(ctx,
+                                                     match_instr->subject);
+    char type_name[512] = "";
+    char message[1024];
+    bool valid = true;
+
+    if (!type_can_be_matched(type)) {
+        error_print(input);
+        fprintf(stderr, "a match subject must be an enumeration, an integer, "
+                        "a natural or a char");
+        if (type) {
+            fprintf(stderr, ", not a '%s'", type_print_ez(type, type_name));
+        }
+        fprintf(stderr, "\n");
+        return false;
+    }
+    type_print_ez(type, type_name);
+
+    /* The values already handled, and for enumerations the handled
+     * members. */
+    vector_t values;
+    vector_init(&values, 0);
+    bool* handled = NULL;
+    if (type->type == TYPE_TYPE_ENUMERATION) {
+        handled = calloc(type->enumeration_type->members.size, sizeof(bool));
+        if (!handled) {
+            fprintf(stderr, "couldn't allocate match members\n");
+            abort();
+        }
+    }
+
+    for (int i = 0; i < match_instr->cases.size; i++) {
+        const match_case_t* match_case = match_instr->cases.elements[i];
+
+        for (int j = 0; j < match_case->values.size; j++) {
+            const expression_t* expr = match_case->values.elements[j];
+            long value;
+
+            if (!case_get_value(type, expr, &value)) {
+                snprintf(message, sizeof(message),
+                         "can't be a case of a match on '%s', its cases "
+                         "must be %s", type_name, case_values_kind(type));
+                case_error(input, ctx, expr, message);
+                valid = false;
+                continue;
+            }
+
+            if (vector_contains(&values, (void*)value, &value_equals)) {
+                snprintf(message, sizeof(message),
+                         "is handled by several cases of a match on '%s'",
+                         type_name);
+                case_error(input, ctx, expr, message);
+                valid = false;
+                continue;
+            }
+            vector_push(&values, (void*)value);
+
+            if (handled) {
+                handled[value] = true;
+            }
+        }
+    }
+
+    if (handled && !match_instr->has_else
+    &&  !match_is_exhaustive(input, type, handled))
+    {
+        valid = false;
+    }
+
+    free(handled);
+    vector_wipe(&values, NULL);
+
+    return valid;
+}
@@ -0,0 +1,905 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include "ez-lang.h"
+
+/* Integer and natural literals are printed as plain C++ int literals, so we
+ * only fold them while every operand and result fits in an int: the folded
+ * program then computes exactly what the generated one would have.
+ *
+ * The natural constants are unsigned ints in C++, their propagated values are
+ * printed with the `u` suffix. An operation on such a value is unsigned in
+ * C++, so it is only folded with other naturals, when it doesn't wrap.
+ */
+
+static bool value_is_literal(const value_t* value) {
+    return value->type != VALUE_TYPE_VALREF
+        && value->type != VALUE_TYPE_EMPTY;
+}
+
+static bool expression_is_literal(const expression_t* expr) {
+    return expr
+        && expr->type == EXPRESSION_TYPE_VALUE
+        && value_is_literal(&expr->value);
+}
+
+static bool expression_is_boolean(const expression_t* expr, bool boolean) {
+    return expression_is_literal(expr)
+        && expr->value.type == VALUE_TYPE_BOOLEAN
+        && expr->value.boolean == boolean;
+}
+
+static bool value_is_number(const value_t* value) {
+    return value->type == VALUE_TYPE_INTEGER
+        || value->type == VALUE_TYPE_NATURAL
+        || value->type == VALUE_TYPE_REAL;
+}
+
+static bool value_is_unsigned(const value_t* value) {
+    return value->type == VALUE_TYPE_NATURAL && value->is_unsigned;
+}
+
+static bool value_get_integer(const value_t* value, long long* integer) {
+    switch (value->type) {
+      case VALUE_TYPE_INTEGER:
+        *integer = value->integer;
+        return true;
+
+      case VALUE_TYPE_NATURAL:
+        *integer = value->natural;
+        return value->natural <= INT_MAX || value->is_unsigned;
+
+      default:
+        return false;
+    }
+}
+
+static double value_get_real(const value_t* value) {
+    switch (value->type) {
+      case VALUE_TYPE_INTEGER:
+        return value->integer;
+
+      case VALUE_TYPE_NATURAL:
+        return value->natural;
+
+      default:
+        return value->real;
+    }
+}
+
+static bool value_is_number_equal_to(const value_t* value, int n) {
+    return value_is_number(value) && value_get_real(value) == n;
+}
+
+/* Set `result` to the integer of type `type` (integer or natural), if it
+ * fits in the C++ int literal used to print it, or in an unsigned int for an
+ * unsigned natural.
+ */
+static bool value_set_integer(value_t* result, value_type_t type,
+                              bool is_unsigned, long long integer)
+{
+    if (is_unsigned ? integer > UINT_MAX
+                    : integer > INT_MAX || integer < INT_MIN)
+    {
+        return false;
+    }
+
+    result->type = type;
+    if (type == VALUE_TYPE_NATURAL) {
+        if (integer < 0) {
+            return false;
+        }
+        result->natural = integer;
+        result->is_unsigned = is_unsigned;
+    } else {
+        result->integer = integer;
+    }
+    return true;
+}
+
+static bool fold_strings(const value_t* left, const value_t* right,
+                         value_t* result)
+{
+    /* Escaped sequences like "\1" or "\x4" would absorb the digits of the
+     * right string once concatenated. */
+    for (const char* c = left->string; *c; c++) {
+        if (*c == '\\' && c[1]) {
+            c++;
+            if ((*c >= '0' && *c <= '7') || *c == 'x') {
+                return false;
+            }
+        }
+    }
+
+    size_t left_length = strlen(left->string);
+    size_t right_length = strlen(right->string);
+
+    result->type = VALUE_TYPE_STRING;
+    result->string = malloc(left_length + right_length + 1);
+    if (!result->string) {
+        fprintf(stderr, "couldn't allocate folded string\n");
+        return false;
+    }
+    memcpy(result->string, left->string, left_length);
+    memcpy(result->string + left_length, right->string, right_length + 1);
+    return true;
+}
+
+static bool fold_arithmetic(expression_type_t op,
+                            const value_t* left, const value_t* right,
+                            value_t* result)
+{
+    if (left->type == VALUE_TYPE_STRING && right->type == VALUE_TYPE_STRING) {
+        return op == EXPRESSION_TYPE_ARITHMETIC_OP_PLUS
+            && fold_strings(left, right, result);
+    }
+
+    if (!value_is_number(left) || !value_is_number(right)) {
+        return false;
+    }
+
+    if (left->type == VALUE_TYPE_REAL || right->type == VALUE_TYPE_REAL) {
+        double a = value_get_real(left);
+        double b = value_get_real(right);
+
+        switch (op) {
+          case EXPRESSION_TYPE_ARITHMETIC_OP_PLUS:  result->real = a + b; break;
+          case EXPRESSION_TYPE_ARITHMETIC_OP_MINUS: result->real = a - b; break;
+          case EXPRESSION_TYPE_ARITHMETIC_OP_MUL:   result->real = a * b; break;
+          case EXPRESSION_TYPE_ARITHMETIC_OP_DIV:
+            if (b == 0) {
+                return false;
+            }
+            result->real = a / b;
+            break;
+
+          default:
+            return false;
+        }
+
+        result->type = VALUE_TYPE_REAL;
+        return isfinite(result->real);
+    }
+
+    long long a, b;
+    if (!value_get_integer(left, &a) || !value_get_integer(right, &b)) {
+        return false;
+    }
+
+    value_type_t type = VALUE_TYPE_NATURAL;
+    if (left->type == VALUE_TYPE_INTEGER || right->type == VALUE_TYPE_INTEGER) {
+        type = VALUE_TYPE_INTEGER;
+    }
+
+    /* Without negative operands, the unsigned C++ operation computes the
+     * exact result as long as it doesn't wrap. */
+    bool is_unsigned = value_is_unsigned(left) || value_is_unsigned(right);
+    if (is_unsigned && type == VALUE_TYPE_INTEGER) {
+        return false;
+    }
+
+    switch (op) {
+      case EXPRESSION_TYPE_ARITHMETIC_OP_PLUS:
+        return value_set_integer(result, type, is_unsigned, a + b);
+
+      case EXPRESSION_TYPE_ARITHMETIC_OP_MINUS:
+        return value_set_integer(result, type, is_unsigned, a - b);
+
+      case EXPRESSION_TYPE_ARITHMETIC_OP_MUL:
+        return value_set_integer(result, type, is_unsigned, a * b);
+
+      case EXPRESSION_TYPE_ARITHMETIC_OP_DIV:
+        return b != 0 && value_set_integer(result, type, is_unsigned, a / b);
+
+      case EXPRESSION_TYPE_ARITHMETIC_OP_MOD:
+        return b != 0 && value_set_integer(result, type, is_unsigned, a % b);
+
+      default:
+        return false;
+    }
+}
+
+static bool compare(expression_type_t op, int cmp, bool* result) {
+    switch (op) {
+      case EXPRESSION_TYPE_CMP_OP_EQUALS:            *result = cmp == 0; break;
+      case EXPRESSION_TYPE_CMP_OP_DIFFERENT:         *result = cmp != 0; break;
+      case EXPRESSION_TYPE_CMP_OP_LOWER_OR_EQUALS:   *result = cmp <= 0; break;
+      case EXPRESSION_TYPE_CMP_OP_GREATER_OR_EQUALS: *result = cmp >= 0; break;
+      case EXPRESSION_TYPE_CMP_OP_LOWER:             *result = cmp < 0;  break;
+      case EXPRESSION_TYPE_CMP_OP_GREATER:           *result = cmp > 0;  break;
+      default:
+        return false;
+    }
+    return true;
+}
+
+static bool fold_comparison(expression_type_t op,
+                            const value_t* left, const value_t* right,
+                            value_t* result)
+{
+    int cmp = 0;
+
+    if (value_is_number(left) && value_is_number(right)) {
+        long long a, b;
+        if (value_get_integer(left, &a) && value_get_integer(right, &b)) {
+            /* C++ converts a negative integer compared to an unsigned. */
+            if ((value_is_unsigned(left) || value_is_unsigned(right))
+            &&  (a < 0 || b < 0))
+            {
+                return false;
+            }
+            cmp = (a > b) - (a < b);
+        } else
+        if (left->type == VALUE_TYPE_REAL || right->type == VALUE_TYPE_REAL) {
+            double x = value_get_real(left);
+            double y = value_get_real(right);
+            if (isnan(x) || isnan(y)) {
+                return false;
+            }
+            cmp = (x > y) - (x < y);
+        } else {
+            return false;
+        }
+    } else
+    if ((left->type == VALUE_TYPE_BOOLEAN && right->type == VALUE_TYPE_BOOLEAN)
+    ||  (left->type == VALUE_TYPE_CHAR && right->type == VALUE_TYPE_CHAR))
+    {
+        /* Only equality is defined on booleans and characters. */
+        if (op != EXPRESSION_TYPE_CMP_OP_EQUALS
+        &&  op != EXPRESSION_TYPE_CMP_OP_DIFFERENT) {
+            return false;
+        }
+        if (left->type == VALUE_TYPE_BOOLEAN) {
+            cmp = left->boolean != right->boolean;
+        } else {
+            cmp = left->character != right->character;
+        }
+    } else {
+        /* String literals are compared as pointers in C++: never fold them. */
+        return false;
+    }
+
+    result->type = VALUE_TYPE_BOOLEAN;
+    return compare(op, cmp, &result->boolean);
+}
+
+/* An expression is pure if evaluating it has no side effect, so it could be
+ * dropped. Any function call is considered impure.
+ */
+static bool valref_is_pure(const valref_t* valref) {
+    for (; valref; valref = valref->next) {
+        if (valref->is_funccall) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool expression_is_pure(const expression_t* expr) {
+    if (!expr) {
+        return true;
+    }
+
+    switch (expr->type) {
+      case EXPRESSION_TYPE_VALUE:
+        return expr->value.type != VALUE_TYPE_VALREF
+            || valref_is_pure(expr->value.valref);
+
+      case EXPRESSION_TYPE_LAMBDA:
+        return true;
+
+      default:
+        return expression_is_pure(expr->left)
+            && expression_is_pure(expr->right);
+    }
+}
+
+/* Replace `*expr` by the given value. */
+static void expression_replace_by_value(expression_t** expr,
+                                        const value_t* value)
+{
+    expression_t* folded = expression_new(EXPRESSION_TYPE_VALUE);
+    folded->value = *value;
+    expression_delete(*expr);
+    *expr = folded;
+}
+
+/* Replace `*expr` by its child `*child`. */
+static void expression_replace_by_child(expression_t** expr,
+                                        expression_t** child)
+{
+    expression_t* kept = *child;
+    *child = NULL;
+    expression_delete(*expr);
+    *expr = kept;
+}
+
+/* `x + 0`, `x * 1` ... are replaced by `x` only if `x` has the type of the
+ * whole operation, so the generated code keeps the same C++ types.
+ */
+static bool is_identity(const context_t* ctx, const expression_t* expr,
+                        const expression_t* operand, const value_t* literal,
+                        bool operand_is_left)
+{
+    const type_t* type = context_expression_get_type(ctx, expr);
+    const type_t* operand_type = context_expression_get_type(ctx, operand);
+    if (!type || !operand_type || !types_are_equals(type, operand_type)) {
+        return false;
+    }
+
+    /* An integer and an unsigned natural make an unsigned in C++. */
+    if (value_is_unsigned(literal) && type->type == TYPE_TYPE_INTEGER) {
+        return false;
+    }
+
+    switch (expr->type) {
+      case EXPRESSION_TYPE_ARITHMETIC_OP_PLUS:
+        if (type->type == TYPE_TYPE_STRING) {
+            return literal->type == VALUE_TYPE_STRING
+                && literal->string[0] == '\0';
+        }
+        /* -0.0 + 0.0 is 0.0 */
+        return type->type != TYPE_TYPE_REAL
+            && value_is_number_equal_to(literal, 0);
+
+      case EXPRESSION_TYPE_ARITHMETIC_OP_MINUS:
+        return operand_is_left && value_is_number_equal_to(literal, 0);
+
+      case EXPRESSION_TYPE_ARITHMETIC_OP_MUL:
+        return value_is_number_equal_to(literal, 1);
+
+      case EXPRESSION_TYPE_ARITHMETIC_OP_DIV:
+        return operand_is_left && value_is_number_equal_to(literal, 1);
+
+      default:
+        return false;
+    }
+}
+
+static void optimize_expression(const context_t* ctx, expression_t** expr);
+
+static void optimize_parameters(const context_t* ctx, parameters_t* params) {
+    for (int i = 0; i < params->parameters.size; i++) {
+        optimize_expression(ctx,
+                            (expression_t**)&params->parameters.elements[i]);
+    }
+}
+
+static void optimize_valref(const context_t* ctx, valref_t* valref) {
+    for (; valref; valref = valref->next) {
+        optimize_parameters(ctx, &valref->parameters);
+    }
+}
+
+/* Convert the literal `value` of a constant to its declared type. */
+static bool value_convert(const value_t* value, const type_t* type,
+                          value_t* result)
+{
+    long long integer;
+
+    switch (type->type) {
+      case TYPE_TYPE_INTEGER:
+      case TYPE_TYPE_NATURAL:
+        if (value->type == VALUE_TYPE_REAL) {
+            if (!(value->real > LLONG_MIN && value->real < LLONG_MAX)) {
+                return false;
+            }
+            integer = (long long)value->real;
+        } else
+        if (!value_get_integer(value, &integer)) {
+            return false;
+        }
+        if (type->type == TYPE_TYPE_INTEGER) {
+            return value_set_integer(result, VALUE_TYPE_INTEGER, false,
+                                     integer);
+        }
+        return value_set_integer(result, VALUE_TYPE_NATURAL, true, integer);
+
+      case TYPE_TYPE_REAL:
+        if (!value_is_number(value)) {
+            return false;
+        }
+        result->type = VALUE_TYPE_REAL;
+        result->real = value_get_real(value);
+        return true;
+
+      case TYPE_TYPE_BOOLEAN:
+      case TYPE_TYPE_CHAR:
+        *result = *value;
+        return true;
+
+      case TYPE_TYPE_STRING:
+        if (value->type != VALUE_TYPE_STRING) {
+            return false;
+        }
+        result->type = VALUE_TYPE_STRING;
+        result->string = strdup(value->string);
+        return result->string != NULL;
+
+      default:
+        return false;
+    }
+}
+
+/* Returns the constant referenced by `valref`, if it isn't shadowed by an
+ * argument or a local of the current function.
+ */
+static const constant_t* valref_find_constant(const context_t* ctx,
+                                              const valref_t* valref)
+{
+    if (valref->next || valref->is_funccall) {
+        return NULL;
+    }
+
+    if (ctx->function
+    && (function_has_arg(ctx->function, &valref->identifier)
+    ||  function_has_local(ctx->function, &valref->identifier)))
+    {
+        return NULL;
+    }
+
+    return program_find_constant(ctx->program, &valref->identifier);
+}
+
+static void optimize_value(const context_t* ctx, expression_t** expr) {
+    value_t* value = &(*expr)->value;
+
+    if (value->type != VALUE_TYPE_VALREF) {
+        return;
+    }
+
+    const constant_t* constant = valref_find_constant(ctx, value->valref);
+    value_t folded;
+    if (constant
+    &&  expression_is_literal(constant->value)
+    &&  value_convert(&constant->value->value, constant->symbol->is, &folded))
+    {
+        expression_replace_by_value(expr, &folded);
+        return;
+    }
+
+    optimize_valref(ctx, value->valref);
+}
+
+static void optimize_lambda(const context_t* ctx, function_t* lambda);
+
+static void optimize_expression(const context_t* ctx, expression_t** expr) {
+    expression_t* e = *expr;
+    value_t folded;
+
+    if (!e) {
+        return;
+    }
+
+    if (e->type == EXPRESSION_TYPE_VALUE) {
+        optimize_value(ctx, expr);
+        return;
+    }
+
+    if (e->type == EXPRESSION_TYPE_LAMBDA) {
+        optimize_lambda(ctx, e->lambda);
+        return;
+    }
+
+    optimize_expression(ctx, &e->left);
+    optimize_expression(ctx, &e->right);
+
+    bool left_literal = expression_is_literal(e->left);
+    bool right_literal = expression_is_literal(e->right);
+
+    switch (e->type) {
+      case EXPRESSION_TYPE_BOOL_OP_NOT:
+        if (right_literal && e->right->value.type == VALUE_TYPE_BOOLEAN) {
+            folded.type = VALUE_TYPE_BOOLEAN;
+            folded.boolean = !e->right->value.boolean;
+            expression_replace_by_value(expr, &folded);
+        } else
+        if (e->right->type == EXPRESSION_TYPE_BOOL_OP_NOT) {
+            expression_replace_by_child(expr, &e->right->right);
+        }
+        break;
+
+      case EXPRESSION_TYPE_BOOL_OP_AND:
+      case EXPRESSION_TYPE_BOOL_OP_OR: {
+        /* `and` and `or` are short-circuited: the left operand decides if the
+         * right one is evaluated. */
+        bool absorbing = (e->type == EXPRESSION_TYPE_BOOL_OP_OR);
+
+        if (expression_is_boolean(e->left, absorbing)) {
+            expression_replace_by_child(expr, &e->left);
+        } else
+        if (expression_is_boolean(e->left, !absorbing)) {
+            expression_replace_by_child(expr, &e->right);
+        } else
+        if (expression_is_boolean(e->right, !absorbing)) {
+            expression_replace_by_child(expr, &e->left);
+        } else
+        if (expression_is_boolean(e->right, absorbing)
+        &&  expression_is_pure(e->left)) {
+            expression_replace_by_child(expr, &e->right);
+        }
+        break;
+      }
+
+      case EXPRESSION_TYPE_CMP_OP_EQUALS:
+      case EXPRESSION_TYPE_CMP_OP_DIFFERENT:
+      case EXPRESSION_TYPE_CMP_OP_LOWER_OR_EQUALS:
+      case EXPRESSION_TYPE_CMP_OP_GREATER_OR_EQUALS:
+      case EXPRESSION_TYPE_CMP_OP_LOWER:
+      case EXPRESSION_TYPE_CMP_OP_GREATER:
+        if (left_literal && right_literal
+        &&  fold_comparison(e->type, &e->left->value, &e->right->value,
+                            &folded))
+        {
+            expression_replace_by_value(expr, &folded);
+        }
+        break;
+
+      default:
+        if (left_literal && right_literal) {
+            if (fold_arithmetic(e->type, &e->left->value, &e->right->value,
+                                &folded))
+            {
+                expression_replace_by_value(expr, &folded);
+            }
+        } else
+        if (right_literal
+        &&  is_identity(ctx, e, e->left, &e->right->value, true))
+        {
+            expression_replace_by_child(expr, &e->left);
+        } else
+        if (left_literal
+        &&  is_identity(ctx, e, e->right, &e->left->value, false))
+        {
+            expression_replace_by_child(expr, &e->right);
+        }
+        break;
+    }
+}
+
+static void optimize_instructions(const context_t* ctx, vector_t* instrs);
+
+/* Move all instructions of `from` at the end of `to`. */
+static void instructions_splice(vector_t* to, vector_t* from) {
+    for (int i = 0; i < from->size; i++) {
+        vector_push(to, from->elements[i]);
+    }
+    from->size = 0;
+}
+
+static void optimize_if(const context_t* ctx, instruction_t* instr,
+                        vector_t* output)
+{
+    if_instr_t* if_instr = instr->flowcontrol.if_instr;
+
+    optimize_expression(ctx, &if_instr->coundition);
+    optimize_instructions(ctx, &if_instr->instructions);
+    for (int i = 0; i < if_instr->elsifs.size; i++) {
+        elsif_instr_t* elsif = if_instr->elsifs.elements[i];
+        optimize_expression(ctx, &elsif->coundition);
+        optimize_instructions(ctx, &elsif->instructions);
+    }
+    optimize_instructions(ctx, &if_instr->else_instrs);
+
+    /* Drop the `elsif` that are never taken, and everything following an
+     * `elsif` that is always taken (it becomes the `else` part). */
+    for (int i = 0; i < if_instr->elsifs.size;) {
+        elsif_instr_t* elsif = if_instr->elsifs.elements[i];
+
+        if (expression_is_boolean(elsif->coundition, false)) {
+            elsif_instr_delete(elsif);
+            vector_remove(&if_instr->elsifs, i);
+        } else
+        if (expression_is_boolean(elsif->coundition, true)) {
+            vector_wipe(&if_instr->else_instrs,
+                        (delete_func_t)&instruction_delete);
+            vector_init(&if_instr->else_instrs, 0);
+            instructions_splice(&if_instr->else_instrs, &elsif->instructions);
+
+            while (if_instr->elsifs.size > i) {
+                elsif_instr_delete(vector_get(&if_instr->elsifs,
+                                              if_instr->elsifs.size - 1));
+                vector_pop(&if_instr->elsifs);
+            }
+        } else {
+            i++;
+        }
+    }
+
+    /* A `if` never taken is replaced by its first `elsif`. */
+    while (expression_is_boolean(if_instr->coundition, false)
+       &&  if_instr->elsifs.size > 0)
+    {
+        elsif_instr_t* elsif = if_instr->elsifs.elements[0];
+
+        expression_delete(if_instr->coundition);
+        if_instr->coundition = elsif->coundition;
+        elsif->coundition = NULL;
+
+        vector_wipe(&if_instr->instructions,
+                    (delete_func_t)&instruction_delete);
+        vector_init(&if_instr->instructions, 0);
+        instructions_splice(&if_instr->instructions, &elsif->instructions);
+
+        elsif_instr_delete(elsif);
+        vector_remove(&if_instr->elsifs, 0);
+    }
+
+    if (expression_is_boolean(if_instr->coundition, true)) {
+        instructions_splice(output, &if_instr->instructions);
+        instruction_delete(instr);
+    } else
+    if (expression_is_boolean(if_instr->coundition, false)) {
+        instructions_splice(output, &if_instr->else_instrs);
+        instruction_delete(instr);
+    } else {
+        vector_push(output, instr);
+    }
+}
+
+static void optimize_on(const context_t* ctx, instruction_t* instr,
+                        vector_t* output)
+{
+    on_instr_t* on_instr = instr->flowcontrol.on_instr;
+    vector_t instructions;
+
+    optimize_expression(ctx, &on_instr->coundition);
+
+    vector_init(&instructions, 1);
+    vector_push(&instructions, on_instr->instruction);
+    on_instr->instruction = NULL;
+    optimize_instructions(ctx, &instructions);
+
+    if (expression_is_boolean(on_instr->coundition, true)) {
+        instructions_splice(output, &instructions);
+        instruction_delete(instr);
+    } else
+    if (expression_is_boolean(on_instr->coundition, false)) {
+        vector_wipe(&instructions, (delete_func_t)&instruction_delete);
+        instruction_delete(instr);
+        return;
+    } else
+    if (instructions.size == 1) {
+        on_instr->instruction = instructions.elements[0];
+        vector_push(output, instr);
+        instructions.size = 0;
+    } else {
+        /* The instruction has been simplified into zero or several ones, so
+         * the `on` becomes a `if`. */
+        if_instr_t* if_instr = if_instr_new(on_instr->coundition);
+        on_instr->coundition = NULL;
+        instructions_splice(&if_instr->instructions, &instructions);
+        on_instr_delete(on_instr);
+
+        instr->flowcontrol.type = FLOWCONTROL_TYPE_IF;
+        instr->flowcontrol.if_instr = if_instr;
+        vector_push(output, instr);
+    }
+
+    vector_wipe(&instructions, NULL);
+}
+
+static void optimize_flowcontrol(const context_t* ctx, instruction_t* instr,
+                                 vector_t* output)
+{
+    flowcontrol_t* fc = &instr->flowcontrol;
+
+    switch (fc->type) {
+      case FLOWCONTROL_TYPE_IF:
+        optimize_if(ctx, instr, output);
+        return;
+
+      case FLOWCONTROL_TYPE_ON:
+        optimize_on(ctx, instr, output);
+        return;
+
+      case FLOWCONTROL_TYPE_WHILE:
+        optimize_expression(ctx, &fc->while_instr->coundition);
+        if (expression_is_boolean(fc->while_instr->coundition, false)) {
+            instruction_delete(instr);
+            return;
+        }
+        optimize_instructions(ctx, &fc->while_instr->instructions);
+        break;
+
+      case FLOWCONTROL_TYPE_LOOP:
+        optimize_expression(ctx, &fc->loop_instr->coundition);
+        optimize_instructions(ctx, &fc->loop_instr->instructions);
+        /* The body of a loop is executed at least once. */
+        if (expression_is_boolean(fc->loop_instr->coundition, true)) {
+            instructions_splice(output, &fc->loop_instr->instructions);
+            instruction_delete(instr);
+            return;
+        }
+        break;
+
+      case FLOWCONTROL_TYPE_FOR:
+        optimize_expression(ctx, &fc->for_instr->range.from);
+        optimize_expression(ctx, &fc->for_instr->range.to);
+        optimize_instructions(ctx, &fc->for_instr->instructions);
+        break;
+
+      case FLOWCONTROL_TYPE_MATCH:
+        /* The case values are literals, the C++ compiler picks the case of
+         * a constant subject itself. */
+        optimize_expression(ctx, &fc->match_instr->subject);
+        for (int i = 0; i < fc->match_instr->cases.size; i++) {
+            match_case_t* match_case = fc->match_instr->cases.elements[i];
+            optimize_instructions(ctx, &match_case->instructions);
+        }
+        optimize_instructions(ctx, &fc->match_instr->else_instrs);
+        break;
+    }
+
+    vector_push(output, instr);
+}
+
+/* Optimize `instr` and push what remains of it into `output`. */
+static void optimize_instruction(const context_t* ctx, instruction_t* instr,
+                                 vector_t* output)
+{
+    switch (instr->type) {
+      case INSTRUCTION_TYPE_PRINT:
+        optimize_parameters(ctx, &instr->parameters);
+        break;
+
+      case INSTRUCTION_TYPE_READ:
+        optimize_valref(ctx, instr->valref);
+        break;
+
+      case INSTRUCTION_TYPE_RETURN:
+      case INSTRUCTION_TYPE_EXPRESSION:
+        optimize_expression(ctx, &instr->expression);
+        break;
+
+      case INSTRUCTION_TYPE_AFFECTATION:
+        optimize_valref(ctx, instr->affectation.lvalue);
+        optimize_expression(ctx, &instr->affectation.expression);
+        break;
+
+      case INSTRUCTION_TYPE_FLOWCONTROL:
+        optimize_flowcontrol(ctx, instr, output);
+        return;
+    }
+
+    vector_push(output, instr);
+}
+
+static void optimize_instructions(const context_t* ctx, vector_t* instrs) {
+    vector_t optimized;
+
+    vector_init(&optimized, instrs->size);
+    for (int i = 0; i < instrs->size; i++) {
+        optimize_instruction(ctx, instrs->elements[i], &optimized);
+    }
+
+    vector_wipe(instrs, NULL);
+    *instrs = optimized;
+}
+
+static void optimize_function(const context_t* ctx, function_t* function) {
+    context_t function_ctx = *ctx;
+    function_ctx.function = function;
+
+    optimize_instructions(&function_ctx, &function->instructions);
+}
+
+static void optimize_lambda(const context_t* ctx, function_t* lambda) {
+    /* A lambda only sees its own arguments and the program globals. */
+    optimize_function(ctx, lambda);
+}
+
+bool expression_evaluate(const context_t* ctx, const expression_t* expr,
+                         value_t* result)
+{
+    value_t left;
+    value_t right;
+    bool evaluated;
+
+    if (!expr || expr->type == EXPRESSION_TYPE_LAMBDA) {
+        return false;
+    }
+
+    if (expr->type == EXPRESSION_TYPE_VALUE) {
+        const value_t* value = &expr->value;
+
+        if (value->type == VALUE_TYPE_VALREF) {
+            const constant_t* constant =
+                valref_find_constant(ctx, value->valref);
+            /* The constants only see the other constants. */
+            const context_t global = (context_t){
+                .program = ctx->program,
+                .function = NULL
+            };
+            if (!constant
+            ||  !expression_evaluate(&global, constant->value, &left))
+            {
+                return false;
+            }
+            evaluated = value_convert(&left, constant->symbol->is, result);
+            value_wipe(&left);
+            return evaluated;
+        }
+
+        if (!value_is_literal(value)) {
+            return false;
+        }
+        *result = *value;
+        if (value->type == VALUE_TYPE_STRING) {
+            result->string = strdup(value->string);
+            return result->string != NULL;
+        }
+        return true;
+    }
+
+    if (expr->type == EXPRESSION_TYPE_BOOL_OP_NOT) {
+        if (!expression_evaluate(ctx, expr->right, &right)) {
+            return false;
+        }
+        evaluated = (right.type == VALUE_TYPE_BOOLEAN);
+        result->type = VALUE_TYPE_BOOLEAN;
+        result->boolean = !right.boolean;
+        value_wipe(&right);
+        return evaluated;
+    }
+
+    if (!expression_evaluate(ctx, expr->left, &left)) {
+        return false;
+    }
+    if (!expression_evaluate(ctx, expr->right, &right)) {
+        value_wipe(&left);
+        return false;
+    }
+
+    switch (expr->type) {
+      case EXPRESSION_TYPE_BOOL_OP_AND:
+      case EXPRESSION_TYPE_BOOL_OP_OR:
+        evaluated = left.type == VALUE_TYPE_BOOLEAN
+                 && right.type == VALUE_TYPE_BOOLEAN;
+        result->type = VALUE_TYPE_BOOLEAN;
+        result->boolean = (expr->type == EXPRESSION_TYPE_BOOL_OP_AND)
+                        ? left.boolean && right.boolean
+                        : left.boolean || right.boolean;
+        break;
+
+      case EXPRESSION_TYPE_CMP_OP_EQUALS:
+      case EXPRESSION_TYPE_CMP_OP_DIFFERENT:
+      case EXPRESSION_TYPE_CMP_OP_LOWER_OR_EQUALS:
+      case EXPRESSION_TYPE_CMP_OP_GREATER_OR_EQUALS:
+      case EXPRESSION_TYPE_CMP_OP_LOWER:
+      case EXPRESSION_TYPE_CMP_OP_GREATER:
+        evaluated = fold_comparison(expr->type, &left, &right, result);
+        break;
+
+      default:
+        evaluated = fold_arithmetic(expr->type, &left, &right, result);
+        break;
+    }
+
+    value_wipe(&left);
+    value_wipe(&right);
+    return evaluated;
+}
+
+void program_optimize(program_t* prg) {
+    const context_t ctx = (context_t){
+        .program = prg,
+        .function = NULL
+    };
+
+    /* Constants are folded in declaration order, so they can be propagated
+     * into the following ones. */
+    for (int i = 0; i < prg->constants.size; i++) {
+        constant_t* constant = prg->constants.elements[i];
+        optimize_expression(&ctx, &constant->value);
+    }
+
+    for (int i = 0; i < prg->functions.size; i++) {
+        optimize_function(&ctx, prg->functions.elements[i]);
+    }
+    for (int i = 0; i < prg->procedures.size; i++) {
+        optimize_function(&ctx, prg->procedures.elements[i]);
+    }
+}
@@ -0,0 +1,790 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ez-lang.h"
+#include "ez-lang-errors.h"
+
+/* Sharing of the variables between the iterations of a `parallel for`.
+ *
+ * The body is walked once, recording how each variable is used. A whole
+ * assignment to a local makes it private to the iteration if it is always
+ * done before the local is used: the assigned locals are tracked along the
+ * body, an `if` only assigns what all its branches assign, and loops that
+ * may not run assign nothing. The local must also be assigned on every path
+ * of the body, the last chunk giving its value after the loop.
+ *
+ * The calls to program functions are trusted not to write the globals, only
+ * their `out` and `inout` arguments are considered. The body can't print or
+ * read, even through the functions and lambdas it calls; the functions held
+ * by variables are trusted not to.
+ */
+
+typedef enum {
+    USE_READ,               /* any other read */
+    USE_READ_OWN,           /* `v[i]` or `v.size()`, `i` being the subject */
+    USE_ASSIGN,             /* `x = e`, `read x`, `out` argument */
+    USE_ACCUMULATE,         /* `x = x + e`... */
+    USE_WRITE_OWN,          /* `v[i] = e`, `v[i].push(e)`... */
+    USE_WRITE,              /* a member, another element, a method */
+    USE_WRITE_CALL,         /* `inout` argument */
+    USE_NKINDS,
+} use_t;
+
+typedef struct parallel_variable {
+    const identifier_t* id;
+    bool                uses[USE_NKINDS];
+
+    /* Used before being assigned in an iteration. */
+    bool                is_exposed;
+
+    /* Assigned on every path of an iteration. */
+    bool                is_always_assigned;
+
+    expression_type_t   accumulation;
+    bool                has_mixed_accumulations;
+
+    /* The function given the variable as an `inout` argument. */
+    const identifier_t* callee;
+} parallel_variable_t;
+
+typedef struct parallel_walk {
+    const context_t*    ctx;
+    const for_instr_t*  loop;
+
+    vector_t    variables;  /* of parallel_variable_t* */
+    vector_t    assigned;   /* of const identifier_t* */
+
+    /* The accumulated variable while its accumulation is walked. */
+    const identifier_t* accumulating;
+
+    bool        has_return;
+} parallel_walk_t;
+
+static bool identifier_equals(const identifier_t* a, const identifier_t* b) {
+    return strcmp(a->value, b->value) == 0;
+}
+
+static bool is_plain(const valref_t* valref) {
+    return !valref->next && !valref->is_funccall;
+}
+
+static bool expression_is_variable(const expression_t* expr,
+                                   const identifier_t* id)
+{
+    return expr->type == EXPRESSION_TYPE_VALUE
+        && expr->value.type == VALUE_TYPE_VALREF
+        && is_plain(expr->value.valref)
+        && identifier_equals(&expr->value.valref->identifier, id);
+}
+
+static bool is_local(const parallel_walk_t* w, const identifier_t* id) {
+    return !function_has_arg(w->ctx->function, id)
+        &&  function_has_local(w->ctx->function, id);
+}
+
+/* `v[i]...`, `i` being the loop subject. */
+static bool is_own_element(const parallel_walk_t* w, const valref_t* valref) {
+    const valref_t* at = valref->next;
+
+    return at && at->is_funccall
+        && strcmp(at->identifier.value, "at") == 0
+        && at->parameters.parameters.size == 1
+        && expression_is_variable(at->parameters.parameters.elements[0],
+                                  &w->loop->subject);
+}
+
+/* ------------------------------ variables -------------------------------- */
+
+static parallel_variable_t* find_variable(const parallel_walk_t* w,
+                                          const identifier_t* id)
+{
+    for (int i = 0; i < w->variables.size; i++) {
+        parallel_variable_t* var = w->variables.elements[i];
+        if (identifier_equals(var->id, id)) {
+            return var;
+        }
+    }
+    return NULL;
+}
+
+static bool is_assigned(const vector_t* assigned, const identifier_t* id) {
+    return vector_contains(assigned, id, (cmp_func_t)&identifier_equals);
+}
+
+static parallel_variable_t* use(parallel_walk_t* w, const identifier_t* id,
+                                use_t kind)
+{
+    if (w->accumulating && identifier_equals(w->accumulating, id)
+    &&  kind == USE_READ)
+    {
+        return NULL;
+    }
+
+    if (!context_find_identifier_type(w->ctx, id)
+    ||  program_has_constant(w->ctx->program, id)
+    ||  program_find_enumeration_member(w->ctx->program, id))
+    {
+        return NULL;
+    }
+
+    parallel_variable_t* var = find_variable(w, id);
+    if (!var) {
+        var = calloc(1, sizeof(parallel_variable_t));
+        if (!var) {
+            fprintf(stderr, "couldn't allocate parallel variable\n");
+            abort();
+        }
+        var->id = id;
+        vector_push(&w->variables, var);
+    }
+
+    var->uses[kind] = true;
+    if (kind != USE_ASSIGN && !is_assigned(&w->assigned, id)) {
+        var->is_exposed = true;
+    }
+    return var;
+}
+
+static void assign(parallel_walk_t* w, const identifier_t* id) {
+    if (!is_assigned(&w->assigned, id)) {
+        vector_push(&w->assigned, (void*)id);
+    }
+}
+
+static void assigned_copy(vector_t* copy, const vector_t* assigned) {
+    vector_init(copy, assigned->size);
+    for (int i = 0; i < assigned->size; i++) {
+        vector_push(copy, assigned->elements[i]);
+    }
+}
+
+/* Keep in `assigned` the identifiers also in `other`. */
+static void assigned_intersect(vector_t* assigned, const vector_t* other) {
+    for (int i = 0; i < assigned->size; ) {
+        if (is_assigned(other, assigned->elements[i])) {
+            i++;
+        } else {
+            vector_remove(assigned, i);
+        }
+    }
+}
+
+/* ------------------------------ accumulations ---------------------------- */
+
+static bool accumulation_is_valid(const type_t* type, expression_type_t op) {
+    switch (op) {
+      case EXPRESSION_TYPE_ARITHMETIC_OP_PLUS:
+        return types_are_equals(type, type_string)
+            || types_are_equals(type, type_real)
+            || types_are_equals(type, type_integer)
+            || types_are_equals(type, type_natural);
+
+      case EXPRESSION_TYPE_ARITHMETIC_OP_MUL:
+        return types_are_equals(type, type_real)
+            || types_are_equals(type, type_integer)
+            || types_are_equals(type, type_natural);
+
+      case EXPRESSION_TYPE_BOOL_OP_AND:
+      case EXPRESSION_TYPE_BOOL_OP_OR:
+        return types_are_equals(type, type_boolean);
+
+      default:
+        return false;
+    }
+}
+
+static int count_expression(const expression_t* expr, const identifier_t* id);
+
+static int count_valref(const valref_t* valref, const identifier_t* id) {
+    int count = identifier_equals(&valref->identifier, id);
+
+    for (; valref; valref = valref->next) {
+        const vector_t* params = &valref->parameters.parameters;
+        for (int i = 0; i < params->size; i++) {
+            count += count_expression(params->elements[i], id);
+        }
+    }
+    return count;
+}
+
+static int count_expression(const expression_t* expr, const identifier_t* id)
+{
+    if (!expr || expr->type == EXPRESSION_TYPE_LAMBDA) {
+        return 0;
+    }
+
+    if (expr->type == EXPRESSION_TYPE_VALUE) {
+        return expr->value.type == VALUE_TYPE_VALREF
+             ? count_valref(expr->value.valref, id)
+             : 0;
+    }
+
+    return count_expression(expr->left, id)
+         + count_expression(expr->right, id);
+}
+
+/* Whether `id` is an operand of the `op` operations at the top of `expr`,
+ * its first one if `first` is true. */
+static bool is_operand(const expression_t* expr, expression_type_t op,
+                       const identifier_t* id, bool first)
+{
+    if (expr->type != op) {
+        return expression_is_variable(expr, id);
+    }
+
+    return is_operand(expr->left, op, id, first)
+        || (!first && is_operand(expr->right, op, id, first));
+}
+
+/* `x = x op e`, `x` appearing nowhere else; the strings are only appended
+ * to, their concatenation not being commutative. */
+static bool affectation_is_accumulation(const parallel_walk_t* w,
+                                        const affectation_instr_t* aff)
+{
+    const valref_t* lvalue = aff->lvalue;
+    const expression_t* expr = aff->expression;
+
+    if (!is_plain(lvalue)) {
+        return false;
+    }
+
+    const type_t* type = context_find_identifier_type(w->ctx,
+                                                      &lvalue->identifier);
+    return type
+        && accumulation_is_valid(type, expr->type)
+        && count_expression(expr, &lvalue->identifier) == 1
+        && is_operand(expr, expr->type, &lvalue->identifier,
+                      types_are_equals(type, type_string));
+}
+
+/* ------------------------------ walk ------------------------------------- */
+
+static void walk_expression(parallel_walk_t* w, const expression_t* expr);
+
+static void walk_parameters(parallel_walk_t* w, const valref_t* valref) {
+    const vector_t* params = &valref->parameters.parameters;
+    for (int i = 0; i < params->size; i++) {
+        walk_expression(w, params->elements[i]);
+    }
+}
+
+/* A value written as a whole by `whole` (an assignment or a call), or in
+ * part. */
+static void walk_target(parallel_walk_t* w, const valref_t* target,
+                        use_t whole, const identifier_t* callee)
+{
+    for (const valref_t* it = target; it; it = it->next) {
+        walk_parameters(w, it);
+    }
+
+    if (is_plain(target)) {
+        parallel_variable_t* var = use(w, &target->identifier, whole);
+        if (var && whole == USE_WRITE_CALL && !var->callee) {
+            var->callee = callee;
+        }
+        if (whole == USE_ASSIGN) {
+            assign(w, &target->identifier);
+        }
+    } else {
+        use(w, &target->identifier,
+            is_own_element(w, target) ? USE_WRITE_OWN : USE_WRITE);
+    }
+}
+
+static access_type_t argument_access(const parallel_walk_t* w,
+                                     const identifier_t* callee, int index)
+{
+    function_t* func = program_find_function(w->ctx->program, callee);
+    if (!func) {
+        func = program_find_procedure(w->ctx->program, callee);
+    }
+    if (func) {
+        if (index < func->args.size) {
+            const function_arg_t* arg = func->args.elements[index];
+            return arg->access_type;
+        }
+        return ACCESS_TYPE_INPUT;
+    }
+
+    const function_signature_t* lambda =
+        context_find_lambda_function(w->ctx, callee);
+    if (lambda && index < lambda->args_access.size) {
+        return (access_type_t)lambda->args_access.elements[index];
+    }
+    return ACCESS_TYPE_INPUT;
+}
+
+/* The variable given as an argument, if any. */
+static const valref_t* expression_valref(const expression_t* expr) {
+    if (expr->type == EXPRESSION_TYPE_VALUE
+    &&  expr->value.type == VALUE_TYPE_VALREF
+    &&  !expr->value.valref->is_funccall)
+    {
+        return expr->value.valref;
+    }
+    return NULL;
+}
+
+static void walk_call(parallel_walk_t* w, const valref_t* call) {
+    const vector_t* params = &call->parameters.parameters;
+
+    /* A lambda variable is read to be called. */
+    use(w, &call->identifier, USE_READ);
+
+    for (int i = 0; i < params->size; i++) {
+        const expression_t* param = params->elements[i];
+        const valref_t* target = expression_valref(param);
+        access_type_t access = argument_access(w, &call->identifier, i);
+
+        if (target && access == ACCESS_TYPE_OUTPUT) {
+            walk_target(w, target, USE_ASSIGN, &call->identifier);
+        } else
+        if (target && access == ACCESS_TYPE_INPUT_OUTPUT) {
+            walk_target(w, target, USE_WRITE_CALL, &call->identifier);
+        } else {
+            walk_expression(w, param);
+        }
+    }
+}
+
+/* The methods called on a variable, and their parameters. */
+static void walk_methods(parallel_walk_t* w, const valref_t* valref) {
+    const valref_t* writer = NULL;
+
+    for (const valref_t* it = valref->next; it; it = it->next) {
+        if (!it->is_funccall) {
+            continue;
+        }
+        if (!writer && builtin_method_writes_subject(&it->identifier)) {
+            writer = it;
+        }
+
+        const vector_t* params = &it->parameters.parameters;
+        for (int i = 0; i < params->size; i++) {
+            const valref_t* target = expression_valref(params->elements[i]);
+            if (target && builtin_method_writes_parameter(&it->identifier, i))
+            {
+                walk_target(w, target, USE_ASSIGN, &it->identifier);
+            } else {
+                walk_expression(w, params->elements[i]);
+            }
+        }
+    }
+
+    const identifier_t* id = &valref->identifier;
+    const valref_t* method = valref->next;
+    bool own = is_own_element(w, valref)
+            || (method && method->is_funccall && !method->next
+            &&  strcmp(method->identifier.value, "size") == 0);
+
+    if (!writer) {
+        use(w, id, own ? USE_READ_OWN : USE_READ);
+    } else
+    if (writer == method && builtin_method_clears_subject(&writer->identifier))
+    {
+        use(w, id, USE_ASSIGN);
+        assign(w, id);
+    } else {
+        use(w, id, is_own_element(w, valref) ? USE_WRITE_OWN : USE_WRITE);
+    }
+}
+
+static void walk_valref(parallel_walk_t* w, const valref_t* valref) {
+    if (valref->is_funccall) {
+        walk_call(w, valref);
+        for (const valref_t* it = valref->next; it; it = it->next) {
+            walk_parameters(w, it);
+        }
+        return;
+    }
+
+    walk_methods(w, valref);
+}
+
+/* Lambdas can't see the function locals, they are not walked. */
+static void walk_expression(parallel_walk_t* w, const expression_t* expr) {
+    if (!expr || expr->type == EXPRESSION_TYPE_LAMBDA) {
+        return;
+    }
+
+    if (expr->type == EXPRESSION_TYPE_VALUE) {
+        if (expr->value.type == VALUE_TYPE_VALREF) {
+            walk_valref(w, expr->value.valref);
+        }
+        return;
+    }
+
+    walk_expression(w, expr->left);
+    walk_expression(w, expr->right);
+}
+
+static void walk_instructions(parallel_walk_t* w, const vector_t* instrs);
+
+static void walk_instruction(parallel_walk_t* w, const instruction_t* instr);
+
+/* Walk instructions which may not run, assigning nothing. */
+static void walk_maybe(parallel_walk_t* w, const vector_t* instrs,
+                       const instruction_t* instr)
+{
+    vector_t before;
+    assigned_copy(&before, &w->assigned);
+
+    if (instrs) {
+        walk_instructions(w, instrs);
+    } else {
+        walk_instruction(w, instr);
+    }
+
+    vector_wipe(&w->assigned, NULL);
+    w->assigned = before;
+}
+
+/* Walk a branch of an `if` starting from `before`, and keep in `after` what
+ * is assigned after all the branches. */
+static void walk_branch(parallel_walk_t* w, const vector_t* instrs,
+                        const vector_t* before, vector_t* after, bool first)
+{
+    vector_wipe(&w->assigned, NULL);
+    assigned_copy(&w->assigned, before);
+    walk_instructions(w, instrs);
+
+    if (first) {
+        assigned_copy(after, &w->assigned);
+    } else {
+        assigned_intersect(after, &w->assigned);
+    }
+}
+
+static void walk_if(parallel_walk_t* w, const if_instr_t* if_instr) {
+    walk_expression(w, if_instr->coundition);
+    for (int i = 0; i < if_instr->elsifs.size; i++) {
+        const elsif_instr_t* elsif = if_instr->elsifs.elements[i];
+        walk_expression(w, elsif->coundition);
+    }
+
+    vector_t before;
+    vector_t after;
+    assigned_copy(&before, &w->assigned);
+
+    walk_branch(w, &if_instr->instructions, &before, &after, true);
+    for (int i = 0; i < if_instr->elsifs.size; i++) {
+        const elsif_instr_t* elsif = if_instr->elsifs.elements[i];
+        walk_branch(w, &elsif->instructions, &before, &after, false);
+    }
+    walk_branch(w, &if_instr->else_instrs, &before, &after, false);
+
+    vector_wipe(&w->assigned, NULL);
+    vector_wipe(&before, NULL);
+    w->assigned = after;
+}
+
+static void walk_match(parallel_walk_t* w, const match_instr_t* match_instr)
+{
+    walk_expression(w, match_instr->subject);
+
+    vector_t before;
+    vector_t after;
+    assigned_copy(&before, &w->assigned);
+
+    for (int i = 0; i < match_instr->cases.size; i++) {
+        const match_case_t* match_case = match_instr->cases.elements[i];
+        walk_branch(w, &match_case->instructions, &before, &after, i == 0);
+    }
+    walk_branch(w, &match_instr->else_instrs, &before, &after,
+                match_instr->cases.size == 0);
+
+    vector_wipe(&w->assigned, NULL);
+    vector_wipe(&before, NULL);
+    w->assigned = after;
+}
+
+static void walk_flowcontrol(parallel_walk_t* w, const flowcontrol_t* fc) {
+    switch (fc->type) {
+      case FLOWCONTROL_TYPE_IF:
+        walk_if(w, fc->if_instr);
+        break;
+
+      case FLOWCONTROL_TYPE_WHILE:
+        walk_expression(w, fc->while_instr->coundition);
+        walk_maybe(w, &fc->while_instr->instructions, NULL);
+        break;
+
+      case FLOWCONTROL_TYPE_LOOP:
+        walk_instructions(w, &fc->loop_instr->instructions);
+        walk_expression(w, fc->loop_instr->coundition);
+        break;
+
+      case FLOWCONTROL_TYPE_ON:
+        walk_expression(w, fc->on_instr->coundition);
+        walk_maybe(w, NULL, fc->on_instr->instruction);
+        break;
+
+      case FLOWCONTROL_TYPE_FOR:
+        walk_expression(w, fc->for_instr->range.from);
+        walk_expression(w, fc->for_instr->range.to);
+        use(w, &fc->for_instr->subject, USE_ASSIGN);
+        assign(w, &fc->for_instr->subject);
+        walk_maybe(w, &fc->for_instr->instructions, NULL);
+        break;
+
+      case FLOWCONTROL_TYPE_MATCH:
+        walk_match(w, fc->match_instr);
+        break;
+    }
+}
+
+static void walk_affectation(parallel_walk_t* w,
+                             const affectation_instr_t* aff)
+{
+    if (!affectation_is_accumulation(w, aff)) {
+        walk_expression(w, aff->expression);
+        walk_target(w, aff->lvalue, USE_ASSIGN, NULL);
+        return;
+    }
+
+    const identifier_t* id = &aff->lvalue->identifier;
+    const parallel_variable_t* before = find_variable(w, id);
+    bool has_accumulated = before && before->uses[USE_ACCUMULATE];
+
+    w->accumulating = id;
+    walk_expression(w, aff->expression);
+    w->accumulating = NULL;
+
+    parallel_variable_t* var = use(w, id, USE_ACCUMULATE);
+    if (!var) {
+        return;
+    }
+    if (has_accumulated && var->accumulation != aff->expression->type) {
+        var->has_mixed_accumulations = true;
+    }
+    var->accumulation = aff->expression->type;
+}
+
+static void walk_instruction(parallel_walk_t* w, const instruction_t* instr)
+{
+    switch (instr->type) {
+      case INSTRUCTION_TYPE_PRINT:
+        for (int i = 0; i < instr->parameters.parameters.size; i++) {
+            walk_expression(w, instr->parameters.parameters.elements[i]);
+        }
+        break;
+
+      case INSTRUCTION_TYPE_READ:
+        walk_target(w, instr->valref, USE_ASSIGN, NULL);
+        break;
+
+      case INSTRUCTION_TYPE_RETURN:
+        w->has_return = true;
+        walk_expression(w, instr->expression);
+        break;
+
+      case INSTRUCTION_TYPE_EXPRESSION:
+        walk_expression(w, instr->expression);
+        break;
+
+      case INSTRUCTION_TYPE_AFFECTATION:
+        walk_affectation(w, &instr->affectation);
+        break;
+
+      case INSTRUCTION_TYPE_FLOWCONTROL:
+        walk_flowcontrol(w, &instr->flowcontrol);
+        break;
+    }
+}
+
+static void walk_instructions(parallel_walk_t* w, const vector_t* instrs) {
+    for (int i = 0; i < instrs->size; i++) {
+        walk_instruction(w, instrs->elements[i]);
+    }
+}
+
+static void parallel_walk_init(parallel_walk_t* w, const context_t* ctx,
+                               const for_instr_t* for_instr)
+{
+    *w = (parallel_walk_t){
+        .ctx = ctx,
+        .loop = for_instr,
+    };
+    vector_init(&w->variables, 0);
+    vector_init(&w->assigned, 0);
+
+    walk_instructions(w, &for_instr->instructions);
+
+    for (int i = 0; i < w->variables.size; i++) {
+        parallel_variable_t* var = w->variables.elements[i];
+        var->is_always_assigned = is_assigned(&w->assigned, var->id);
+    }
+}
+
+static void parallel_walk_wipe(parallel_walk_t* w) {
+    vector_wipe(&w->variables, &free);
+    vector_wipe(&w->assigned, NULL);
+}
+
+/* ------------------------------ sharing ---------------------------------- */
+
+static bool is_reduction(const parallel_variable_t* var) {
+    for (int kind = 0; kind < USE_NKINDS; kind++) {
+        if (kind != USE_ACCUMULATE && var->uses[kind]) {
+            return false;
+        }
+    }
+    return var->uses[USE_ACCUMULATE] && !var->has_mixed_accumulations;
+}
+
+static bool is_written(const parallel_variable_t* var) {
+    return var->uses[USE_ASSIGN]
+        || var->uses[USE_ACCUMULATE]
+        || var->uses[USE_WRITE_OWN]
+        || var->uses[USE_WRITE]
+        || var->uses[USE_WRITE_CALL];
+}
+
+static bool variable_is_valid(FILE* input, const parallel_walk_t* w,
+                              const parallel_variable_t* var)
+{
+    const char* name = var->id->value;
+    const char* subject = w->loop->subject.value;
+
+    if (identifier_equals(var->id, &w->loop->subject)) {
+        if (is_written(var)) {
+            error_print(input);
+            fprintf(stderr, "the subject '%s' of a parallel for can't be "
+                            "written in its body\n", name);
+            return false;
+        }
+        return true;
+    }
+
+    if (is_reduction(var)) {
+        return true;
+    }
+
+    if (var->uses[USE_ASSIGN]) {
+        if (!is_local(w, var->id)) {
+            error_print(input);
+            fprintf(stderr, "a parallel for can't assign '%s', which is "
+                            "shared by its iterations\n", name);
+            return false;
+        }
+        if (var->is_exposed) {
+            error_print(input);
+            fprintf(stderr, "'%s' is used before being assigned in a "
+                            "parallel for, its value would depend on the "
+                            "other iterations\n", name);
+            return false;
+        }
+        if (!var->is_always_assigned) {
+            error_print(input);
+            fprintf(stderr, "'%s' is only assigned on some paths of a "
+                            "parallel for, its value after it would depend "
+                            "on the iterations\n", name);
+            return false;
+        }
+        return true;
+    }
+
+    if (var->uses[USE_ACCUMULATE]) {
+        error_print(input);
+        fprintf(stderr, "'%s' is accumulated in a parallel for, it can't be "
+                        "used otherwise in it\n", name);
+        return false;
+    }
+
+    if (var->uses[USE_WRITE]) {
+        error_print(input);
+        fprintf(stderr, "'%s' is shared by the iterations of a parallel "
+                        "for, only '%s[%s]' can be written in it\n",
+                name, name, subject);
+        return false;
+    }
+
+    if (var->uses[USE_WRITE_OWN] && var->uses[USE_READ]) {
+        error_print(input);
+        fprintf(stderr, "'%s' is written at index '%s' and read elsewhere in "
+                        "a parallel for\n", name, subject);
+        return false;
+    }
+
+    if (var->uses[USE_WRITE_CALL]) {
+        warning_print(input);
+        fprintf(stderr, "'%s' is given to '%s' in a parallel for, its "
+                        "iterations must write different parts of it\n",
+                name, var->callee->value);
+    }
+    return true;
+}
+
+bool parallel_for_is_valid(FILE* input, const context_t* ctx,
+                           const for_instr_t* for_instr)
+{
+    parallel_walk_t w;
+    bool valid = true;
+
+    parallel_walk_init(&w, ctx, for_instr);
+
+    if (instructions_reach_io(ctx->program, ctx->function,
+                              &for_instr->instructions))
+    {
+        error_print(input);
+        fprintf(stderr, "a parallel for can't print or read, even in the "
+                        "functions it calls\n");
+        valid = false;
+    }
+    if (w.has_return) {
+        error_print(input);
+        fprintf(stderr, "a parallel for can't return\n");
+        valid = false;
+    }
+    for (int i = 0; i < w.variables.size; i++) {
+        if (!variable_is_valid(input, &w, w.variables.elements[i])) {
+            valid = false;
+        }
+    }
+
+    parallel_walk_wipe(&w);
+    return valid;
+}
+
+void parallel_plan_init(parallel_plan_t* plan, const context_t* ctx,
+                        const for_instr_t* for_instr)
+{
+    parallel_walk_t w;
+
+    vector_init(&plan->privates, 0);
+    vector_init(&plan->reductions, 0);
+
+    parallel_walk_init(&w, ctx, for_instr);
+    for (int i = 0; i < w.variables.size; i++) {
+        const parallel_variable_t* var = w.variables.elements[i];
+
+        if (identifier_equals(var->id, &for_instr->subject)) {
+            continue;
+        }
+
+        if (is_reduction(var)) {
+            parallel_reduction_t* reduction =
+                malloc(sizeof(parallel_reduction_t));
+            if (!reduction) {
+                fprintf(stderr, "couldn't allocate parallel reduction\n");
+                abort();
+            }
+            reduction->variable = var->id;
+            reduction->type = context_find_identifier_type(ctx, var->id);
+            reduction->operator = var->accumulation;
+            vector_push(&plan->reductions, reduction);
+        } else
+        if (var->uses[USE_ASSIGN] && var->is_always_assigned
+        &&  is_local(&w, var->id))
+        {
+            vector_push(&plan->privates,
+                        function_find_local(ctx->function, var->id));
+        }
+    }
+    parallel_walk_wipe(&w);
+}
+
+void parallel_plan_wipe(parallel_plan_t* plan) {
+    vector_wipe(&plan->privates, NULL);
+    vector_wipe(&plan->reductions, &free);
+}
@@ -0,0 +1,355 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "ez-lang.h"
+
+/* Entities reached from the main function are collected by address in the
+ * `reached` vector. `pending` holds the reached functions (and lambdas)
+ * whose instructions are still to be walked.
+ */
+typedef struct reachability {
+    program_t*  program;
+    vector_t    reached;    /* of void* */
+    vector_t    pending;    /* of function_t* */
+
+    /* A reached instruction prints or reads. */
+    bool        has_io;
+} reachability_t;
+
+static bool pointer_equals(const void* a, const void* b) {
+    return a == b;
+}
+
+static bool reachability_has(const reachability_t* r, const void* entity) {
+    return vector_contains(&r->reached, entity, &pointer_equals);
+}
+
+/* Returns true if `entity` was not already reached. */
+static bool reachability_add(reachability_t* r, void* entity) {
+    if (!entity || reachability_has(r, entity)) {
+        return false;
+    }
+    vector_push(&r->reached, entity);
+    return true;
+}
+
+static void reach_type(reachability_t* r, const type_t* type);
+static void reach_expression(reachability_t* r, const function_t* function,
+                             const expression_t* expr);
+
+static void reach_structure(reachability_t* r, structure_t* structure) {
+    if (!vector_contains(&r->program->structures, structure, &pointer_equals)
+    ||  !reachability_add(r, structure))
+    {
+        return;
+    }
+
+    for (int i = 0; i < structure->members.size; i++) {
+        symbol_t* member = structure->members.elements[i];
+        reach_type(r, member->is);
+    }
+}
+
+static void reach_type(reachability_t* r, const type_t* type) {
+    if (!type) {
+        return;
+    }
+
+    switch (type->type) {
+      case TYPE_TYPE_VECTOR:
+        reach_type(r, type->vector_type);
+        break;
+
+      case TYPE_TYPE_OPTIONAL:
+        reach_type(r, type->optional_type);
+        break;
+
+      case TYPE_TYPE_MAP:
+        reach_type(r, type->key_type);
+        reach_type(r, type->value_type);
+        break;
+
+      case TYPE_TYPE_ARRAY:
+        reach_type(r, type->array_type);
+        break;
+
+      case TYPE_TYPE_STRUCTURE:
+        reach_structure(r, type->structure_type);
+        break;
+
+      case TYPE_TYPE_FUNCTION:
+        reach_type(r, type->signature->return_type);
+        for (int i = 0; i < type->signature->args_types.size; i++) {
+            reach_type(r, type->signature->args_types.elements[i]);
+        }
+        break;
+
+      default:
+        break;
+    }
+}
+
+static void reach_function(reachability_t* r, function_t* function) {
+    if (reachability_add(r, function)) {
+        vector_push(&r->pending, function);
+    }
+}
+
+/* Reach the program entity named `id`, unless it is hidden by an argument or
+ * a local of `function`.
+ */
+static void reach_identifier(reachability_t* r, const function_t* function,
+                             const identifier_t* id)
+{
+    program_t* prg = r->program;
+
+    if (function
+    && (function_has_arg(function, id) || function_has_local(function, id)))
+    {
+        return;
+    }
+
+    function_t* callee = vector_find(&prg->functions, id,
+                                     (cmp_func_t)&function_is);
+    if (!callee) {
+        callee = vector_find(&prg->procedures, id, (cmp_func_t)&function_is);
+    }
+    if (callee) {
+        reach_function(r, callee);
+        return;
+    }
+
+    constant_t* constant = vector_find(&prg->constants, id,
+                                       (cmp_func_t)&constant_is);
+    if (constant) {
+        if (reachability_add(r, constant)) {
+            reach_type(r, constant->symbol->is);
+            reach_expression(r, NULL, constant->value);
+        }
+        return;
+    }
+
+    symbol_t* global = vector_find(&prg->globals, id, (cmp_func_t)&symbol_is);
+    if (global && reachability_add(r, global)) {
+        reach_type(r, global->is);
+    }
+}
+
+static void reach_parameters(reachability_t* r, const function_t* function,
+                             const parameters_t* params)
+{
+    for (int i = 0; i < params->parameters.size; i++) {
+        reach_expression(r, function, params->parameters.elements[i]);
+    }
+}
+
+/* Only the head of a valref names a program entity, the next ones are
+ * structure members or builtin methods. */
+static void reach_valref(reachability_t* r, const function_t* function,
+                         const valref_t* valref)
+{
+    reach_identifier(r, function, &valref->identifier);
+    for (; valref; valref = valref->next) {
+        reach_parameters(r, function, &valref->parameters);
+    }
+}
+
+static void reach_expression(reachability_t* r, const function_t* function,
+                             const expression_t* expr)
+{
+    if (!expr) {
+        return;
+    }
+
+    switch (expr->type) {
+      case EXPRESSION_TYPE_VALUE:
+        if (expr->value.type == VALUE_TYPE_VALREF) {
+            reach_valref(r, function, expr->value.valref);
+        } else
+        if (expr->value.type == VALUE_TYPE_EMPTY) {
+            reach_type(r, expr->value.empty_type);
+        }
+        break;
+
+      case EXPRESSION_TYPE_LAMBDA:
+        /* Lambdas are not program entities, they are walked like the
+         * function owning them. */
+        vector_push(&r->pending, expr->lambda);
+        break;
+
+      default:
+        reach_expression(r, function, expr->left);
+        reach_expression(r, function, expr->right);
+        break;
+    }
+}
+
+static void reach_instructions(reachability_t* r, const function_t* function,
+                               const vector_t* instrs);
+
+static void reach_instruction(reachability_t* r, const function_t* function,
+                              const instruction_t* instr)
+{
+    switch (instr->type) {
+      case INSTRUCTION_TYPE_PRINT:
+        r->has_io = true;
+        reach_parameters(r, function, &instr->parameters);
+        break;
+
+      case INSTRUCTION_TYPE_READ:
+        r->has_io = true;
+        reach_valref(r, function, instr->valref);
+        break;
+
+      case INSTRUCTION_TYPE_RETURN:
+      case INSTRUCTION_TYPE_EXPRESSION:
+        reach_expression(r, function, instr->expression);
+        break;
+
+      case INSTRUCTION_TYPE_AFFECTATION:
+        reach_valref(r, function, instr->affectation.lvalue);
+        reach_expression(r, function, instr->affectation.expression);
+        break;
+
+      case INSTRUCTION_TYPE_FLOWCONTROL: {
+        const flowcontrol_t* fc = &instr->flowcontrol;
+
+        switch (fc->type) {
+          case FLOWCONTROL_TYPE_IF:
+            reach_expression(r, function, fc->if_instr->coundition);
+            reach_instructions(r, function, &fc->if_instr->instructions);
+            for (int i = 0; i < fc->if_instr->elsifs.size; i++) {
+                const elsif_instr_t* elsif = fc->if_instr->elsifs.elements[i];
+                reach_expression(r, function, elsif->coundition);
+                reach_instructions(r, function, &elsif->instructions);
+            }
+            reach_instructions(r, function, &fc->if_instr->else_instrs);
+            break;
+
+          case FLOWCONTROL_TYPE_WHILE:
+            reach_expression(r, function, fc->while_instr->coundition);
+            reach_instructions(r, function, &fc->while_instr->instructions);
+            break;
+
+          case FLOWCONTROL_TYPE_LOOP:
+            reach_expression(r, function, fc->loop_instr->coundition);
+            reach_instructions(r, function, &fc->loop_instr->instructions);
+            break;
+
+          case FLOWCONTROL_TYPE_ON:
+            reach_expression(r, function, fc->on_instr->coundition);
+            reach_instruction(r, function, fc->on_instr->instruction);
+            break;
+
+          case FLOWCONTROL_TYPE_FOR:
+            reach_identifier(r, function, &fc->for_instr->subject);
+            reach_expression(r, function, fc->for_instr->range.from);
+            reach_expression(r, function, fc->for_instr->range.to);
+            reach_instructions(r, function, &fc->for_instr->instructions);
+            break;
+
+          case FLOWCONTROL_TYPE_MATCH:
+            reach_expression(r, function, fc->match_instr->subject);
+            for (int i = 0; i < fc->match_instr->cases.size; i++) {
+                const match_case_t* match_case =
+                    fc->match_instr->cases.elements[i];
+                reach_instructions(r, function, &match_case->instructions);
+            }
+            reach_instructions(r, function, &fc->match_instr->else_instrs);
+            break;
+        }
+        break;
+      }
+    }
+}
+
+static void reach_instructions(reachability_t* r, const function_t* function,
+                               const vector_t* instrs)
+{
+    for (int i = 0; i < instrs->size; i++) {
+        reach_instruction(r, function, instrs->elements[i]);
+    }
+}
+
+static void reach_function_body(reachability_t* r, const function_t* function)
+{
+    reach_type(r, function->return_type);
+    for (int i = 0; i < function->args.size; i++) {
+        const function_arg_t* arg = function->args.elements[i];
+        reach_type(r, arg->symbol->is);
+    }
+    for (int i = 0; i < function->locals.size; i++) {
+        const symbol_t* local = function->locals.elements[i];
+        reach_type(r, local->is);
+    }
+    reach_instructions(r, function, &function->instructions);
+}
+
+static void reach_pending(reachability_t* r) {
+    while (r->pending.size > 0) {
+        function_t* function = vector_get(&r->pending, r->pending.size - 1);
+        vector_pop(&r->pending);
+        reach_function_body(r, function);
+    }
+}
+
+/* Remove (and delete) the entities of `entities` that were not reached. */
+static void remove_unreached(const reachability_t* r, vector_t* entities,
+                             delete_func_t delete_entity)
+{
+    int kept = 0;
+
+    for (int i = 0; i < entities->size; i++) {
+        void* entity = entities->elements[i];
+        if (reachability_has(r, entity)) {
+            entities->elements[kept++] = entity;
+        } else {
+            delete_entity(entity);
+        }
+    }
+    entities->size = kept;
+}
+
+void program_remove_unreachable(program_t* prg) {
+    function_t* main_function = vector_find(&prg->functions, &prg->identifier,
+                                            (cmp_func_t)&function_is);
+    if (!main_function) {
+        return;
+    }
+
+    reachability_t r = (reachability_t){
+        .program = prg,
+    };
+    vector_init(&r.reached, 0);
+    vector_init(&r.pending, 0);
+
+    reach_function(&r, main_function);
+    reach_pending(&r);
+
+    remove_unreached(&r, &prg->functions, (delete_func_t)&function_delete);
+    remove_unreached(&r, &prg->procedures, (delete_func_t)&function_delete);
+    remove_unreached(&r, &prg->constants, (delete_func_t)&constant_delete);
+    remove_unreached(&r, &prg->globals, (delete_func_t)&symbol_delete);
+    /* Enumerations are all kept, they only cost their declaration.
+     * Structures last: the removed entities could still use them. */
+    remove_unreached(&r, &prg->structures, (delete_func_t)&structure_delete);
+
+    vector_wipe(&r.reached, NULL);
+    vector_wipe(&r.pending, NULL);
+}
+
+bool instructions_reach_io(program_t* prg, const function_t* function,
+                           const vector_t* instrs)
+{
+    reachability_t r = (reachability_t){
+        .program = prg,
+    };
+    vector_init(&r.reached, 0);
+    vector_init(&r.pending, 0);
+
+    reach_instructions(&r, function, instrs);
+    reach_pending(&r);
+
+    vector_wipe(&r.reached, NULL);
+    vector_wipe(&r.pending, NULL);
+    return r.has_io;
+}
@@ -30,6 +30,13 @@ void type_delete(type_t* t) {
         } else
         if (t->type == TYPE_TYPE_FUNCTION) {
             function_signature_delete(t->signature);
+        } else
+        if (t->type == TYPE_TYPE_MAP) {
+            type_delete(t->key_type);
+            type_delete(t->value_type);
+        } else
+        if (t->type == TYPE_TYPE_ARRAY) {
+            type_delete(t->array_type);
         }
 
         free(t);
@@ -80,6 +87,13 @@ type_t* type_structure_new(structure_t* s) {
     return t;
 }
 
+type_t* type_enumeration_new(enumeration_t* e) {
+    type_t* t = type_new(TYPE_TYPE_ENUMERATION);
+    t->enumeration_type = e;
+
+    return t;
+}
+
 type_t* type_function_new(function_signature_t* signature) {
     type_t* t = type_new(TYPE_TYPE_FUNCTION);
     t->signature = signature;
@@ -87,83 +101,161 @@ type_t* type_function_new(function_signature_t* signature) {
     return t;
 }
 
-void type_print(FILE* output, const context_t* ctx, const type_t* type) {
+type_t* type_map_new(type_t* key, type_t* value) {
+    type_t* map = type_new(TYPE_TYPE_MAP);
+    map->key_type = key;
+    map->value_type = value;
+
+    return map;
+}
+
+type_t* type_array_new(type_t* of, unsigned int size) {
+    type_t* array = type_new(TYPE_TYPE_ARRAY);
+    array->array_type = of;
+    array->array_size = size;
+
+    return array;
+}
+
+bool type_is_map_key(const type_t* type) {
+    switch (type->type) {
+      case TYPE_TYPE_BOOLEAN:
+      case TYPE_TYPE_INTEGER:
+      case TYPE_TYPE_NATURAL:
+      case TYPE_TYPE_REAL:
+      case TYPE_TYPE_CHAR:
+      case TYPE_TYPE_STRING:
+        return true;
+
+      default:
+        return false;
+    }
+}
+
+void type_print(emitter_t* output, const context_t* ctx, const type_t* type) {
     if (!type) {
-        fprintf(output, "void");
+        emitter_puts(output, "void");
         return;
     }
 
     switch (type->type) {
       case TYPE_TYPE_BOOLEAN:
-        fprintf(output, "bool");
+        emitter_puts(output, "bool");
         break;
 
       case TYPE_TYPE_INTEGER:
-        fprintf(output, "int");
+        emitter_puts(output, "int");
         break;
 
       case TYPE_TYPE_NATURAL:
-        fprintf(output, "unsigned int");
+        emitter_puts(output, "unsigned int");
         break;
 
       case TYPE_TYPE_REAL:
-        fprintf(output, "double");
+        emitter_puts(output, "double");
         break;
 
       case TYPE_TYPE_CHAR:
-        fprintf(output, "char");
+        emitter_puts(output, "char");
         break;
 
       case TYPE_TYPE_STRING:
-        fprintf(output, "std::string");
+        emitter_puts(output, "std::string");
         break;
 
       case TYPE_TYPE_OPTIONAL:
-        fprintf(output, "ez::optional< ");
+        emitter_puts(output, "ez::optional< ");
         type_print(output, ctx, type->optional_type);
-        fprintf(output, " >");
+        emitter_puts(output, " >");
         break;
 
       case TYPE_TYPE_VECTOR:
-        fprintf(output, "ez::vector< ");
+        emitter_puts(output, "ez::vector< ");
         type_print(output, ctx, type->vector_type);
-        fprintf(output, " >");
+        emitter_puts(output, " >");
+        break;
+
+      case TYPE_TYPE_MAP:
+        emitter_puts(output, "ez::map< ");
+        type_print(output, ctx, type->key_type);
+        emitter_puts(output, ", ");
+        type_print(output, ctx, type->value_type);
+        emitter_puts(output, " >");
+        break;
+
+      case TYPE_TYPE_ARRAY:
+        emitter_puts(output, "ez::array< ");
+        type_print(output, ctx, type->array_type);
+        emitter_printf(output, ", %u >", type->array_size);
         break;
 
       case TYPE_TYPE_STRUCTURE:
         if (program_has_builtin_structure(ctx->program,
                                           &type->structure_type->identifier))
         {
-            fprintf(output, "ez::");
+            emitter_puts(output, "ez::");
         }
-        fprintf(output, type->structure_type->identifier.value);
+        emitter_puts(output, type->structure_type->identifier.value);
+        break;
+
+      case TYPE_TYPE_ENUMERATION:
+        emitter_puts(output, type->enumeration_type->identifier.value);
         break;
 
       case TYPE_TYPE_FUNCTION:
-        fprintf(output, "std::function< ");
+        emitter_puts(output, "std::function< ");
         type_print(output, ctx, type->signature->return_type);
-        fprintf(output, "(");
+        emitter_puts(output, "(");
         for (int i = 0; i < type->signature->args_types.size; i++) {
             access_type_t at =
                 (access_type_t)type->signature->args_access.elements[i];
-            if (at == ACCESS_TYPE_INPUT) {
-                fprintf(output, "const ");
-            }
-
-            type_print(output, ctx, type->signature->args_types.elements[i]);
-            if (at == ACCESS_TYPE_OUTPUT || at == ACCESS_TYPE_INPUT_OUTPUT) {
-                fprintf(output, "&");
-            }
+            type_print_argument(output, ctx,
+                                type->signature->args_types.elements[i], at);
 
             if (i + 1 < type->signature->args_types.size) {
-                fprintf(output, ", ");
+                emitter_puts(output, ", ");
             }
         }
-        fprintf(output, ") >");
+        emitter_puts(output, ") >");
         break;
     }
 }
 
+bool type_is_passed_by_value(const context_t* ctx, const type_t* type) {
+    switch (type->type) {
+      case TYPE_TYPE_BOOLEAN:
+      case TYPE_TYPE_INTEGER:
+      case TYPE_TYPE_NATURAL:
+      case TYPE_TYPE_REAL:
+      case TYPE_TYPE_CHAR:
+      case TYPE_TYPE_ENUMERATION:
+        return true;
+
+      case TYPE_TYPE_STRUCTURE:
+        return builtin_structure_is_passed_by_value(ctx,
+                                                    type->structure_type);
+
+      default:
+        return false;
+    }
+}
+
+void type_print_argument(emitter_t* output, const context_t* ctx,
+                         const type_t* type, access_type_t access)
+{
+    if (access != ACCESS_TYPE_INPUT) {
+        type_print(output, ctx, type);
+        emitter_puts(output, "&");
+    } else
+    if (type_is_passed_by_value(ctx, type)) {
+        type_print(output, ctx, type);
+    } else {
+        emitter_puts(output, "const ");
+        type_print(output, ctx, type);
+        emitter_puts(output, "&");
+    }
+}
+
 bool types_are_equals(const type_t* a, const type_t* b) {
     if (a && b) {
         if (a->type == b->type) {
@@ -172,6 +264,9 @@ bool types_are_equals(const type_t* a, const type_t* b) {
                  * program. */
                 return a->structure_type == b->structure_type;
             } else
+            if (a->type == TYPE_TYPE_ENUMERATION) {
+                return a->enumeration_type == b->enumeration_type;
+            } else
             if (a->type == TYPE_TYPE_VECTOR) {
                 return types_are_equals(a->vector_type, b->vector_type);
             } else
@@ -181,6 +276,14 @@ bool types_are_equals(const type_t* a, const type_t* b) {
             if (a->type == TYPE_TYPE_FUNCTION) {
                 return function_signature_is_equals(a->signature,
                                                     b->signature);
+            } else
+            if (a->type == TYPE_TYPE_MAP) {
+                return types_are_equals(a->key_type, b->key_type)
+                    && types_are_equals(a->value_type, b->value_type);
+            } else
+            if (a->type == TYPE_TYPE_ARRAY) {
+                return a->array_size == b->array_size
+                    && types_are_equals(a->array_type, b->array_type);
             }
             return true;
         }
@@ -223,11 +326,22 @@ type_t* type_copy(const type_t* type) {
     if (copy->type == TYPE_TYPE_STRUCTURE) {
         copy->structure_type = type->structure_type;
     } else
+    if (copy->type == TYPE_TYPE_ENUMERATION) {
+        copy->enumeration_type = type->enumeration_type;
+    } else
     if (copy->type == TYPE_TYPE_FUNCTION) {
         copy->signature = function_signature_copy(type->signature);
     } else
     if (copy->type == TYPE_TYPE_OPTIONAL) {
         copy->optional_type = type_copy(type->optional_type);
+    } else
+    if (copy->type == TYPE_TYPE_MAP) {
+        copy->key_type = type_copy(type->key_type);
+        copy->value_type = type_copy(type->value_type);
+    } else
+    if (copy->type == TYPE_TYPE_ARRAY) {
+        copy->array_type = type_copy(type->array_type);
+        copy->array_size = type->array_size;
     }
     return copy;
 }
@@ -277,11 +391,28 @@ char* type_print_ez(const type_t* type, char* buf) {
             it = NULL;
             break;
 
+          case TYPE_TYPE_ENUMERATION:
+            strcat(buf, it->enumeration_type->identifier.value);
+            it = NULL;
+            break;
+
           case TYPE_TYPE_OPTIONAL:
             strcat(buf, "optional ");
             it = it->optional_type;
             break;
 
+          case TYPE_TYPE_MAP:
+            strcat(buf, "map of ");
+            type_print_ez(it->key_type, buf);
+            strcat(buf, " to ");
+            it = it->value_type;
+            break;
+
+          case TYPE_TYPE_ARRAY:
+            sprintf(buf + strlen(buf), "array of %u ", it->array_size);
+            it = it->array_type;
+            break;
+
           case TYPE_TYPE_FUNCTION:
             strcat(buf, "function ");
             strcat(buf, function_signature_print_ez(it->signature, subbuf));
@@ -344,9 +475,9 @@ void symbol_delete(symbol_t* symbol) {
     }
 }
 
-void symbol_print(FILE* output, const context_t* ctx, const symbol_t* symbol) {
+void symbol_print(emitter_t* output, const context_t* ctx, const symbol_t* symbol) {
     type_print(output, ctx, symbol->is);
-    fprintf(output, " %s ", symbol->identifier.value);
+    emitter_printf(output, " %s ", symbol->identifier.value);
 }
 
 bool symbol_is(const symbol_t* symbol, const identifier_t* id) {
@@ -382,16 +513,17 @@ void structure_add_member(structure_t* structure, symbol_t* member) {
     vector_push(&structure->members, member);
 }
 
-void structure_print(FILE* output, const context_t* ctx,
+void structure_print(emitter_t* output, const context_t* ctx,
                      const structure_t* structure)
 {
-    fprintf(output, "struct %s {\n", structure->identifier.value);
+    emitter_printf(output, "struct %s {\n", structure->identifier.value);
+    emitter_indent(output);
     for (int i = 0; i < structure->members.size; i++) {
-        fprintf(output, "    ");
         symbol_print(output, ctx, structure->members.elements[i]);
-        fprintf(output, ";\n");
+        emitter_puts(output, ";\n");
     }
-    fprintf(output, "};\n");
+    emitter_dedent(output);
+    emitter_puts(output, "};\n");
 }
 
 bool structure_is(const structure_t* structure, const identifier_t* id) {
@@ -407,3 +539,92 @@ symbol_t* structure_find_member(const structure_t* structure,
                                 const identifier_t* id) {
     return vector_find(&structure->members, id, (cmp_func_t)&symbol_is);
 }
+
+/**
+ * Enumerations.
+ */
+
+enumeration_t* enumeration_new(const identifier_t* identifier) {
+    enumeration_t* e = calloc(1, sizeof(enumeration_t));
+
+    if (!e) {
+        fprintf(stderr, "couldn't allocate enumeration\n");
+        exit(EXIT_FAILURE);
+    }
+
+    memcpy(&e->identifier, identifier, sizeof(identifier_t));
+    vector_init(&e->members, 0);
+    e->type = type_enumeration_new(e);
+
+    return e;
+}
+
+void enumeration_delete(enumeration_t* enumeration) {
+    if (enumeration) {
+        vector_wipe(&enumeration->members, &free);
+        type_delete(enumeration->type);
+        free(enumeration);
+    }
+}
+
+void enumeration_add_member(enumeration_t* enumeration,
+                            const identifier_t* member)
+{
+    identifier_t* copy = malloc(sizeof(identifier_t));
+
+    if (!copy) {
+        fprintf(stderr, "couldn't allocate enumeration member\n");
+        exit(EXIT_FAILURE);
+    }
+
+    memcpy(copy, member, sizeof(identifier_t));
+    vector_push(&enumeration->members, copy);
+}
+
+int enumeration_find_member(const enumeration_t* enumeration,
+                            const identifier_t* id)
+{
+    for (int i = 0; i < enumeration->members.size; i++) {
+        const identifier_t* member = enumeration->members.elements[i];
+        if (strcmp(member->value, id->value) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void enumeration_print(emitter_t* output, const context_t* ctx,
+                       const enumeration_t* enumeration)
+{
+    const vector_t* members = &enumeration->members;
+    const char* name = enumeration->identifier.value;
+
+    emitter_printf(output, "enum %s {\n", name);
+    emitter_indent(output);
+    for (int i = 0; i < members->size; i++) {
+        const identifier_t* member = members->elements[i];
+        emitter_printf(output, "%s,\n", member->value);
+    }
+    emitter_dedent(output);
+    emitter_puts(output, "};\n");
+
+    emitter_printf(output, "ez::output& operator<<(ez::output& output, "
+                           "%s value) {\n", name);
+    emitter_indent(output);
+    emitter_puts(output, "static const char* const names[] = {\n");
+    emitter_indent(output);
+    for (int i = 0; i < members->size; i++) {
+        const identifier_t* member = members->elements[i];
+        emitter_printf(output, "\"%s\",\n", member->value);
+    }
+    emitter_dedent(output);
+    emitter_puts(output, "};\n");
+    emitter_puts(output, "return output << names[value];\n");
+    emitter_dedent(output);
+    emitter_puts(output, "}\n");
+}
+
+bool enumeration_is(const enumeration_t* enumeration, const identifier_t* id)
+{
+    return strcmp(enumeration->identifier.value, id->value) == 0;
+}
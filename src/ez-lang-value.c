@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
+#include <math.h>
 #include "ez-lang.h"
 
 void parameters_init(parameters_t* params) {
@@ -16,13 +17,13 @@ void parameters_add(parameters_t* params, expression_t* expr) {
     vector_push(&params->parameters, expr);
 }
 
-void parameters_print(FILE* output, const context_t* ctx,
+void parameters_print(emitter_t* output, const context_t* ctx,
                       const parameters_t* params)
 {
     for (int i = 0; i < params->parameters.size; i++) {
         expression_print(output, ctx, params->parameters.elements[i]);
         if (i + 1 < params->parameters.size) {
-            fprintf(output, ", ");
+            emitter_puts(output, ", ");
         }
     }
 }
@@ -66,23 +67,28 @@ void valref_set_is_funccall(valref_t* v, bool is_funccall) {
     v->is_funccall = is_funccall;
 }
 
-void valref_print(FILE* output, const context_t* ctx, const valref_t* value) {
+void valref_print(emitter_t* output, const context_t* ctx, const valref_t* value) {
+    if (value->is_last_use) {
+        emitter_printf(output, "std::move(%s)", value->identifier.value);
+        return;
+    }
+
     if (program_has_builtin_function(ctx->program, &value->identifier)
     ||  program_has_builtin_procedure(ctx->program, &value->identifier))
     {
-        fprintf(output, "ez::");
+        emitter_puts(output, "ez::");
     }
 
-    fprintf(output, "%s", value->identifier.value);
+    emitter_puts(output, value->identifier.value);
 
     if (value->is_funccall) {
-        fprintf(output, "(");
+        emitter_puts(output, "(");
         parameters_print(output, ctx, &value->parameters);
-        fprintf(output, ")");
+        emitter_puts(output, ")");
     }
 
     if (value->next) {
-        fprintf(output, ".");
+        emitter_puts(output, ".");
         valref_print(output, ctx, value->next);
     }
 }
@@ -106,36 +112,68 @@ void value_wipe(value_t* value) {
     }
 }
 
-void empty_print(FILE* output, const context_t* ctx, const type_t* type) {
-    fprintf(output, "ez::optional< ");
+void empty_print(emitter_t* output, const context_t* ctx, const type_t* type) {
+    emitter_puts(output, "ez::optional< ");
     type_print(output, ctx, type->optional_type);
-    fprintf(output, " >()");
+    emitter_puts(output, " >()");
 }
 
-void value_print(FILE* output, const context_t* ctx, const value_t* value) {
+/* Print the shortest decimal form reading back as the same double, always
+ * as a C++ floating literal.
+ */
+static void real_print(emitter_t* output, double real) {
+    char buffer[40];
+    int precision = 1;
+
+    for (; precision <= 17; precision++) {
+        snprintf(buffer, sizeof(buffer), "%.*g", precision, real);
+        if (strtod(buffer, NULL) == real) {
+            break;
+        }
+    }
+
+    /* %g switches to scientific notation for 100 and more with a single
+     * significant digit, prefer the usual notation for reasonable reals. */
+    double magnitude = fabs(real);
+    if (strchr(buffer, 'e') && magnitude >= 1e-4 && magnitude < 1e16) {
+        int decimals = precision - 1 - (int)floor(log10(magnitude));
+        snprintf(buffer, sizeof(buffer), "%.*f",
+                 (decimals > 1) ? decimals : 1, real);
+    }
+
+    emitter_puts(output, buffer);
+    if (!strpbrk(buffer, ".e")) {
+        emitter_puts(output, ".0");
+    }
+}
+
+void value_print(emitter_t* output, const context_t* ctx, const value_t* value) {
     switch (value->type) {
       case VALUE_TYPE_STRING:
-        fprintf(output, "\"%s\"", value->string);
+        emitter_printf(output, "\"%s\"", value->string);
         break;
 
       case VALUE_TYPE_CHAR:
-        fprintf(output, "'%c'", value->character);
+        emitter_printf(output, "'%c'", value->character);
         break;
 
       case VALUE_TYPE_REAL:
-        fprintf(output, "%f", value->real);
+        real_print(output, value->real);
         break;
 
       case VALUE_TYPE_INTEGER:
-        fprintf(output, "%d", value->integer);
+        emitter_put_int(output, value->integer);
         break;
 
       case VALUE_TYPE_NATURAL:
-        fprintf(output, "%u", value->natural);
+        emitter_put_uint(output, value->natural);
+        if (value->is_unsigned) {
+            emitter_putc(output, 'u');
+        }
         break;
 
       case VALUE_TYPE_BOOLEAN:
-        fprintf(output, "%s", (value->boolean) ? "true" : "false");
+        emitter_puts(output, (value->boolean) ? "true" : "false");
         break;
 
       case VALUE_TYPE_VALREF:
@@ -160,16 +160,11 @@ function_t* function_new(const identifier_t* id) {
     return f;
 }
 
-void function_arg_print(FILE* output, const context_t* ctx,
+void function_arg_print(emitter_t* output, const context_t* ctx,
                         const function_arg_t* arg)
 {
-    if (arg->access_type == ACCESS_TYPE_INPUT) {
-        fprintf(output, "const ");
-    }
-    type_print(output, ctx, arg->symbol->is);
-    fprintf(output, "&");
-
-    fprintf(output, " %s", arg->symbol->identifier.value);
+    type_print_argument(output, ctx, arg->symbol->is, arg->access_type);
+    emitter_printf(output, " %s", arg->symbol->identifier.value);
 }
 
 void function_delete(function_t* func) {
@@ -188,56 +183,271 @@ void function_delete(function_t* func) {
     free(func);
 }
 
-void function_print(FILE* output, const context_t* ctx,
-                    const function_t* function)
+/* With the `template_lambdas` option, the `in` function arguments are typed
+ * by a template parameter named after them.
+ */
+static bool function_arg_is_template(const context_t* ctx,
+                                     const function_arg_t* arg)
 {
-    if (function->return_type) {
-        type_print(output, ctx, function->return_type);
-        fprintf(output, " ");
-    } else {
-        fprintf(output, "void ");
+    return ctx->options && ctx->options->template_lambdas
+        && arg->access_type == ACCESS_TYPE_INPUT
+        && arg->symbol->is->type == TYPE_TYPE_FUNCTION;
+}
+
+static bool expression_gives_lambda(const program_t* prg,
+                                    const expression_t* expr);
+static bool instructions_give_lambda(const program_t* prg,
+                                     const vector_t* instrs);
+
+static bool parameters_give_lambda(const program_t* prg,
+                                   const parameters_t* params)
+{
+    for (int i = 0; i < params->parameters.size; i++) {
+        if (expression_gives_lambda(prg, params->parameters.elements[i])) {
+            return true;
+        }
     }
+    return false;
+}
 
-    fprintf(output, "%s(", function->identifier.value);
+static bool valref_gives_lambda(const program_t* prg, const valref_t* valref)
+{
+    bool is_program_call =
+           valref->is_funccall
+        && (vector_contains(&prg->functions, &valref->identifier,
+                            (cmp_func_t)&function_is)
+        ||  vector_contains(&prg->procedures, &valref->identifier,
+                            (cmp_func_t)&function_is));
+
+    for (const valref_t* it = valref; it; it = it->next) {
+        for (int i = 0; i < it->parameters.parameters.size; i++) {
+            const expression_t* param = it->parameters.parameters.elements[i];
+            if ((it == valref && is_program_call
+                 && param->type == EXPRESSION_TYPE_LAMBDA)
+            ||  expression_gives_lambda(prg, param))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
 
-    for (int i = 0; i < function->args.size; i++) {
-        function_arg_print(output, ctx, function->args.elements[i]);
-        if (i + 1 < function->args.size) {
-            fprintf(output, ", ");
+/* Returns true if `expr` gives a lambda to a program function. */
+static bool expression_gives_lambda(const program_t* prg,
+                                    const expression_t* expr)
+{
+    if (!expr) {
+        return false;
+    }
+
+    switch (expr->type) {
+      case EXPRESSION_TYPE_VALUE:
+        return expr->value.type == VALUE_TYPE_VALREF
+            && valref_gives_lambda(prg, expr->value.valref);
+
+      case EXPRESSION_TYPE_LAMBDA:
+        return instructions_give_lambda(prg, &expr->lambda->instructions);
+
+      default:
+        return expression_gives_lambda(prg, expr->left)
+            || expression_gives_lambda(prg, expr->right);
+    }
+}
+
+static bool instruction_gives_lambda(const program_t* prg,
+                                     const instruction_t* instr)
+{
+    switch (instr->type) {
+      case INSTRUCTION_TYPE_PRINT:
+        return parameters_give_lambda(prg, &instr->parameters);
+
+      case INSTRUCTION_TYPE_READ:
+        return valref_gives_lambda(prg, instr->valref);
+
+      case INSTRUCTION_TYPE_RETURN:
+      case INSTRUCTION_TYPE_EXPRESSION:
+        return expression_gives_lambda(prg, instr->expression);
+
+      case INSTRUCTION_TYPE_AFFECTATION:
+        return valref_gives_lambda(prg, instr->affectation.lvalue)
+            || expression_gives_lambda(prg, instr->affectation.expression);
+
+      case INSTRUCTION_TYPE_FLOWCONTROL: {
+        const flowcontrol_t* fc = &instr->flowcontrol;
+
+        switch (fc->type) {
+          case FLOWCONTROL_TYPE_IF:
+            if (expression_gives_lambda(prg, fc->if_instr->coundition)
+            ||  instructions_give_lambda(prg, &fc->if_instr->instructions)
+            ||  instructions_give_lambda(prg, &fc->if_instr->else_instrs))
+            {
+                return true;
+            }
+            for (int i = 0; i < fc->if_instr->elsifs.size; i++) {
+                const elsif_instr_t* elsif = fc->if_instr->elsifs.elements[i];
+                if (expression_gives_lambda(prg, elsif->coundition)
+                ||  instructions_give_lambda(prg, &elsif->instructions))
+                {
+                    return true;
+                }
+            }
+            return false;
+
+          case FLOWCONTROL_TYPE_WHILE:
+            return expression_gives_lambda(prg, fc->while_instr->coundition)
+                || instructions_give_lambda(prg,
+                                            &fc->while_instr->instructions);
+
+          case FLOWCONTROL_TYPE_LOOP:
+            return expression_gives_lambda(prg, fc->loop_instr->coundition)
+                || instructions_give_lambda(prg,
+                                            &fc->loop_instr->instructions);
+
+          case FLOWCONTROL_TYPE_ON:
+            return expression_gives_lambda(prg, fc->on_instr->coundition)
+                || instruction_gives_lambda(prg, fc->on_instr->instruction);
+
+          case FLOWCONTROL_TYPE_FOR:
+            return expression_gives_lambda(prg, fc->for_instr->range.from)
+                || expression_gives_lambda(prg, fc->for_instr->range.to)
+                || instructions_give_lambda(prg,
+                                            &fc->for_instr->instructions);
+
+          case FLOWCONTROL_TYPE_MATCH:
+            if (expression_gives_lambda(prg, fc->match_instr->subject)
+            ||  instructions_give_lambda(prg, &fc->match_instr->else_instrs))
+            {
+                return true;
+            }
+            for (int i = 0; i < fc->match_instr->cases.size; i++) {
+                const match_case_t* match_case =
+                    fc->match_instr->cases.elements[i];
+                if (instructions_give_lambda(prg, &match_case->instructions)) {
+                    return true;
+                }
+            }
+            return false;
         }
+        return false;
+      }
     }
+    return false;
+}
 
-    fprintf(output, ") {\n");
+static bool instructions_give_lambda(const program_t* prg,
+                                     const vector_t* instrs)
+{
+    for (int i = 0; i < instrs->size; i++) {
+        if (instruction_gives_lambda(prg, instrs->elements[i])) {
+            return true;
+        }
+    }
+    return false;
+}
 
-    for (int i = 0; i < function->locals.size; i++) {
-        symbol_print(output, ctx, function->locals.elements[i]);
-        fprintf(output, ";\n");
+/* A lambda written in a template has a different type in each of its
+ * instantiations: given to a template function, it could instantiate it
+ * endlessly (think of a recursive call). Such functions stay plain ones.
+ */
+static bool function_is_template(const context_t* ctx,
+                                 const function_t* function)
+{
+    bool has_template_arg = false;
+
+    for (int i = 0; i < function->args.size; i++) {
+        if (function_arg_is_template(ctx, function->args.elements[i])) {
+            has_template_arg = true;
+            break;
+        }
     }
 
-    instructions_print(output, ctx, &function->instructions);
-    fprintf(output, "}\n\n");
+    return has_template_arg
+        && !instructions_give_lambda(ctx->program, &function->instructions);
 }
 
-void function_prototype_print(FILE* output, const context_t* ctx,
-                              const function_t* function)
+/* Print the template header (if any), the return type, the name and the
+ * arguments of `function`. */
+static void function_header_print(emitter_t* output, const context_t* ctx,
+                                  const function_t* function)
 {
+    bool is_template = function_is_template(ctx, function);
+
+    if (is_template) {
+        bool first = true;
+
+        emitter_puts(output, "template <");
+        for (int i = 0; i < function->args.size; i++) {
+            const function_arg_t* arg = function->args.elements[i];
+            if (function_arg_is_template(ctx, arg)) {
+                emitter_printf(output, "%stypename _ez_%s_t",
+                               first ? "" : ", ",
+                               arg->symbol->identifier.value);
+                first = false;
+            }
+        }
+        emitter_puts(output, ">\n");
+    }
+
+    /* Only the main function is called from outside of the program, the
+     * other ones can be inlined or dropped by the C++ compiler. */
+    if (!function_is(function, &ctx->program->identifier)) {
+        emitter_puts(output, "static ");
+    }
+
     if (function->return_type) {
         type_print(output, ctx, function->return_type);
-        fprintf(output, " ");
+        emitter_puts(output, " ");
     } else {
-        fprintf(output, "void ");
+        emitter_puts(output, "void ");
     }
 
-    fprintf(output, "%s(", function->identifier.value);
+    emitter_printf(output, "%s(", function->identifier.value);
 
     for (int i = 0; i < function->args.size; i++) {
-        function_arg_print(output, ctx, function->args.elements[i]);
+        const function_arg_t* arg = function->args.elements[i];
+
+        if (is_template && function_arg_is_template(ctx, arg)) {
+            emitter_printf(output, "const _ez_%s_t& %s",
+                           arg->symbol->identifier.value,
+                           arg->symbol->identifier.value);
+        } else {
+            function_arg_print(output, ctx, arg);
+        }
+
         if (i + 1 < function->args.size) {
-            fprintf(output, ", ");
+            emitter_puts(output, ", ");
         }
     }
 
-    fprintf(output, ");\n");
+    emitter_puts(output, ")");
+}
+
+void function_print(emitter_t* output, const context_t* ctx,
+                    const function_t* function)
+{
+    context_t function_ctx = *ctx;
+    function_ctx.function = (function_t*)function;
+
+    function_header_print(output, ctx, function);
+    emitter_puts(output, " {\n");
+    emitter_indent(output);
+
+    for (int i = 0; i < function->locals.size; i++) {
+        symbol_print(output, ctx, function->locals.elements[i]);
+        emitter_puts(output, ";\n");
+    }
+
+    instructions_print(output, &function_ctx, &function->instructions);
+    emitter_dedent(output);
+    emitter_puts(output, "}\n\n");
+}
+
+void function_prototype_print(emitter_t* output, const context_t* ctx,
+                              const function_t* function)
+{
+    function_header_print(output, ctx, function);
+    emitter_puts(output, ";\n");
 }
 
 void function_set_args(function_t* func, vector_t* args) {
@@ -334,14 +544,14 @@ void constant_delete(constant_t* constant) {
     free(constant);
 }
 
-void constant_print(FILE* output, const context_t* ctx,
+void constant_print(emitter_t* output, const context_t* ctx,
                     const constant_t* constant)
 {
-    fprintf(output, "const ");
+    emitter_puts(output, "const ");
     symbol_print(output, ctx, constant->symbol);
-    fprintf(output, " = ");
+    emitter_puts(output, " = ");
     expression_print(output, ctx, constant->value);
-    fprintf(output, ";\n");
+    emitter_puts(output, ";\n");
 }
 
 bool constant_is(const constant_t* constant, const identifier_t* id) {
@@ -359,6 +569,7 @@ program_t* program_new(const identifier_t* id) {
     vector_init(&prg->globals, 0);
     vector_init(&prg->constants, 0);
     vector_init(&prg->structures, 0);
+    vector_init(&prg->enumerations, 0);
     vector_init(&prg->functions, 0);
     vector_init(&prg->procedures, 0);
 
@@ -373,6 +584,7 @@ void program_delete(program_t* prg) {
     vector_wipe(&prg->globals, (delete_func_t)&symbol_delete);
     vector_wipe(&prg->constants, (delete_func_t)&constant_delete);
     vector_wipe(&prg->structures, (delete_func_t)&structure_delete);
+    vector_wipe(&prg->enumerations, (delete_func_t)&enumeration_delete);
     vector_wipe(&prg->functions, (delete_func_t)&function_delete);
     vector_wipe(&prg->procedures, (delete_func_t)&function_delete);
 
@@ -383,27 +595,126 @@ void program_delete(program_t* prg) {
     free(prg);
 }
 
-void program_print(FILE* output, const program_t* prg) {
-    fprintf(output, "#include <iostream>\n"
-                    "#include <string>\n"
-                    "#include <ctime>\n"
-                    "#include <cstdlib>\n"
-                    "#include <functional>\n"
-                    "#include \"ez/vector.hpp\"\n"
-                    "#include \"ez/optional.hpp\"\n"
-                    "#include \"ez/functions.hpp\"\n"
-                    "\n"
-    );
+/* Is `type` incomplete in the `index`th structure of the program, holding
+ * inline this structure or one defined after it ? Arrays store their elements
+ * inline, vectors keep them on the heap so they don't need them defined.
+ */
+static bool type_is_incomplete_in(const program_t* prg, int index,
+                                  const type_t* type)
+{
+    while (type->type == TYPE_TYPE_ARRAY) {
+        type = type->array_type;
+    }
+    if (type->type != TYPE_TYPE_STRUCTURE) {
+        return false;
+    }
+
+    for (int i = index; i < prg->structures.size; i++) {
+        if (prg->structures.elements[i] == type->structure_type) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Add to `boxed` the values of the optionals of the `type` member of the
+ * `index`th structure that are incomplete there.
+ */
+static void type_add_boxed_optionals(const program_t* prg, int index,
+                                     const type_t* type, vector_t* boxed)
+{
+    switch (type->type) {
+      case TYPE_TYPE_OPTIONAL:
+        if (type_is_incomplete_in(prg, index, type->optional_type)
+        &&  !vector_contains(boxed, type->optional_type,
+                             (cmp_func_t)&types_are_equals))
+        {
+            vector_push(boxed, (void*)type->optional_type);
+        }
+        type_add_boxed_optionals(prg, index, type->optional_type, boxed);
+        break;
+
+      case TYPE_TYPE_ARRAY:
+        type_add_boxed_optionals(prg, index, type->array_type, boxed);
+        break;
+
+      default:
+        break;
+    }
+}
+
+/* The optionals keep their value on the heap when they are declared before
+ * it is complete: in a structure holding itself (recursive structures) or
+ * a structure defined after it, maybe in arrays. Other optionals store their
+ * value inline.
+ */
+static void program_print_boxed_optionals(emitter_t* output,
+                                          const context_t* ctx)
+{
+    const program_t* prg = ctx->program;
+    vector_t boxed;
+
+    vector_init(&boxed, 0);
+    for (int i = 0; i < prg->structures.size; i++) {
+        const structure_t* s = prg->structures.elements[i];
+        for (int j = 0; j < s->members.size; j++) {
+            const symbol_t* member = s->members.elements[j];
+            type_add_boxed_optionals(prg, i, member->is, &boxed);
+        }
+    }
+
+    for (int i = 0; i < boxed.size; i++) {
+        const type_t* type = boxed.elements[i];
+        const type_t* structure = type;
+        while (structure->type == TYPE_TYPE_ARRAY) {
+            structure = structure->array_type;
+        }
+
+        emitter_printf(output, "struct %s;\n"
+                               "namespace ez {\n"
+                               "template <> struct optional_is_boxed< ",
+                       structure->structure_type->identifier.value);
+        type_print(output, ctx, type);
+        emitter_puts(output, " > : std::true_type {};\n"
+                             "}\n"
+                             "\n");
+    }
+    vector_wipe(&boxed, NULL);
+}
+
+void program_print(emitter_t* output, const program_t* prg,
+                   const codegen_options_t* options)
+{
+    emitter_puts(output, "#include <iostream>\n"
+                         "#include <string>\n"
+                         "#include <ctime>\n"
+                         "#include <cstdlib>\n"
+                         "#include <functional>\n"
+                         "#include \"ez/vector.hpp\"\n"
+                         "#include \"ez/array.hpp\"\n"
+                         "#include \"ez/optional.hpp\"\n"
+                         "#include \"ez/map.hpp\"\n"
+                         "#include \"ez/io.hpp\"\n"
+                         "#include \"ez/functions.hpp\"\n"
+                         "\n");
 
     const context_t ctx = (context_t){
         .program = (program_t*)prg,
-        .function = NULL
+        .function = NULL,
+        .options = options
     };
 
+    for (int i = 0; i < prg->enumerations.size; i++) {
+        enumeration_print(output, &ctx, prg->enumerations.elements[i]);
+        emitter_puts(output, "\n");
+    }
+
+    program_print_boxed_optionals(output, &ctx);
+
     for (int i = 0; i < prg->structures.size; i++) {
         structure_print(output, &ctx, prg->structures.elements[i]);
     }
-    fprintf(output, "\n");
+    emitter_puts(output, "\n");
 
     for (int i = 0; i < prg->functions.size; i++) {
         function_prototype_print(output, &ctx, prg->functions.elements[i]);
@@ -411,14 +722,14 @@ void program_print(FILE* output, const program_t* prg) {
     for (int i = 0; i < prg->procedures.size; i++) {
         function_prototype_print(output, &ctx, prg->procedures.elements[i]);
     }
-    fprintf(output, "\n");
+    emitter_puts(output, "\n");
 
     for (int i = 0; i < prg->constants.size; i++) {
         constant_print(output, &ctx, prg->constants.elements[i]);
     }
     for (int i = 0; i < prg->globals.size; i++) {
         symbol_print(output, &ctx, prg->globals.elements[i]);
-        fprintf(output, ";\n");
+        emitter_puts(output, ";\n");
     }
 
     for (int i = 0; i < prg->functions.size; i++) {
@@ -428,14 +739,14 @@ void program_print(FILE* output, const program_t* prg) {
         function_print(output, &ctx, prg->procedures.elements[i]);
     }
 
-    fprintf(output, "int main(int argc, char** argv) {\n"
-                    "    ez::vector<std::string> args;\n"
-                    "    for (int i = 0; i < argc; i++) {\n"
-                    "        args.push(std::string(argv[i]));\n"
-                    "    }\n"
-                    "    return %s(args);\n"
-                    "}\n",
-            prg->identifier.value);
+    emitter_printf(output, "int main(int argc, char** argv) {\n"
+                           "    ez::vector<std::string> args;\n"
+                           "    for (int i = 0; i < argc; i++) {\n"
+                           "        args.push(std::string(argv[i]));\n"
+                           "    }\n"
+                           "    return %s(args);\n"
+                           "}\n",
+                   prg->identifier.value);
 }
 
 void program_add_global(program_t* prg, symbol_t* global) {
@@ -487,6 +798,33 @@ structure_t* program_find_structure(const program_t* prg,
     return structure;
 }
 
+void program_add_enumeration(program_t* prg, enumeration_t* enumeration) {
+    vector_push(&prg->enumerations, enumeration);
+}
+
+bool program_has_enumeration(const program_t* prg, const identifier_t* id) {
+    return vector_contains(&prg->enumerations, id,
+                           (cmp_func_t)&enumeration_is);
+}
+
+enumeration_t* program_find_enumeration(const program_t* prg,
+                                        const identifier_t* id)
+{
+    return vector_find(&prg->enumerations, id, (cmp_func_t)&enumeration_is);
+}
+
+enumeration_t* program_find_enumeration_member(const program_t* prg,
+                                               const identifier_t* id)
+{
+    for (int i = 0; i < prg->enumerations.size; i++) {
+        enumeration_t* enumeration = prg->enumerations.elements[i];
+        if (enumeration_find_member(enumeration, id) >= 0) {
+            return enumeration;
+        }
+    }
+    return NULL;
+}
+
 void program_add_function(program_t* prg, function_t* function) {
     vector_push(&prg->functions, function);
 }
@@ -631,5 +969,11 @@ const type_t* context_find_identifier_type(const context_t* ctx,
         return constant->symbol->is;
     }
 
+    enumeration_t* enumeration = program_find_enumeration_member(ctx->program,
+                                                                 id);
+    if (enumeration) {
+        return enumeration->type;
+    }
+
     return NULL;
 }
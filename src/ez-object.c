@@ -0,0 +1,952 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "ez-object.h"
+
+/* Tag used in place of a type or an expression tag when it is NULL. */
+#define OBJECT_TAG_NULL     0xff
+
+/* Structures are referenced by an index in one of these two vectors. */
+enum {
+    OBJECT_STRUCTURE_BUILTIN,
+    OBJECT_STRUCTURE_PROGRAM,
+};
+
+typedef struct object_writer {
+    FILE*            output;
+    const program_t* program;
+    bool             error;
+} object_writer_t;
+
+typedef struct object_reader {
+    FILE*      input;
+    program_t* program;
+    bool       error;
+} object_reader_t;
+
+/* ------------------------------ writing ---------------------------------- */
+
+static void write_error(object_writer_t* w, const char* what) {
+    if (!w->error) {
+        fprintf(stderr, "couldn't write EZ object: %s\n", what);
+    }
+    w->error = true;
+}
+
+static void write_byte(object_writer_t* w, uint8_t byte) {
+    fputc(byte, w->output);
+}
+
+static void write_natural(object_writer_t* w, uint64_t n) {
+    do {
+        uint8_t byte = n & 0x7f;
+        n >>= 7;
+        write_byte(w, (n) ? byte | 0x80 : byte);
+    } while (n);
+}
+
+static void write_integer(object_writer_t* w, int64_t i) {
+    write_natural(w, ((uint64_t)i << 1) ^ (uint64_t)(i >> 63));
+}
+
+static void write_real(object_writer_t* w, double r) {
+    uint64_t bits;
+
+    memcpy(&bits, &r, sizeof(bits));
+    for (int i = 0; i < 8; i++) {
+        write_byte(w, (bits >> (8 * i)) & 0xff);
+    }
+}
+
+static void write_string(object_writer_t* w, const char* s) {
+    size_t length = strlen(s);
+
+    write_natural(w, length);
+    fwrite(s, 1, length, w->output);
+}
+
+static void write_identifier(object_writer_t* w, const identifier_t* id) {
+    write_string(w, id->value);
+}
+
+static void write_structure_ref(object_writer_t* w,
+                                const structure_t* structure)
+{
+    const vector_t* builtins = &w->program->builtin_structures;
+    const vector_t* structures = &w->program->structures;
+
+    for (int i = 0; i < builtins->size; i++) {
+        if (builtins->elements[i] == structure) {
+            write_byte(w, OBJECT_STRUCTURE_BUILTIN);
+            write_natural(w, i);
+            return;
+        }
+    }
+    for (int i = 0; i < structures->size; i++) {
+        if (structures->elements[i] == structure) {
+            write_byte(w, OBJECT_STRUCTURE_PROGRAM);
+            write_natural(w, i);
+            return;
+        }
+    }
+    write_error(w, "reference to a structure out of the program");
+}
+
+static void write_enumeration_ref(object_writer_t* w,
+                                  const enumeration_t* enumeration)
+{
+    const vector_t* enumerations = &w->program->enumerations;
+
+    for (int i = 0; i < enumerations->size; i++) {
+        if (enumerations->elements[i] == enumeration) {
+            write_natural(w, i);
+            return;
+        }
+    }
+    write_error(w, "reference to an enumeration out of the program");
+}
+
+static void write_type(object_writer_t* w, const type_t* type);
+static void write_expression(object_writer_t* w, const expression_t* expr);
+static void write_function(object_writer_t* w, const function_t* function);
+static void write_instructions(object_writer_t* w, const vector_t* instrs);
+
+static void write_signature(object_writer_t* w,
+                            const function_signature_t* signature)
+{
+    write_type(w, signature->return_type);
+    write_natural(w, signature->args_types.size);
+    for (int i = 0; i < signature->args_types.size; i++) {
+        write_byte(w, (access_type_t)signature->args_access.elements[i]);
+        write_type(w, signature->args_types.elements[i]);
+    }
+}
+
+static void write_type(object_writer_t* w, const type_t* type) {
+    if (!type) {
+        write_byte(w, OBJECT_TAG_NULL);
+        return;
+    }
+
+    write_byte(w, type->type);
+    switch (type->type) {
+      case TYPE_TYPE_VECTOR:
+        write_type(w, type->vector_type);
+        break;
+
+      case TYPE_TYPE_OPTIONAL:
+        write_type(w, type->optional_type);
+        break;
+
+      case TYPE_TYPE_STRUCTURE:
+        write_structure_ref(w, type->structure_type);
+        break;
+
+      case TYPE_TYPE_ENUMERATION:
+        write_enumeration_ref(w, type->enumeration_type);
+        break;
+
+      case TYPE_TYPE_FUNCTION:
+        write_signature(w, type->signature);
+        break;
+
+      case TYPE_TYPE_MAP:
+        write_type(w, type->key_type);
+        write_type(w, type->value_type);
+        break;
+
+      case TYPE_TYPE_ARRAY:
+        write_natural(w, type->array_size);
+        write_type(w, type->array_type);
+        break;
+
+      default:
+        break;
+    }
+}
+
+static void write_symbol(object_writer_t* w, const symbol_t* symbol) {
+    write_identifier(w, &symbol->identifier);
+    write_type(w, symbol->is);
+}
+
+static void write_parameters(object_writer_t* w, const parameters_t* params) {
+    write_natural(w, params->parameters.size);
+    for (int i = 0; i < params->parameters.size; i++) {
+        write_expression(w, params->parameters.elements[i]);
+    }
+}
+
+static void write_valref(object_writer_t* w, const valref_t* valref) {
+    write_identifier(w, &valref->identifier);
+    write_byte(w, valref->is_funccall);
+    write_byte(w, valref->is_builtin);
+    write_parameters(w, &valref->parameters);
+
+    write_byte(w, valref->next != NULL);
+    if (valref->next) {
+        write_valref(w, valref->next);
+    }
+}
+
+static void write_value(object_writer_t* w, const value_t* value) {
+    write_byte(w, value->type);
+    switch (value->type) {
+      case VALUE_TYPE_STRING:
+        write_string(w, value->string);
+        break;
+
+      case VALUE_TYPE_REAL:
+        write_real(w, value->real);
+        break;
+
+      case VALUE_TYPE_INTEGER:
+        write_integer(w, value->integer);
+        break;
+
+      case VALUE_TYPE_NATURAL:
+        write_natural(w, value->natural);
+        break;
+
+      case VALUE_TYPE_BOOLEAN:
+        write_byte(w, value->boolean);
+        break;
+
+      case VALUE_TYPE_CHAR:
+        write_byte(w, value->character);
+        break;
+
+      case VALUE_TYPE_VALREF:
+        write_valref(w, value->valref);
+        break;
+
+      case VALUE_TYPE_EMPTY:
+        write_type(w, value->empty_type);
+        break;
+    }
+}
+
+static void write_expression(object_writer_t* w, const expression_t* expr) {
+    if (!expr) {
+        write_byte(w, OBJECT_TAG_NULL);
+        return;
+    }
+
+    write_byte(w, expr->type);
+    if (expr->type == EXPRESSION_TYPE_VALUE) {
+        write_value(w, &expr->value);
+    } else
+    if (expr->type == EXPRESSION_TYPE_LAMBDA) {
+        write_function(w, expr->lambda);
+    } else {
+        write_expression(w, expr->left);
+        write_expression(w, expr->right);
+    }
+}
+
+static void write_instruction(object_writer_t* w, const instruction_t* instr);
+
+static void write_flowcontrol(object_writer_t* w, const flowcontrol_t* fc) {
+    write_byte(w, fc->type);
+    switch (fc->type) {
+      case FLOWCONTROL_TYPE_IF:
+        write_expression(w, fc->if_instr->coundition);
+        write_instructions(w, &fc->if_instr->instructions);
+        write_natural(w, fc->if_instr->elsifs.size);
+        for (int i = 0; i < fc->if_instr->elsifs.size; i++) {
+            const elsif_instr_t* elsif = fc->if_instr->elsifs.elements[i];
+            write_expression(w, elsif->coundition);
+            write_instructions(w, &elsif->instructions);
+        }
+        write_instructions(w, &fc->if_instr->else_instrs);
+        break;
+
+      case FLOWCONTROL_TYPE_WHILE:
+        write_expression(w, fc->while_instr->coundition);
+        write_instructions(w, &fc->while_instr->instructions);
+        break;
+
+      case FLOWCONTROL_TYPE_LOOP:
+        write_expression(w, fc->loop_instr->coundition);
+        write_instructions(w, &fc->loop_instr->instructions);
+        break;
+
+      case FLOWCONTROL_TYPE_ON:
+        write_expression(w, fc->on_instr->coundition);
+        write_instruction(w, fc->on_instr->instruction);
+        break;
+
+      case FLOWCONTROL_TYPE_FOR:
+        write_identifier(w, &fc->for_instr->subject);
+        write_byte(w, fc->for_instr->is_parallel);
+        write_expression(w, fc->for_instr->range.from);
+        write_expression(w, fc->for_instr->range.to);
+        write_instructions(w, &fc->for_instr->instructions);
+        break;
+
+      case FLOWCONTROL_TYPE_MATCH:
+        write_expression(w, fc->match_instr->subject);
+        write_natural(w, fc->match_instr->cases.size);
+        for (int i = 0; i < fc->match_instr->cases.size; i++) {
+            const match_case_t* match_case =
+                fc->match_instr->cases.elements[i];
+            write_natural(w, match_case->values.size);
+            for (int j = 0; j < match_case->values.size; j++) {
+                write_expression(w, match_case->values.elements[j]);
+            }
+            write_instructions(w, &match_case->instructions);
+        }
+        write_byte(w, fc->match_instr->has_else);
+        write_instructions(w, &fc->match_instr->else_instrs);
+        break;
+    }
+}
+
+static void write_instruction(object_writer_t* w, const instruction_t* instr)
+{
+    write_byte(w, instr->type);
+    switch (instr->type) {
+      case INSTRUCTION_TYPE_PRINT:
+        write_parameters(w, &instr->parameters);
+        break;
+
+      case INSTRUCTION_TYPE_READ:
+        write_valref(w, instr->valref);
+        break;
+
+      case INSTRUCTION_TYPE_RETURN:
+      case INSTRUCTION_TYPE_EXPRESSION:
+        write_expression(w, instr->expression);
+        break;
+
+      case INSTRUCTION_TYPE_FLOWCONTROL:
+        write_flowcontrol(w, &instr->flowcontrol);
+        break;
+
+      case INSTRUCTION_TYPE_AFFECTATION:
+        write_valref(w, instr->affectation.lvalue);
+        write_expression(w, instr->affectation.expression);
+        break;
+    }
+}
+
+static void write_instructions(object_writer_t* w, const vector_t* instrs) {
+    write_natural(w, instrs->size);
+    for (int i = 0; i < instrs->size; i++) {
+        write_instruction(w, instrs->elements[i]);
+    }
+}
+
+static void write_function(object_writer_t* w, const function_t* function) {
+    write_identifier(w, &function->identifier);
+    write_type(w, function->return_type);
+
+    write_natural(w, function->args.size);
+    for (int i = 0; i < function->args.size; i++) {
+        const function_arg_t* arg = function->args.elements[i];
+        write_byte(w, arg->access_type);
+        write_symbol(w, arg->symbol);
+    }
+
+    write_natural(w, function->locals.size);
+    for (int i = 0; i < function->locals.size; i++) {
+        write_symbol(w, function->locals.elements[i]);
+    }
+
+    write_instructions(w, &function->instructions);
+}
+
+static void write_functions(object_writer_t* w, const vector_t* functions) {
+    write_natural(w, functions->size);
+    for (int i = 0; i < functions->size; i++) {
+        write_function(w, functions->elements[i]);
+    }
+}
+
+bool program_write_object(FILE* output, const program_t* prg) {
+    object_writer_t w = {
+        .output = output,
+        .program = prg,
+    };
+
+    fwrite(EZ_OBJECT_MAGIC, 1, strlen(EZ_OBJECT_MAGIC), output);
+    write_natural(&w, EZ_OBJECT_VERSION);
+    write_identifier(&w, &prg->identifier);
+
+    /* Enumerations first, structure members can be enumerations. */
+    write_natural(&w, prg->enumerations.size);
+    for (int i = 0; i < prg->enumerations.size; i++) {
+        const enumeration_t* enumeration = prg->enumerations.elements[i];
+        write_identifier(&w, &enumeration->identifier);
+        write_natural(&w, enumeration->members.size);
+        for (int j = 0; j < enumeration->members.size; j++) {
+            write_identifier(&w, enumeration->members.elements[j]);
+        }
+    }
+
+    /* Structures identifiers first, so members can reference any of them. */
+    write_natural(&w, prg->builtin_structures.size);
+    for (int i = 0; i < prg->builtin_structures.size; i++) {
+        const structure_t* structure = prg->builtin_structures.elements[i];
+        write_identifier(&w, &structure->identifier);
+    }
+    write_natural(&w, prg->structures.size);
+    for (int i = 0; i < prg->structures.size; i++) {
+        const structure_t* structure = prg->structures.elements[i];
+        write_identifier(&w, &structure->identifier);
+    }
+    for (int i = 0; i < prg->structures.size; i++) {
+        const structure_t* structure = prg->structures.elements[i];
+        write_natural(&w, structure->members.size);
+        for (int j = 0; j < structure->members.size; j++) {
+            write_symbol(&w, structure->members.elements[j]);
+        }
+    }
+
+    write_functions(&w, &prg->builtin_functions);
+    write_functions(&w, &prg->builtin_procedures);
+
+    write_natural(&w, prg->constants.size);
+    for (int i = 0; i < prg->constants.size; i++) {
+        const constant_t* constant = prg->constants.elements[i];
+        write_symbol(&w, constant->symbol);
+        write_expression(&w, constant->value);
+    }
+
+    write_natural(&w, prg->globals.size);
+    for (int i = 0; i < prg->globals.size; i++) {
+        write_symbol(&w, prg->globals.elements[i]);
+    }
+
+    write_functions(&w, &prg->functions);
+    write_functions(&w, &prg->procedures);
+
+    return !w.error && !ferror(output);
+}
+
+/* ------------------------------ reading ---------------------------------- */
+
+static void read_error(object_reader_t* r, const char* what) {
+    if (!r->error) {
+        fprintf(stderr, "invalid EZ object: %s\n", what);
+    }
+    r->error = true;
+}
+
+static uint8_t read_byte(object_reader_t* r) {
+    int c = fgetc(r->input);
+
+    if (c == EOF) {
+        read_error(r, "unexpected end of file");
+        return 0;
+    }
+    return c;
+}
+
+static uint64_t read_natural(object_reader_t* r) {
+    uint64_t n = 0;
+    uint8_t byte;
+    int shift = 0;
+
+    do {
+        byte = read_byte(r);
+        if (shift < 64) {
+            n |= (uint64_t)(byte & 0x7f) << shift;
+        }
+        shift += 7;
+    } while (byte & 0x80);
+
+    return n;
+}
+
+static int64_t read_integer(object_reader_t* r) {
+    uint64_t n = read_natural(r);
+    return (int64_t)(n >> 1) ^ -(int64_t)(n & 1);
+}
+
+static double read_real(object_reader_t* r) {
+    uint64_t bits = 0;
+    double real;
+
+    for (int i = 0; i < 8; i++) {
+        bits |= (uint64_t)read_byte(r) << (8 * i);
+    }
+    memcpy(&real, &bits, sizeof(real));
+    return real;
+}
+
+static char* read_string(object_reader_t* r) {
+    uint64_t length = read_natural(r);
+    char* s = NULL;
+
+    if (r->error || length > INT32_MAX) {
+        read_error(r, "invalid string length");
+        length = 0;
+    }
+
+    s = malloc(length + 1);
+    if (fread(s, 1, length, r->input) != length) {
+        read_error(r, "truncated string");
+        length = 0;
+    }
+    s[length] = '\0';
+
+    return s;
+}
+
+static void read_identifier(object_reader_t* r, identifier_t* id) {
+    char* value = read_string(r);
+
+    if (!identifier_set_value(id, value)) {
+        read_error(r, "identifier is too long");
+        id->value[0] = '\0';
+    }
+    free(value);
+}
+
+static structure_t* read_structure_ref(object_reader_t* r) {
+    uint8_t kind = read_byte(r);
+    uint64_t index = read_natural(r);
+    const vector_t* structures = (kind == OBJECT_STRUCTURE_BUILTIN)
+                               ? &r->program->builtin_structures
+                               : &r->program->structures;
+
+    if (index >= structures->size) {
+        read_error(r, "invalid structure reference");
+        return NULL;
+    }
+    return structures->elements[index];
+}
+
+static enumeration_t* read_enumeration_ref(object_reader_t* r) {
+    uint64_t index = read_natural(r);
+
+    if (index >= r->program->enumerations.size) {
+        read_error(r, "invalid enumeration reference");
+        return NULL;
+    }
+    return r->program->enumerations.elements[index];
+}
+
+static type_t* read_type(object_reader_t* r);
+static expression_t* read_expression(object_reader_t* r);
+static function_t* read_function(object_reader_t* r);
+static void read_instructions(object_reader_t* r, vector_t* instrs);
+
+static function_signature_t* read_signature(object_reader_t* r) {
+    function_signature_t* signature = function_signature_new();
+
+    signature->return_type = read_type(r);
+
+    uint64_t nargs = read_natural(r);
+    for (uint64_t i = 0; i < nargs && !r->error; i++) {
+        access_type_t access_type = read_byte(r);
+        vector_push(&signature->args_access, (void*)access_type);
+        vector_push(&signature->args_types, read_type(r));
+    }
+
+    return signature;
+}
+
+static type_t* read_type(object_reader_t* r) {
+    uint8_t tag = read_byte(r);
+
+    if (tag == OBJECT_TAG_NULL || r->error) {
+        return NULL;
+    }
+
+    switch (tag) {
+      case TYPE_TYPE_BOOLEAN:
+      case TYPE_TYPE_INTEGER:
+      case TYPE_TYPE_NATURAL:
+      case TYPE_TYPE_REAL:
+      case TYPE_TYPE_CHAR:
+      case TYPE_TYPE_STRING:
+        return type_new(tag);
+
+      case TYPE_TYPE_VECTOR:
+        return type_vector_new(read_type(r));
+
+      case TYPE_TYPE_OPTIONAL:
+        return type_optional_new(read_type(r));
+
+      case TYPE_TYPE_STRUCTURE:
+        return type_structure_new(read_structure_ref(r));
+
+      case TYPE_TYPE_ENUMERATION:
+        return type_enumeration_new(read_enumeration_ref(r));
+
+      case TYPE_TYPE_FUNCTION:
+        return type_function_new(read_signature(r));
+
+      case TYPE_TYPE_MAP: {
+        type_t* key = read_type(r);
+        return type_map_new(key, read_type(r));
+      }
+
+      case TYPE_TYPE_ARRAY: {
+        unsigned int size = read_natural(r);
+        return type_array_new(read_type(r), size);
+      }
+    }
+
+    read_error(r, "unknown type");
+    return NULL;
+}
+
+static symbol_t* read_symbol(object_reader_t* r) {
+    identifier_t id;
+
+    read_identifier(r, &id);
+    return symbol_new(&id, read_type(r));
+}
+
+static void read_parameters(object_reader_t* r, parameters_t* params) {
+    uint64_t nparams = read_natural(r);
+
+    for (uint64_t i = 0; i < nparams && !r->error; i++) {
+        parameters_add(params, read_expression(r));
+    }
+}
+
+static valref_t* read_valref(object_reader_t* r) {
+    identifier_t id;
+
+    read_identifier(r, &id);
+
+    valref_t* valref = valref_new(&id);
+    valref->is_funccall = read_byte(r);
+    valref->is_builtin = read_byte(r);
+    read_parameters(r, &valref->parameters);
+
+    if (read_byte(r) && !r->error) {
+        valref->next = read_valref(r);
+    }
+
+    return valref;
+}
+
+static void read_value(object_reader_t* r, value_t* value) {
+    value->type = read_byte(r);
+    switch (value->type) {
+      case VALUE_TYPE_STRING:
+        value->string = read_string(r);
+        break;
+
+      case VALUE_TYPE_REAL:
+        value->real = read_real(r);
+        break;
+
+      case VALUE_TYPE_INTEGER:
+        value->integer = read_integer(r);
+        break;
+
+      case VALUE_TYPE_NATURAL:
+        value->natural = read_natural(r);
+        value->is_unsigned = false;
+        break;
+
+      case VALUE_TYPE_BOOLEAN:
+        value->boolean = read_byte(r);
+        break;
+
+      case VALUE_TYPE_CHAR:
+        value->character = read_byte(r);
+        break;
+
+      case VALUE_TYPE_VALREF:
+        value->valref = read_valref(r);
+        break;
+
+      case VALUE_TYPE_EMPTY:
+        value->empty_type = read_type(r);
+        break;
+
+      default:
+        read_error(r, "unknown value");
+        value->type = VALUE_TYPE_BOOLEAN;
+        break;
+    }
+}
+
+static expression_t* read_expression(object_reader_t* r) {
+    uint8_t tag = read_byte(r);
+
+    if (tag == OBJECT_TAG_NULL || r->error) {
+        return NULL;
+    } else
+    if (tag >= EXPRESSION_TYPE_SIZE) {
+        read_error(r, "unknown expression");
+        return NULL;
+    }
+
+    expression_t* expr = expression_new(tag);
+    if (expr->type == EXPRESSION_TYPE_VALUE) {
+        read_value(r, &expr->value);
+    } else
+    if (expr->type == EXPRESSION_TYPE_LAMBDA) {
+        expr->lambda = read_function(r);
+    } else {
+        expr->left = read_expression(r);
+        expr->right = read_expression(r);
+    }
+
+    return expr;
+}
+
+static instruction_t* read_instruction(object_reader_t* r);
+
+static void read_flowcontrol(object_reader_t* r, flowcontrol_t* fc) {
+    fc->type = read_byte(r);
+    switch (fc->type) {
+      case FLOWCONTROL_TYPE_IF: {
+        fc->if_instr = if_instr_new(read_expression(r));
+        read_instructions(r, &fc->if_instr->instructions);
+
+        uint64_t nelsifs = read_natural(r);
+        for (uint64_t i = 0; i < nelsifs && !r->error; i++) {
+            elsif_instr_t* elsif = elsif_instr_new(read_expression(r));
+            read_instructions(r, &elsif->instructions);
+            vector_push(&fc->if_instr->elsifs, elsif);
+        }
+
+        read_instructions(r, &fc->if_instr->else_instrs);
+        break;
+      }
+
+      case FLOWCONTROL_TYPE_WHILE:
+        fc->while_instr = while_instr_new(read_expression(r));
+        read_instructions(r, &fc->while_instr->instructions);
+        break;
+
+      case FLOWCONTROL_TYPE_LOOP:
+        fc->loop_instr = loop_instr_new(read_expression(r));
+        read_instructions(r, &fc->loop_instr->instructions);
+        break;
+
+      case FLOWCONTROL_TYPE_ON:
+        fc->on_instr = on_instr_new(read_expression(r));
+        fc->on_instr->instruction = read_instruction(r);
+        break;
+
+      case FLOWCONTROL_TYPE_FOR: {
+        identifier_t subject;
+
+        read_identifier(r, &subject);
+        fc->for_instr = for_instr_new(&subject);
+        fc->for_instr->is_parallel = read_byte(r);
+        range_set_from(&fc->for_instr->range, read_expression(r));
+        range_set_to(&fc->for_instr->range, read_expression(r));
+        read_instructions(r, &fc->for_instr->instructions);
+        break;
+      }
+
+      case FLOWCONTROL_TYPE_MATCH: {
+        fc->match_instr = match_instr_new(read_expression(r));
+
+        uint64_t ncases = read_natural(r);
+        for (uint64_t i = 0; i < ncases && !r->error; i++) {
+            match_case_t* match_case = match_case_new();
+            uint64_t nvalues = read_natural(r);
+            for (uint64_t j = 0; j < nvalues && !r->error; j++) {
+                vector_push(&match_case->values, read_expression(r));
+            }
+            read_instructions(r, &match_case->instructions);
+            vector_push(&fc->match_instr->cases, match_case);
+        }
+
+        fc->match_instr->has_else = read_byte(r);
+        read_instructions(r, &fc->match_instr->else_instrs);
+        break;
+      }
+
+      default:
+        read_error(r, "unknown flowcontrol instruction");
+        fc->type = FLOWCONTROL_TYPE_WHILE;
+        fc->while_instr = while_instr_new(NULL);
+        break;
+    }
+}
+
+static instruction_t* read_instruction(object_reader_t* r) {
+    uint8_t tag = read_byte(r);
+
+    if (tag > INSTRUCTION_TYPE_AFFECTATION) {
+        read_error(r, "unknown instruction");
+    }
+    if (r->error) {
+        /* An empty expression instruction is always safe to delete. */
+        return instruction_new(INSTRUCTION_TYPE_EXPRESSION);
+    }
+
+    instruction_t* instr = instruction_new(tag);
+
+    switch (instr->type) {
+      case INSTRUCTION_TYPE_PRINT:
+        parameters_init(&instr->parameters);
+        read_parameters(r, &instr->parameters);
+        break;
+
+      case INSTRUCTION_TYPE_READ:
+        instr->valref = read_valref(r);
+        break;
+
+      case INSTRUCTION_TYPE_RETURN:
+      case INSTRUCTION_TYPE_EXPRESSION:
+        instr->expression = read_expression(r);
+        break;
+
+      case INSTRUCTION_TYPE_FLOWCONTROL:
+        read_flowcontrol(r, &instr->flowcontrol);
+        break;
+
+      case INSTRUCTION_TYPE_AFFECTATION:
+        instr->affectation.lvalue = read_valref(r);
+        instr->affectation.expression = read_expression(r);
+        break;
+    }
+
+    return instr;
+}
+
+static void read_instructions(object_reader_t* r, vector_t* instrs) {
+    uint64_t ninstrs = read_natural(r);
+
+    for (uint64_t i = 0; i < ninstrs && !r->error; i++) {
+        vector_push(instrs, read_instruction(r));
+    }
+}
+
+static function_t* read_function(object_reader_t* r) {
+    identifier_t id;
+
+    read_identifier(r, &id);
+
+    function_t* function = function_new(&id);
+    function_set_return_type(function, read_type(r));
+
+    uint64_t nargs = read_natural(r);
+    for (uint64_t i = 0; i < nargs && !r->error; i++) {
+        access_type_t access_type = read_byte(r);
+        vector_push(&function->args,
+                    function_arg_new(access_type, read_symbol(r)));
+    }
+
+    uint64_t nlocals = read_natural(r);
+    for (uint64_t i = 0; i < nlocals && !r->error; i++) {
+        function_add_local(function, read_symbol(r));
+    }
+
+    read_instructions(r, &function->instructions);
+
+    return function;
+}
+
+static void read_functions(object_reader_t* r, vector_t* functions) {
+    uint64_t nfunctions = read_natural(r);
+
+    for (uint64_t i = 0; i < nfunctions && !r->error; i++) {
+        vector_push(functions, read_function(r));
+    }
+}
+
+static void read_structures(object_reader_t* r, vector_t* structures) {
+    uint64_t nstructures = read_natural(r);
+
+    for (uint64_t i = 0; i < nstructures && !r->error; i++) {
+        identifier_t id;
+
+        read_identifier(r, &id);
+        vector_push(structures, structure_new(&id));
+    }
+}
+
+bool program_is_object(FILE* input) {
+    char magic[sizeof(EZ_OBJECT_MAGIC)] = "";
+    long offset = ftell(input);
+    size_t length = strlen(EZ_OBJECT_MAGIC);
+    bool is_object = fread(magic, 1, length, input) == length
+                  && memcmp(magic, EZ_OBJECT_MAGIC, length) == 0;
+
+    fseek(input, offset, SEEK_SET);
+    return is_object;
+}
+
+program_t* program_read_object(FILE* input) {
+    identifier_t id;
+    object_reader_t r = {
+        .input = input,
+        .program = NULL,
+        .error = false,
+    };
+
+    if (!program_is_object(input)) {
+        fprintf(stderr, "invalid EZ object: bad magic\n");
+        return NULL;
+    }
+    fseek(input, strlen(EZ_OBJECT_MAGIC), SEEK_CUR);
+
+    uint64_t version = read_natural(&r);
+    if (version != EZ_OBJECT_VERSION) {
+        fprintf(stderr, "EZ object version %lu is not supported (expected "
+                        "version %d)\n", (unsigned long)version,
+                        EZ_OBJECT_VERSION);
+        return NULL;
+    }
+
+    read_identifier(&r, &id);
+    r.program = program_new(&id);
+
+    uint64_t nenumerations = read_natural(&r);
+    for (uint64_t i = 0; i < nenumerations && !r.error; i++) {
+        identifier_t enumeration_id;
+
+        read_identifier(&r, &enumeration_id);
+        enumeration_t* enumeration = enumeration_new(&enumeration_id);
+        program_add_enumeration(r.program, enumeration);
+
+        uint64_t nmembers = read_natural(&r);
+        for (uint64_t j = 0; j < nmembers && !r.error; j++) {
+            identifier_t member;
+
+            read_identifier(&r, &member);
+            enumeration_add_member(enumeration, &member);
+        }
+    }
+
+    read_structures(&r, &r.program->builtin_structures);
+    read_structures(&r, &r.program->structures);
+    for (int i = 0; i < r.program->structures.size && !r.error; i++) {
+        structure_t* structure = r.program->structures.elements[i];
+        uint64_t nmembers = read_natural(&r);
+
+        for (uint64_t j = 0; j < nmembers && !r.error; j++) {
+            structure_add_member(structure, read_symbol(&r));
+        }
+    }
+
+    read_functions(&r, &r.program->builtin_functions);
+    read_functions(&r, &r.program->builtin_procedures);
+
+    uint64_t nconstants = read_natural(&r);
+    for (uint64_t i = 0; i < nconstants && !r.error; i++) {
+        symbol_t* symbol = read_symbol(&r);
+        program_add_constant(r.program,
+                             constant_new(symbol, read_expression(&r)));
+    }
+
+    uint64_t nglobals = read_natural(&r);
+    for (uint64_t i = 0; i < nglobals && !r.error; i++) {
+        program_add_global(r.program, read_symbol(&r));
+    }
+
+    read_functions(&r, &r.program->functions);
+    read_functions(&r, &r.program->procedures);
+
+    if (r.error) {
+        program_delete(r.program);
+        return NULL;
+    }
+
+    return r.program;
+}
@@ -74,16 +74,16 @@ parser_status_t identifier_parser(FILE* input, context_t* ctx,
                               "AZERTYUIOPQSDFGHJKLMWXCVBN"
                               "0123456789"
                               "_";
-    char value[1024];
-    char* value_ptr = value;
+    parser_slice_t slice = {.offset = ftell(input), .length = 0};
 
-    PARSE(char_parser(input, id_charset_first, &value_ptr));
+    PARSE(char_parser(input, id_charset_first, NULL));
 
-    PARSE_MANY(input, char_parser(input, id_charset, &value_ptr));
+    PARSE_MANY(input, char_parser(input, id_charset, NULL));
 
-    if (!identifier_set_value(id, value)) {
-        PARSER_LANG_ERR("identifier %s is too long (%d max chars)",
-                            value, IDENTIFIER_SIZE);
+    slice_extend(input, &slice);
+    if (!slice_copy(input, &slice, id->value, IDENTIFIER_SIZE)) {
+        PARSER_LANG_ERR("identifier of %zu chars is too long (%d max chars)",
+                        slice.length, IDENTIFIER_SIZE - 1);
     }
 
     if (identifier_is_reserved(id)) {
@@ -161,6 +161,10 @@ parser_status_t type_parser(FILE* input, context_t* ctx,
         *type = type_string_new();
         return PARSER_SUCCESS;
     } else
+    if (TRY(input, word_parser(input, "char", NULL)) == PARSER_SUCCESS) {
+        *type = type_char_new();
+        return PARSER_SUCCESS;
+    } else
     if (TRY(input, word_parser(input, "vector", NULL)) == PARSER_SUCCESS) {
         PARSE_ERR(space_parser(input, NULL, NULL),
                   "expected spaces after 'vector'");
@@ -194,6 +198,80 @@ parser_status_t type_parser(FILE* input, context_t* ctx,
 
         return PARSER_SUCCESS;
     } else
+    if (TRY(input, word_parser(input, "map", NULL)) == PARSER_SUCCESS) {
+        PARSE_ERR(space_parser(input, NULL, NULL),
+                  "expected spaces after 'map'");
+        SKIP_MANY(input, space_parser(input, NULL, NULL));
+
+        PARSE_ERR(word_parser(input, "of", NULL),
+                  "expected 'of' after map");
+
+        PARSE_ERR(space_parser(input, NULL, NULL),
+                  "expected spaces after 'of'");
+        SKIP_MANY(input, space_parser(input, NULL, NULL));
+
+        type_t* key;
+        PARSE_ERR(type_parser(input, ctx, &key),
+                  "invalid key type for 'map'");
+        if (!type_is_map_key(key)) {
+            char key_name[512] = "";
+            type_print_ez(key, key_name);
+            type_delete(key);
+            PARSER_LANG_ERR("invalid map key type '%s' (keys must be of a "
+                            "primitive type or strings)", key_name);
+        }
+
+        PARSE_ERR(space_parser(input, NULL, NULL),
+                  "expected spaces after the map key type");
+        SKIP_MANY(input, space_parser(input, NULL, NULL));
+
+        PARSE_ERR(word_parser(input, "to", NULL),
+                  "expected 'to' after the map key type");
+
+        PARSE_ERR(space_parser(input, NULL, NULL),
+                  "expected spaces after 'to'");
+        SKIP_MANY(input, space_parser(input, NULL, NULL));
+
+        type_t* value;
+        PARSE_ERR(type_parser(input, ctx, &value),
+                  "invalid value type for 'map'");
+
+        *type = type_map_new(key, value);
+
+        return PARSER_SUCCESS;
+    } else
+    if (TRY(input, word_parser(input, "array", NULL)) == PARSER_SUCCESS) {
+        PARSE_ERR(space_parser(input, NULL, NULL),
+                  "expected spaces after 'array'");
+        SKIP_MANY(input, space_parser(input, NULL, NULL));
+
+        PARSE_ERR(word_parser(input, "of", NULL),
+                  "expected 'of' after array");
+
+        PARSE_ERR(space_parser(input, NULL, NULL),
+                  "expected spaces after 'of'");
+        SKIP_MANY(input, space_parser(input, NULL, NULL));
+
+        unsigned int size;
+        PARSE_ERR(natural_parser(input, NULL, &size),
+                  "expected the number of elements of the array");
+        if (size == 0) {
+            PARSER_LANG_ERR("invalid array size %u (an array has at least "
+                            "one element)", size);
+        }
+
+        PARSE_ERR(space_parser(input, NULL, NULL),
+                  "expected spaces after the array size");
+        SKIP_MANY(input, space_parser(input, NULL, NULL));
+
+        type_t* of;
+        PARSE_ERR(type_parser(input, ctx, &of),
+                  "invalid type for 'array'");
+
+        *type = type_array_new(of, size);
+
+        return PARSER_SUCCESS;
+    } else
     if (TRY(input, word_parser(input, "function", NULL)) == PARSER_SUCCESS) {
         function_signature_t* signature = NULL;
         SKIP_MANY(input, space_parser(input, NULL, NULL));
@@ -207,7 +285,16 @@ parser_status_t type_parser(FILE* input, context_t* ctx,
         structure_t* structure = context_find_structure(ctx, &structure_id);
 
         if (structure == NULL) {
-            return PARSER_FAILURE;
+            enumeration_t* enumeration =
+                context_find_enumeration(ctx, &structure_id);
+
+            if (enumeration == NULL) {
+                return PARSER_FAILURE;
+            }
+
+            *type = type_enumeration_new(enumeration);
+
+            return PARSER_SUCCESS;
         }
 
         /* XXX so type carry a const structure, it doesn't own it. */
@@ -211,6 +211,12 @@ parser_status_t for_parser(FILE* input, context_t* ctx,
                            for_instr_t** for_instr)
 {
     identifier_t id;
+    bool is_parallel = false;
+
+    if (TRY(input, word_parser(input, "parallel ", NULL)) == PARSER_SUCCESS) {
+        is_parallel = true;
+        SKIP_MANY(input, space_parser(input, NULL, NULL));
+    }
 
     PARSE(word_parser(input, "for", NULL));
 
@@ -235,6 +241,7 @@ parser_status_t for_parser(FILE* input, context_t* ctx,
     }
 
     *for_instr = for_instr_new(&id);
+    (*for_instr)->is_parallel = is_parallel;
 
     PARSE_ERR(space_parser(input, NULL, NULL),
           "a space is expcted after for identifier");
@@ -265,6 +272,10 @@ parser_status_t for_parser(FILE* input, context_t* ctx,
     PARSE_ERR(word_parser(input, "endfor", NULL),
               "a 'endfor' keyword is expected to close a 'for' block");
 
+    if (is_parallel && !parallel_for_is_valid(input, ctx, *for_instr)) {
+        ctx->error_prg = true;
+    }
+
     return PARSER_SUCCESS;
 }
 
@@ -296,6 +307,108 @@ parser_status_t loop_parser(FILE* input, context_t* ctx,
     return PARSER_SUCCESS;
 }
 
+/* Parses the values and the instructions of a case in `match_case`. */
+static parser_status_t _case_parser(FILE* input, context_t* ctx,
+                                    match_case_t* match_case)
+{
+    expression_t* value = NULL;
+
+    do {
+        SKIP_MANY(input, space_parser(input, NULL, NULL));
+
+        PARSE_ERR(expression_parser(input, ctx, &value),
+                  "a 'case' must be followed by the values it handles");
+        vector_push(&match_case->values, value);
+
+        SKIP_MANY(input, space_parser(input, NULL, NULL));
+    } while (TRY(input, char_parser(input, ",", NULL)) == PARSER_SUCCESS);
+
+    PARSE_ERR(word_parser(input, "do", NULL),
+              "a 'do' keyword must follow the 'case' values");
+
+    PARSE_ERR(end_of_line_parser(input, NULL, NULL),
+              "a new line is expected after the case 'do' keyword");
+
+    PARSE(instructions_parser(input, ctx, &match_case->instructions));
+
+    return PARSER_SUCCESS;
+}
+
+static parser_status_t case_parser(FILE* input, context_t* ctx,
+                                   match_case_t** match_case)
+{
+    PARSE(word_parser(input, "case", NULL));
+
+    PARSE_ERR(space_parser(input, NULL, NULL),
+              "a space is expected after the 'case' keyword");
+
+    *match_case = match_case_new();
+    parser_status_t status = _case_parser(input, ctx, *match_case);
+    if (status != PARSER_SUCCESS) {
+        match_case_delete(*match_case);
+        *match_case = NULL;
+    }
+    return status;
+}
+
+/* Parses what follows the subject of a match in `match_instr`. */
+static parser_status_t _match_parser(FILE* input, context_t* ctx,
+                                     match_instr_t* match_instr)
+{
+    match_case_t* match_case = NULL;
+
+    PARSE_ERR(end_of_line_parser(input, NULL, NULL),
+              "a new line is expected after the 'match' expression");
+
+    SKIP_MANY(input, comment_or_empty_parser(input, NULL, NULL));
+
+    while (TRY(input, case_parser(input, ctx, &match_case))
+           == PARSER_SUCCESS)
+    {
+        vector_push(&match_instr->cases, match_case);
+        SKIP_MANY(input, comment_or_empty_parser(input, NULL, NULL));
+    }
+
+    if (TRY(input, else_parser(input, ctx, &match_instr->else_instrs))
+        == PARSER_SUCCESS)
+    {
+        match_instr->has_else = true;
+    }
+
+    SKIP_MANY(input, comment_or_empty_parser(input, NULL, NULL));
+
+    PARSE_ERR(word_parser(input, "endmatch", NULL),
+              "a 'match' must be closed with the 'endmatch' keyword");
+
+    if (!match_instr_is_valid(input, ctx, match_instr)) {
+        ctx->error_prg = true;
+    }
+
+    return PARSER_SUCCESS;
+}
+
+parser_status_t match_parser(FILE* input, context_t* ctx,
+                             match_instr_t** match_instr)
+{
+    expression_t* subject = NULL;
+
+    PARSE(word_parser(input, "match", NULL));
+
+    PARSE(space_parser(input, NULL, NULL));
+    SKIP_MANY(input, space_parser(input, NULL, NULL));
+
+    PARSE_ERR(expression_parser(input, ctx, &subject),
+              "a valid expression is expected after the 'match' keyword");
+
+    *match_instr = match_instr_new(subject);
+    parser_status_t status = _match_parser(input, ctx, *match_instr);
+    if (status != PARSER_SUCCESS) {
+        match_instr_delete(*match_instr);
+        *match_instr = NULL;
+    }
+    return status;
+}
+
 parser_status_t flowcontrol_parser(FILE* input, context_t* ctx,
                                    flowcontrol_t* flowcontrol)
 {
@@ -329,6 +442,12 @@ parser_status_t flowcontrol_parser(FILE* input, context_t* ctx,
     {
         flowcontrol->type = FLOWCONTROL_TYPE_LOOP;
         return PARSER_SUCCESS;
+    } else
+    if (TRY(input, match_parser(input, ctx, &flowcontrol->match_instr))
+        == PARSER_SUCCESS)
+    {
+        flowcontrol->type = FLOWCONTROL_TYPE_MATCH;
+        return PARSER_SUCCESS;
     }
 
     return PARSER_FAILURE;
@@ -1,21 +1,26 @@
 #include <string.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <limits.h>
 #include "ez-parser.h"
 #include "ez-lang-errors.h"
 
 parser_status_t character_parser(FILE* input, const void* args,
                                  char* output)
 {
-    char chars[512];
-    char* chars_ptr = chars;
+    char chars[2];
+    parser_slice_t slice;
 
     PARSE(char_parser(input, "'", NULL));
     /*  TODO handling escaping */
-    PARSE_ERR(char_parser(input, NULL, &chars_ptr),
+    slice.offset = ftell(input);
+    PARSE_ERR(char_parser(input, NULL, NULL),
               "couldn't parse character");
+    slice_extend(input, &slice);
     PARSE_ERR(char_parser(input, "'", NULL),
               "unclosed character");
 
+    slice_copy(input, &slice, chars, sizeof(chars));
     *output = chars[0];
     return PARSER_SUCCESS;
 }
@@ -23,23 +28,28 @@ parser_status_t character_parser(FILE* input, const void* args,
 parser_status_t string_parser(FILE* input, const void* args,
                               char** output)
 {
-    char string[512];
-    char *string_ptr = string;
+    parser_slice_t slice;
 
     PARSE(char_parser(input, "\"", NULL));
-    PARSE(until_char_parser(input, "\"", &string_ptr));
+    slice.offset = ftell(input);
 
-    /* Handling " escaping */
-    while (*(string_ptr - 1) == '\\') {
-        PARSE(char_parser(input, "\"", &string_ptr));
-        PARSE(until_char_parser(input, "\"", &string_ptr));
+    /* Handling escaping: an escaped char (like \") never closes the string */
+    PARSE(until_char_parser(input, "\"\\", NULL));
+    while (TRY(input, char_parser(input, "\\", NULL)) == PARSER_SUCCESS) {
+        PARSE(char_parser(input, NULL, NULL));
+        PARSE(until_char_parser(input, "\"\\", NULL));
     }
+    slice_extend(input, &slice);
+
     PARSE_ERR(char_parser(input, "\"", NULL),
               "unclosed string");
 
-    int string_len = strlen(string);
-    *output = malloc((string_len + 1) * sizeof(char));
-    strcpy(*output, string);
+    /* The string is only copied once, when it is known to be valid. */
+    *output = slice_dup(input, &slice);
+    if (!*output) {
+        PARSER_LANG_ERR("couldn't allocate a string of %zu chars",
+                        slice.length);
+    }
 
     return PARSER_SUCCESS;
 }
@@ -47,14 +57,24 @@ parser_status_t string_parser(FILE* input, const void* args,
 parser_status_t natural_parser(FILE* input, const void* args,
                                unsigned int* output)
 {
-    char buf[512];
-    char *buf_ptr = buf;
+    char buf[32] = "";
+    parser_slice_t slice;
+    unsigned long natural;
 
-    PARSE(chars_parser(input, "0123456789", &buf_ptr));
+    PARSE(chars_slice_parser(input, "0123456789", &slice));
+
+    if (!slice_copy(input, &slice, buf, sizeof(buf))) {
+        PARSER_LANG_ERR("natural number of %zu chars is too long",
+                        slice.length);
+    }
 
-    if (sscanf(buf, "%u", output) != 1) {
-        PARSER_LANG_ERR("invalid natural number '%s'", buf);
+    /* The slice only has digits, only their value can be invalid. */
+    errno = 0;
+    natural = strtoul(buf, NULL, 10);
+    if (errno == ERANGE || natural > UINT_MAX) {
+        PARSER_LANG_ERR("natural number '%s' is too big", buf);
     }
+    *output = natural;
 
     return PARSER_SUCCESS;
 }
@@ -78,25 +98,22 @@ parser_status_t integer_parser(FILE* input, const void* args,
 parser_status_t real_parser(FILE* input, const void* args,
                             double* output)
 {
-    double signe = 1.0;
-    unsigned int integer = 0;
-    unsigned int decimal = 0;
-    double true_decimal = 0.0;
+    char buf[64] = "";
+    parser_slice_t slice;
 
-    if (TRY(input, char_parser(input, "-", NULL)) == PARSER_SUCCESS) {
-        signe = -1.0;
-    }
-
-    PARSE(natural_parser(input, NULL, &integer));
+    slice.offset = ftell(input);
+    TRY(input, char_parser(input, "-", NULL));
+    PARSE(chars_parser(input, "0123456789", NULL));
     PARSE(char_parser(input, ".", NULL));
-    PARSE(natural_parser(input, NULL, &decimal));
+    PARSE(chars_parser(input, "0123456789", NULL));
+    slice_extend(input, &slice);
 
-    true_decimal = decimal;
-    while (true_decimal > 1.0) {
-        true_decimal *= 0.1;
+    /* strtod gives the nearest double of the whole literal, where summing
+     * the integer and decimal parts would round twice. */
+    if (!slice_copy(input, &slice, buf, sizeof(buf))) {
+        PARSER_LANG_ERR("real number of %zu chars is too long", slice.length);
     }
-
-    *output = signe * (integer + true_decimal);
+    *output = strtod(buf, NULL);
 
     return PARSER_SUCCESS;
 }
@@ -241,6 +258,7 @@ parser_status_t value_parser(FILE* input, context_t* ctx,
         == PARSER_SUCCESS)
     {
         value->type = VALUE_TYPE_NATURAL;
+        value->is_unsigned = false;
         return PARSER_SUCCESS;
     }  else
     if (TRY(input, integer_parser(input, NULL, &value->integer))
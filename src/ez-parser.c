@@ -397,11 +397,79 @@ parser_status_t structure_parser(FILE* input,
     return PARSER_SUCCESS;
 }
 
+parser_status_t enumeration_parser(FILE* input,
+                                   context_t* ctx,
+                                   enumeration_t* *enumeration)
+{
+    identifier_t id;
+
+    PARSE(word_parser(input, "enumeration", NULL));
+
+    PARSE_ERR(space_parser(input, NULL, NULL),
+              "a space must follow the 'enumeration' keyword");
+    SKIP_MANY(input, space_parser(input, NULL, NULL));
+
+    PARSE_ERR(identifier_parser(input, NULL, &id),
+              "an enumeration must have a valid identifier");
+
+    *enumeration = enumeration_new(&id);
+    if (context_has_identifier(ctx, &(*enumeration)->identifier)) {
+        ctx->error_prg = true;
+        error_identifier_exists(input, &(*enumeration)->identifier);
+        enumeration_delete(*enumeration);
+        return PARSER_FATAL;
+    }
+    program_add_enumeration(ctx->program, *enumeration);
+
+    PARSE_ERR(space_parser(input, NULL, NULL),
+              "a space must follow the enumeration identifier");
+    SKIP_MANY(input, space_parser(input, NULL, NULL));
+
+    PARSE_ERR(word_parser(input, "is", NULL),
+              "a 'is' keyword must follow the enumeration identifier");
+
+    PARSE_ERR(end_of_line_parser(input, NULL, NULL),
+              "a new line is expected after the enumeration 'is' keyword");
+
+    SKIP_MANY(input, empty_parser(input, NULL, NULL));
+
+    while (TRY(input, word_parser(input, "end", NULL)) == PARSER_FAILURE) {
+        identifier_t member;
+
+        PARSE_ERR(identifier_parser(input, NULL, &member),
+                  "an enumeration member must be a valid identifier");
+
+        /* Members are used by their bare identifier, so they must be unique
+         * in the whole program. */
+        if (context_has_identifier(ctx, &member)) {
+            ctx->error_prg = true;
+            error_identifier_exists(input, &member);
+        } else {
+            enumeration_add_member(*enumeration, &member);
+        }
+
+        SKIP_MANY(input, space_parser(input, NULL, NULL));
+        TRY(input, char_parser(input, ",", NULL));
+        SKIP_MANY(input, empty_parser(input, NULL, NULL));
+    }
+
+    if ((*enumeration)->members.size == 0 && !ctx->error_prg) {
+        PARSER_LANG_ERR("the enumeration '%s' must have at least one member",
+                        (*enumeration)->identifier.value);
+    }
+
+    PARSE_ERR(end_of_line_parser(input, NULL, NULL),
+              "a new line is expected after the enumeration 'end' keyword");
+
+    return PARSER_SUCCESS;
+}
+
 parser_status_t entity_parser(FILE* input, context_t* ctx,
                               program_t* program)
 {
     function_t* func = NULL;
     structure_t* structure = NULL;
+    enumeration_t* enumeration = NULL;
     constant_t* constant = NULL;
     symbol_t* global = NULL;
 
@@ -435,6 +503,11 @@ parser_status_t entity_parser(FILE* input, context_t* ctx,
     {
         return PARSER_SUCCESS;
     } else
+    if (TRY(input, enumeration_parser(input, ctx, &enumeration))
+        == PARSER_SUCCESS)
+    {
+        return PARSER_SUCCESS;
+    } else
     if (TRY(input, function_parser(input, ctx, &func)) == PARSER_SUCCESS) {
         return PARSER_SUCCESS;
     } else
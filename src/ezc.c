@@ -1,27 +1,88 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <getopt.h>
 #include "ez-parser.h"
 #include "ez-lang.h"
+#include "ez-object.h"
 
 static void help(void) {
     printf( "usage: ezc [options] source\n"
+            "source is either an EZ source file or an EZ object file.\n"
             "options are:\n"
             " -h        see this help\n"
+            " -c object also write the checked program as an EZ object file\n"
+            " -O level  optimization level: 0 disables optimizations, 1 (the\n"
+            "           default) folds constant expressions and branches,\n"
+            "           hoists invariant loop bounds and moves the locals at\n"
+            "           their last use\n"
+            " --keep-all\n"
+            "           generate all entities, even the ones that can't be\n"
+            "           reached from the main function\n"
+            " --template-lambdas\n"
+            "           generate the functions taking function arguments as\n"
+            "           templates, so the lambdas given to them are inlined\n"
           );
 }
 
+static bool write_object(const char* object_path, const program_t* prg) {
+    FILE* output = fopen(object_path, "wb");
+    if (output == NULL) {
+        fprintf(stderr, "couldn't open object file \"%s\"\n", object_path);
+        return false;
+    }
+
+    bool written = program_write_object(output, prg);
+    if (fclose(output) != 0 || !written) {
+        fprintf(stderr, "couldn't write object file \"%s\"\n", object_path);
+        unlink(object_path);
+        return false;
+    }
+    return true;
+}
+
 int main(int argc, char** argv) {
     int opt = 0;
     char* input_path = NULL;
-    char* output_path = NULL;
+    char* object_path = NULL;
+    int optimization_level = 1;
+    bool keep_all = false;
+    codegen_options_t codegen_options = (codegen_options_t){
+        .template_lambdas = false,
+    };
     context_t ctx;
 
-    while ((opt = getopt(argc, argv, "h")) >= 0) {
+    static const struct option long_options[] = {
+        {"keep-all",            no_argument,    NULL,   'k'},
+        {"template-lambdas",    no_argument,    NULL,   't'},
+        {NULL,                  0,              NULL,   0},
+    };
+
+    while ((opt = getopt_long(argc, argv, "hc:O:", long_options, NULL)) >= 0) {
         switch (opt) {
             case 'h':
                 help();
                 return 0;
+
+            case 'c':
+                object_path = optarg;
+                break;
+
+            case 'O':
+                optimization_level = atoi(optarg);
+                break;
+
+            case 'k':
+                keep_all = true;
+                break;
+
+            case 't':
+                codegen_options.template_lambdas = true;
+                break;
+
+            default:
+                help();
+                return 1;
         }
     }
 
@@ -31,18 +92,53 @@ int main(int argc, char** argv) {
     }
 
     input_path = argv[optind];
-    output_path = argv[optind + 1];
 
     program_t* prg = NULL;
     FILE* input = fopen(input_path, "r");
+    if (input == NULL) {
+        fprintf(stderr, "couldn't open source file \"%s\"\n", input_path);
+        return 1;
+    }
+
+    if (program_is_object(input)) {
+        /* Objects are already checked, skip the whole front-end. */
+        prg = program_read_object(input);
+        if (prg == NULL) {
+            fprintf(stderr, "Couldn't load object file\n");
+            goto error;
+        }
+    } else
     if (program_parser(input, &ctx, &prg) != PARSER_SUCCESS) {
         fprintf(stderr, "Program has invalid syntax\n");
         goto error;
     } else if (ctx.error_prg) {
         fprintf(stderr, "Program has semantic error\n");
         goto error;
-    } else {
-        program_print(stdout, prg);
+    }
+
+    if (object_path && !write_object(object_path, prg)) {
+        goto error;
+    }
+
+    if (optimization_level > 0) {
+        program_optimize(prg);
+    }
+    if (!keep_all) {
+        program_remove_unreachable(prg);
+    }
+    if (optimization_level > 0) {
+        program_hoist_loop_bounds(prg);
+        program_mark_last_uses(prg);
+    }
+
+    emitter_t emitter;
+    emitter_init(&emitter, 64 * 1024);
+    program_print(&emitter, prg, &codegen_options);
+    bool written = emitter_flush(&emitter, stdout);
+    emitter_wipe(&emitter);
+    if (!written) {
+        fprintf(stderr, "couldn't write the generated code\n");
+        goto error;
     }
 
     program_delete(prg);
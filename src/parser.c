@@ -1,3 +1,4 @@
+#include <stdlib.h>
 #include <string.h>
 #include "parser.h"
 
@@ -84,6 +85,65 @@ parser_status_t until_word_parser(FILE* input, const char* word, char** output)
     return PARSER_SUCCESS;
 }
 
+parser_status_t chars_slice_parser(FILE* input, const char* allowed,
+                                   parser_slice_t* slice)
+{
+    slice->offset = ftell(input);
+    slice->length = 0;
+
+    PARSE(chars_parser(input, allowed, NULL));
+
+    slice_extend(input, slice);
+    return PARSER_SUCCESS;
+}
+
+parser_status_t until_char_slice_parser(FILE* input, const char* c,
+                                        parser_slice_t* slice)
+{
+    slice->offset = ftell(input);
+    slice->length = 0;
+
+    PARSE(until_char_parser(input, c, NULL));
+
+    slice_extend(input, slice);
+    return PARSER_SUCCESS;
+}
+
+void slice_extend(FILE* input, parser_slice_t* slice) {
+    slice->length = ftell(input) - slice->offset;
+}
+
+bool slice_copy(FILE* input, const parser_slice_t* slice,
+                char* output, size_t size)
+{
+    long offset = ftell(input);
+    size_t read = 0;
+
+    if (slice->length >= size) {
+        return false;
+    }
+
+    if (slice->length > 0) {
+        fseek(input, slice->offset, SEEK_SET);
+        read = fread(output, 1, slice->length, input);
+        fseek(input, offset, SEEK_SET);
+    }
+    output[read] = '\0';
+
+    return read == slice->length;
+}
+
+char* slice_dup(FILE* input, const parser_slice_t* slice) {
+    char* output = malloc(slice->length + 1);
+
+    if (!output) {
+        fprintf(stderr, "couldn't allocate slice\n");
+        return NULL;
+    }
+
+    slice_copy(input, slice, output, slice->length + 1);
+    return output;
+}
 
 void get_file_coordinates(FILE* f, int* line, int* column, char* c) {
     long offset = ftell(f);
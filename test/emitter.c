@@ -0,0 +1,71 @@
+#include <assert.h>
+#include <string.h>
+#include <limits.h>
+#include <stdio.h>
+#include "emitter.h"
+
+int main(void) {
+    emitter_t emitter;
+
+    emitter_init(&emitter, 0);
+    assert(emitter_size(&emitter) == 0);
+    assert(strcmp(emitter_data(&emitter), "") == 0);
+
+    emitter_puts(&emitter, "int");
+    emitter_putc(&emitter, ' ');
+    emitter_put_int(&emitter, -42);
+    emitter_putc(&emitter, ' ');
+    emitter_put_uint(&emitter, 0);
+    emitter_putc(&emitter, ' ');
+    emitter_put_int(&emitter, LONG_MIN);
+    emitter_printf(&emitter, " %s=%.1f", "x", 2.5);
+    char expected[64];
+    sprintf(expected, "int -42 0 %ld x=2.5", LONG_MIN);
+    assert(strcmp(emitter_data(&emitter), expected) == 0);
+    assert(emitter_size(&emitter) == strlen(expected));
+
+    /* Indentation is applied at the start of non empty lines. */
+    emitter_clear(&emitter);
+    emitter_puts(&emitter, "f() {\n");
+    emitter_indent(&emitter);
+    emitter_puts(&emitter, "a;\n\nif (b) {\n");
+    emitter_indent(&emitter);
+    emitter_puts(&emitter, "c");
+    emitter_puts(&emitter, ";\n");
+    emitter_dedent(&emitter);
+    emitter_puts(&emitter, "}\n");
+    emitter_dedent(&emitter);
+    emitter_puts(&emitter, "}\n");
+    assert(strcmp(emitter_data(&emitter),
+                  "f() {\n"
+                  "    a;\n"
+                  "\n"
+                  "    if (b) {\n"
+                  "        c;\n"
+                  "    }\n"
+                  "}\n") == 0);
+
+    /* Large outputs grow the buffer, including through printf. */
+    emitter_clear(&emitter);
+    char line[300];
+    memset(line, 'z', sizeof(line) - 1);
+    line[sizeof(line) - 1] = '\0';
+    for (int i = 0; i < 100; i++) {
+        emitter_printf(&emitter, "%s\n", line);
+    }
+    assert(emitter_size(&emitter) == 100 * sizeof(line));
+
+    /* Flush writes everything at once and empties the emitter. */
+    char* buffer = NULL;
+    size_t size = 0;
+    FILE* f = open_memstream(&buffer, &size);
+    assert(emitter_flush(&emitter, f));
+    fclose(f);
+    assert(size == 100 * sizeof(line));
+    assert(emitter_size(&emitter) == 0);
+    free(buffer);
+
+    emitter_wipe(&emitter);
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "ez-lang.h"
+#include "ez-test.h"
+
+char source[] =
+    "program arrays_test\n"
+    "\n"
+    "structure particle is\n"
+    "    position is array of 3 real\n"
+    "end\n"
+    "\n"
+    "structure noeud is\n"
+    "    enfants is array of 2 optional noeud\n"
+    "    paire is optional array of 2 noeud\n"
+    "end\n"
+    "\n"
+    "function trace(in m is array of 4 array of 4 real) return real\n"
+    "    local i is natural\n"
+    "    local t is real\n"
+    "begin\n"
+    "    for i in 0 .. m.size() do\n"
+    "        t = t + m[i][i]\n"
+    "    endfor\n"
+    "    return t\n"
+    "end\n"
+    "\n"
+    "function arrays_test(in args is vector of string) return integer\n"
+    "    local p is particle\n"
+    "    local m is array of 4 array of 4 real\n"
+    "begin\n"
+    "    p.position[2] = 1\n"
+    "    m[3][3] = trace(m)\n"
+    "    return 0\n"
+    "end\n";
+
+/* The programs checked, with an instruction instead of "%s". */
+static const char fixture[] =
+    "program invalid\n"
+    "\n"
+    "constant K is natural = 3\n"
+    "constant LAST is natural = K - 1\n"
+    "\n"
+    "function invalid(in args is vector of string) return integer\n"
+    "    local a is array of 3 integer\n"
+    "    local b is array of 2 integer\n"
+    "begin\n"
+    "    %s\n"
+    "    return 0\n"
+    "end\n";
+
+int main(void) {
+    program_t* prg = parse_program(source);
+
+    char* code = print_program(prg, NULL);
+
+    assert(strstr(code, "ez::array< double, 3 > position ;"));
+    assert(strstr(code, "double trace(const ez::array< ez::array< "
+                        "double, 4 >, 4 >& m)"));
+    assert(strstr(code, "p.position.at(2) = 1;"));
+
+    /* Arrays store their optionals inline, recursive ones must be boxed. */
+    assert(strstr(code, "struct optional_is_boxed< noeud > : "
+                        "std::true_type {};"));
+    assert(strstr(code, "struct optional_is_boxed< ez::array< noeud, 2 > > : "
+                        "std::true_type {};"));
+
+    free(code);
+    program_delete(prg);
+
+    /* Constant indexes are checked at compile time. */
+    assert(snippet_is_valid(fixture, "a[2] = 1"));
+    assert(!snippet_is_valid(fixture, "a[3] = 1"));
+    assert(!snippet_is_valid(fixture, "a[-1] = 1"));
+    assert(!snippet_is_valid(fixture, "print b[2]"));
+    assert(snippet_is_valid(fixture, "a[LAST] = 1"));
+    assert(!snippet_is_valid(fixture, "a[K] = 1"));
+    assert(snippet_is_valid(fixture, "a[1 + 1] = 1"));
+    assert(!snippet_is_valid(fixture, "a[1 + 2] = 1"));
+    assert(!snippet_is_valid(fixture, "a[K * 2 - 1] = 1"));
+
+    /* The size is part of the type. */
+    assert(!snippet_is_valid(fixture, "a = b"));
+    assert(!snippet_is_valid(fixture, "a.push(1)"));
+
+    return 0;
+}
@@ -16,7 +16,11 @@ int main(int argc, char** argv) {
     if (expression_parser(f, NULL, &expr) != PARSER_SUCCESS) {
         printf("invalid expression\n");
     } else {
-        expression_print(stdout, NULL, expr);
+        emitter_t emitter;
+        emitter_init(&emitter, 0);
+        expression_print(&emitter, NULL, expr);
+        emitter_flush(&emitter, stdout);
+        emitter_wipe(&emitter);
         printf("\n");
         expression_delete(expr);
     }
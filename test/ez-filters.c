@@ -0,0 +1,56 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "ez-lang.h"
+#include "ez-test.h"
+
+/* The programs checked, with an instruction instead of "%s". */
+static const char fixture[] =
+    "program invalid\n"
+    "\n"
+    "procedure filters(in input is vector of integer,\n"
+    "                  inout v is vector of integer)\n"
+    "    local w is vector of integer\n"
+    "    local r is vector of real\n"
+    "    local keep is function(in integer) return boolean\n"
+    "begin\n"
+    "    keep = lambda (in x is integer) return boolean is return x > 0\n"
+    "    %s\n"
+    "end\n"
+    "\n"
+    "function invalid(in args is vector of string) return integer\n"
+    "begin\n"
+    "    return 0\n"
+    "end\n";
+
+int main(void) {
+    assert(snippet_is_valid(fixture, "v.filter(keep)"));
+    assert(snippet_is_valid(fixture, "v.filter_into(w, keep)"));
+    assert(snippet_is_valid(fixture, "v.partition(w, keep)"));
+    assert(snippet_is_valid(fixture, "input.filter_into(v, keep)"));
+    assert(snippet_is_valid(fixture, "v.filter_into(w, lambda (in x is integer)"
+                                     " return boolean is return x < 0)"));
+
+    /* The vector filtered can't be its own destination. */
+    assert(!snippet_is_valid(fixture, "v.filter_into(v, keep)"));
+    assert(!snippet_is_valid(fixture, "v.partition(v, keep)"));
+
+    /* The destination is a vector of the same type that can be written. */
+    assert(!snippet_is_valid(fixture, "v.filter_into(input, keep)"));
+    assert(!snippet_is_valid(fixture, "v.partition(input, keep)"));
+    assert(!snippet_is_valid(fixture, "v.filter_into(r, keep)"));
+    assert(!snippet_is_valid(fixture, "v.filter_into(w.size(), keep)"));
+
+    /* The predicate takes an element and returns a boolean. */
+    assert(!snippet_is_valid(fixture, "r.filter(keep)"));
+    assert(!snippet_is_valid(fixture, "v.filter(lambda (in x is integer)"
+                                      " return integer is return x)"));
+    assert(!snippet_is_valid(fixture, "v.filter(lambda (inout x is integer)"
+                                      " return boolean is return x > 0)"));
+    assert(!snippet_is_valid(fixture, "v.filter_into(w, lambda (in x is real)"
+                                      " return boolean is return x > 0)"));
+    assert(!snippet_is_valid(fixture, "v.partition(w, w)"));
+
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "../ez/framebuffer.hpp"
+
+/* Checks the ez::Framebuffer runtime without any window, through the PPM
+ * files it writes. */
+
+static const char* PATH = "test-ez-framebuffer-runtime.ppm";
+
+static std::string read_file(const char* path) {
+    std::string content;
+    char buffer[4096];
+    size_t size;
+
+    FILE* file = fopen(path, "rb");
+    assert(file);
+    while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        content.append(buffer, size);
+    }
+    fclose(file);
+    return content;
+}
+
+static std::string pixel(const std::string& ppm, const char* header,
+                         unsigned int width, unsigned int x, unsigned int y)
+{
+    return ppm.substr(strlen(header) + (y * width + x) * 3, 3);
+}
+
+int main(void) {
+    ez::Framebuffer fb;
+    ez::create_framebuffer(fb, 4, 3);
+    assert(ez::framebuffer_width(fb) == 4 && ez::framebuffer_height(fb) == 3);
+
+    ez::clear_framebuffer(fb, ez::color(0, 0, 255));
+    ez::set_pixel(fb, 0, 0, ez::color(255, 0, 0));
+    ez::set_pixel(fb, 4, 0, ez::color(255, 0, 0));
+    ez::fill_rect(fb, 2, 1, 10, 10, ez::color(0, 255, 0));
+
+    ez::Framebuffer sprite;
+    ez::create_framebuffer(sprite, 2, 2);
+    ez::clear_framebuffer(sprite, ez::color(1, 2, 3));
+    ez::blit(fb, sprite, 3, 2);
+    ez::blit(fb, sprite, 100, 100);
+
+    assert(ez::write_framebuffer_ppm(fb, PATH));
+    std::string ppm = read_file(PATH);
+    const char* header = "P6\n4 3\n255\n";
+    assert(ppm.size() == strlen(header) + 4 * 3 * 3);
+    assert(ppm.compare(0, strlen(header), header) == 0);
+
+    assert(pixel(ppm, header, 4, 0, 0) == std::string("\xff\0\0", 3));
+    assert(pixel(ppm, header, 4, 1, 0) == std::string("\0\0\xff", 3));
+    assert(pixel(ppm, header, 4, 3, 0) == std::string("\0\0\xff", 3));
+    assert(pixel(ppm, header, 4, 2, 1) == std::string("\0\xff\0", 3));
+    assert(pixel(ppm, header, 4, 3, 1) == std::string("\0\xff\0", 3));
+    assert(pixel(ppm, header, 4, 2, 2) == std::string("\0\xff\0", 3));
+    assert(pixel(ppm, header, 4, 3, 2) == std::string("\1\2\3", 3));
+    assert(pixel(ppm, header, 4, 1, 2) == std::string("\0\0\xff", 3));
+
+    assert(!ez::write_framebuffer_ppm(fb, "does/not/exist.ppm"));
+    remove(PATH);
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "../ez/io.hpp"
+
+/* Checks that the console I/O can be used by concurrent threads, as the
+ * functions given to the parallel methods do: stdout and stdin are redirected
+ * to files. */
+
+static const char* PATH = "test-ez-io-runtime.txt";
+static const int THREADS = 4;
+static const int COUNT = 20000;
+
+static void test_concurrent_output() {
+    assert(freopen(PATH, "w", stdout));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; t++) {
+        threads.push_back(std::thread([]() {
+            for (int i = 0; i < COUNT; i++) {
+                ez::out << "0123456789abcdef\n";
+                ez::out << -1234567;
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+    ez::out << '\n';
+    ez::out.flush();
+
+    /* The lines of the threads are interleaved, but each write is whole. */
+    FILE* f = fopen(PATH, "r");
+    assert(f);
+    char line[64];
+    int lines = 0;
+    int numbers = 0;
+    while (fgets(line, sizeof(line), f)) {
+        char* rest = line;
+        while (strncmp(rest, "-1234567", 8) == 0) {
+            rest += 8;
+            numbers++;
+        }
+        if (strcmp(rest, "0123456789abcdef\n") == 0) {
+            lines++;
+        } else {
+            assert(strcmp(rest, "\n") == 0);
+        }
+    }
+    fclose(f);
+    assert(lines == THREADS * COUNT);
+    assert(numbers == THREADS * COUNT);
+}
+
+static void test_concurrent_input() {
+    FILE* f = fopen(PATH, "w");
+    assert(f);
+    for (int i = 0; i < THREADS * COUNT; i++) {
+        fprintf(f, "%d\n", i);
+    }
+    fclose(f);
+    assert(freopen(PATH, "r", stdin));
+
+    /* Each number is read by one thread only. */
+    long long sums[THREADS] = {0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; t++) {
+        threads.push_back(std::thread([&sums, t]() {
+            for (int i = 0; i < COUNT; i++) {
+                int n = -1;
+                ez::in >> n;
+                assert(n >= 0);
+                sums[t] += n;
+            }
+        }));
+    }
+    long long sum = 0;
+    for (int t = 0; t < THREADS; t++) {
+        threads[t].join();
+        sum += sums[t];
+    }
+    long long total = (long long)THREADS * COUNT;
+    assert(sum == total * (total - 1) / 2);
+}
+
+int main(void) {
+    test_concurrent_output();
+    test_concurrent_input();
+
+    remove(PATH);
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "ez-lang.h"
+#include "ez-test.h"
+
+char source[] =
+    "program liveness_test\n"
+    "\n"
+    "function keep(inout v is vector of integer) return vector of integer\n"
+    "    local moved_result is vector of integer\n"
+    "    local moved_pushed is string\n"
+    "    local kept_pushed is string\n"
+    "    local names is vector of string\n"
+    "    local moved_loop_item is string\n"
+    "    local kept_loop_item is string\n"
+    "    local i is natural\n"
+    "begin\n"
+    "    moved_result = v\n"
+    "    moved_result.push(1)\n"
+    "    v = moved_result\n"
+    "    names.push(moved_pushed)\n"
+    "    names.push(kept_pushed)\n"
+    "    print kept_pushed\n"
+    "    for i in 0 .. 3 do\n"
+    "        moved_loop_item = \"a\"\n"
+    "        names.push(moved_loop_item)\n"
+    "        names.push(kept_loop_item)\n"
+    "    endfor\n"
+    "    return v\n"
+    "end\n"
+    "\n"
+    "function liveness_test(in args is vector of string) return integer\n"
+    "    local n is integer\n"
+    "    local m is integer\n"
+    "begin\n"
+    "    m = n\n"
+    "    return m\n"
+    "end\n";
+
+int main(void) {
+    program_t* prg = parse_program(source);
+
+    program_mark_last_uses(prg);
+    char* code = print_program(prg, NULL);
+
+    /* `v` is an argument, it is never moved from. */
+    assert(strstr(code, "moved_result = v;"));
+    assert(strstr(code, "v = std::move(moved_result);"));
+    assert(strstr(code, "names.push(std::move(moved_pushed));"));
+    assert(strstr(code, "names.push(kept_pushed);"));
+
+    /* Affected on each iteration before its last use. */
+    assert(strstr(code, "names.push(std::move(moved_loop_item));"));
+    /* Read again by the next iteration. */
+    assert(strstr(code, "names.push(kept_loop_item);"));
+
+    /* Cheap types are copied. */
+    assert(strstr(code, "m = n;"));
+    assert(strstr(code, "return m;"));
+
+    free(code);
+    program_delete(prg);
+
+    return 0;
+}
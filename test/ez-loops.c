@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "ez-lang.h"
+#include "ez-test.h"
+
+char source[] =
+    "program loops_test\n"
+    "\n"
+    "global g is vector of integer\n"
+    "\n"
+    "procedure touch()\n"
+    "begin\n"
+    "    g.push(0)\n"
+    "end\n"
+    "\n"
+    "function sum(in v is vector of integer) return integer\n"
+    "    local i is natural\n"
+    "    local s is integer\n"
+    "begin\n"
+    "    for i in 0 .. v.size() do\n"
+    "        s = s + v[i]\n"
+    "    endfor\n"
+    "    return s\n"
+    "end\n"
+    "\n"
+    "procedure grow(inout v is vector of integer)\n"
+    "    local j is natural\n"
+    "begin\n"
+    "    for j in 0 .. v.size() do\n"
+    "        on j < 10 do v.push(j)\n"
+    "    endfor\n"
+    "end\n"
+    "\n"
+    "procedure shared(in v is vector of integer)\n"
+    "    local k is natural\n"
+    "begin\n"
+    "    for k in 0 .. v.size() do\n"
+    "        touch()\n"
+    "    endfor\n"
+    "end\n"
+    "\n"
+    "procedure bounded(in n is natural)\n"
+    "    local l is natural\n"
+    "begin\n"
+    "    for l in 0 .. n do\n"
+    "        print l\n"
+    "    endfor\n"
+    "end\n"
+    "\n"
+    "function loops_test(in args is vector of string) return integer\n"
+    "    local v is vector of integer\n"
+    "begin\n"
+    "    grow(v)\n"
+    "    shared(v)\n"
+    "    bounded(3)\n"
+    "    return sum(v)\n"
+    "end\n";
+
+int main(void) {
+    program_t* prg = parse_program(source);
+
+    program_hoist_loop_bounds(prg);
+    char* code = print_program(prg, NULL);
+
+    assert(strstr(code, "const auto _ez_i_end = v.size();"));
+    assert(strstr(code, "for (i = 0; i < _ez_i_end; i++)"));
+
+    /* The vector grows in the loop. */
+    assert(strstr(code, "for (j = 0; j < v.size(); j++)"));
+
+    /* `touch` could modify `v` through the global `g`. */
+    assert(strstr(code, "for (k = 0; k < v.size(); k++)"));
+
+    /* Nothing to gain on a plain variable. */
+    assert(strstr(code, "for (l = 0; l < n; l++)"));
+
+    free(code);
+    program_delete(prg);
+
+    return 0;
+}
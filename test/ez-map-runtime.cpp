@@ -0,0 +1,87 @@
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include "../ez/map.hpp"
+#include "../ez/random.hpp"
+
+/* Checks the ez::map runtime against std::unordered_map, on random
+ * insertions and removals. */
+
+static void test_operations() {
+    ez::map<std::string, int> m;
+    assert(m.size() == 0 && !m.has("a"));
+    m.remove("a");
+
+    m.put("a", 1);
+    m.put("b", 2);
+    m.put("a", 3);
+    assert(m.size() == 2 && m.get("a") == 3 && m.get("b") == 2);
+    assert(m.key_at(0) == "a" && m.value_at(1) == 2);
+
+    m.get("b") = 5;
+    m.value_at(0)++;
+    assert(m.get("b") == 5 && m.get("a") == 4);
+
+    /* A value of the map given to put, while it grows. */
+    for (int i = 0; i < 100; i++) {
+        m.put(std::to_string(i), m.get("a"));
+    }
+    assert(m.size() == 102 && m.get("99") == 4);
+
+    m.remove("a");
+    assert(!m.has("a") && m.size() == 101 && m.key_at(0) == "99");
+
+    m.clear();
+    assert(m.size() == 0 && !m.has("b"));
+    m.put("c", 1);
+    assert(m.get("c") == 1);
+
+    ez::map<int, ez::map<char, double> > nested;
+    nested.put(-1, ez::map<char, double>());
+    nested.get(-1).put('x', 0.5);
+    ez::map<int, ez::map<char, double> > copy = nested;
+    copy.get(-1).put('x', 1.5);
+    assert(nested.get(-1).get('x') == 0.5 && copy.get(-1).get('x') == 1.5);
+}
+
+static void test_random() {
+    ez::Random random;
+    ez::map<int, int> m;
+    std::unordered_map<int, int> reference;
+
+    for (int i = 0; i < 200000; i++) {
+        int key = random.integer(0, 5000);
+        switch (random.integer(0, 3)) {
+          case 0:
+          case 1:
+            m.put(key, i);
+            reference[key] = i;
+            break;
+
+          default:
+            m.remove(key);
+            reference.erase(key);
+            break;
+        }
+        assert(m.size() == reference.size());
+    }
+
+    for (int key = 0; key < 5000; key++) {
+        auto it = reference.find(key);
+        assert(m.has(key) == (it != reference.end()));
+        if (it != reference.end()) {
+            assert(m.get(key) == it->second);
+        }
+    }
+    for (unsigned int i = 0; i < m.size(); i++) {
+        assert(reference.at(m.key_at(i)) == m.value_at(i));
+    }
+}
+
+int main(void) {
+    test_operations();
+    test_random();
+
+    return 0;
+}
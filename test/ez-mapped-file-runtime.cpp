@@ -0,0 +1,61 @@
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include "../ez/mapped-file.hpp"
+
+/* Checks the ez::MappedFile runtime: scanning lines in place, and the empty,
+ * missing and too big files. */
+
+static const char* PATH = "test-ez-mapped-file-runtime.txt";
+
+static void write_file(const char* content) {
+    FILE* file = fopen(PATH, "w");
+    assert(file);
+    fputs(content, file);
+    fclose(file);
+}
+
+int main(void) {
+    ez::MappedFile file;
+    assert(!ez::is_file_mapped(file));
+
+    write_file("a,b\n\nlast");
+    ez::map_file(PATH, file);
+    assert(ez::is_file_mapped(file));
+    assert(ez::mapped_file_size(file) == 9);
+    assert(ez::mapped_file_char(file, 0) == 'a');
+
+    unsigned int end = ez::mapped_file_line_end(file, 0);
+    assert(end == 3);
+    assert(ez::mapped_file_find(file, ',', 0) == 1);
+    assert(ez::mapped_file_find(file, ',', 2) == 9);
+    assert(ez::mapped_file_line_end(file, end + 1) == 4);
+    assert(ez::mapped_file_line_end(file, 5) == 9);
+    assert(ez::mapped_file_substring(file, 5, 9) == "last");
+    assert(ez::mapped_file_substring(file, 5, 100) == "last");
+    assert(ez::mapped_file_line_end(file, 100) == 9);
+
+    ez::MappedFile moved = std::move(file);
+    assert(ez::is_file_mapped(moved) && !ez::is_file_mapped(file));
+    assert(ez::mapped_file_char(moved, 8) == 't');
+    ez::unmap_file(moved);
+    assert(!ez::is_file_mapped(moved));
+
+    write_file("");
+    ez::map_file(PATH, file);
+    assert(ez::is_file_mapped(file) && ez::mapped_file_size(file) == 0);
+    assert(ez::mapped_file_line_end(file, 0) == 0);
+
+    /* A sparse file just over 4GiB, which natural indexes can't reach. */
+    if (truncate(PATH, (off_t)UINT_MAX + 1) == 0) {
+        ez::map_file(PATH, file);
+        assert(!ez::is_file_mapped(file));
+    }
+
+    remove(PATH);
+    ez::map_file(PATH, file);
+    assert(!ez::is_file_mapped(file));
+
+    return 0;
+}
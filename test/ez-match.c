@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "ez-lang.h"
+#include "ez-test.h"
+
+char source[] =
+    "program match_test\n"
+    "\n"
+    "enumeration Fruit is\n"
+    "    ANANAS, APPLE,\n"
+    "    PEACH\n"
+    "end\n"
+    "\n"
+    "function price(in f is Fruit) return natural\n"
+    "begin\n"
+    "    match f\n"
+    "    case ANANAS, PEACH do\n"
+    "        return 3\n"
+    "    case APPLE do\n"
+    "        return 1\n"
+    "    endmatch\n"
+    "    return 0\n"
+    "end\n"
+    "\n"
+    "function match_test(in args is vector of string) return integer\n"
+    "    local f is Fruit\n"
+    "    local c is char\n"
+    "begin\n"
+    "    f = APPLE\n"
+    "    print f, price(f)\n"
+    "    match c\n"
+    "    case 'a' do\n"
+    "        print 1\n"
+    "    else\n"
+    "        print 2\n"
+    "    endmatch\n"
+    "    return 0\n"
+    "end\n";
+
+/* The programs checked, with an instruction instead of "%s". */
+static const char fixture[] =
+    "program invalid\n"
+    "\n"
+    "enumeration Fruit is\n"
+    "    ANANAS, APPLE, PEACH\n"
+    "end\n"
+    "\n"
+    "procedure print_fruit(in f is Fruit)\n"
+    "begin\n"
+    "    print f\n"
+    "end\n"
+    "\n"
+    "function invalid(in args is vector of string) return integer\n"
+    "    local f is Fruit\n"
+    "    local r is real\n"
+    "    local n is natural\n"
+    "begin\n"
+    "    %s\n"
+    "    return 0\n"
+    "end\n";
+
+int main(void) {
+    program_t* prg = parse_program(source);
+
+    char* code = print_program(prg, NULL);
+
+    assert(strstr(code, "enum Fruit {\n    ANANAS,\n    APPLE,\n    PEACH,\n"));
+    assert(strstr(code, "switch (f) {"));
+    assert(strstr(code, "case ANANAS:\n"));
+    assert(strstr(code, "case PEACH: {"));
+    assert(strstr(code, "case 'a': {"));
+    assert(strstr(code, "default: {"));
+
+    /* Exhaustive matches without else don't fall out of the switch. */
+    assert(strstr(code, "default:\n        __builtin_unreachable();\n"));
+
+    free(code);
+    program_delete(prg);
+
+    assert(snippet_is_valid(fixture, "print_fruit(APPLE)"));
+    assert(!snippet_is_valid(fixture, "print_fruit(42)"));
+    assert(!snippet_is_valid(fixture, "APPLE = f"));
+    assert(!snippet_is_valid(fixture, "f = 1"));
+
+    /* Without else, all the members must have a case. */
+    assert(snippet_is_valid(fixture, "match f\n"
+                                     "case ANANAS, APPLE, PEACH do\n"
+                                     "    print 1\n"
+                                     "endmatch"));
+    assert(!snippet_is_valid(fixture, "match f\n"
+                                      "case ANANAS, APPLE do\n"
+                                      "    print 1\n"
+                                      "endmatch"));
+    assert(snippet_is_valid(fixture, "match f\n"
+                                     "case ANANAS do\n"
+                                     "    print 1\n"
+                                     "else\n"
+                                     "    print 2\n"
+                                     "endmatch"));
+
+    /* A value is handled by a single case. */
+    assert(!snippet_is_valid(fixture, "match f\n"
+                                      "case ANANAS, APPLE do\n"
+                                      "    print 1\n"
+                                      "case APPLE do\n"
+                                      "    print 2\n"
+                                      "else\n"
+                                      "    print 3\n"
+                                      "endmatch"));
+
+    /* Cases must be literals of the subject type. */
+    assert(!snippet_is_valid(fixture, "match f\n"
+                                      "case 1 do\n"
+                                      "    print 1\n"
+                                      "else\n"
+                                      "    print 2\n"
+                                      "endmatch"));
+    assert(!snippet_is_valid(fixture, "match n\n"
+                                      "case -1 do\n"
+                                      "    print 1\n"
+                                      "endmatch"));
+    assert(!snippet_is_valid(fixture, "match r\n"
+                                      "case 1 do\n"
+                                      "    print 1\n"
+                                      "endmatch"));
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "ez-lang.h"
+#include "ez-test.h"
+#include "ez-object.h"
+
+char source[] =
+    "program object_test\n"
+    "\n"
+    "enumeration shade is\n"
+    "    RED, GREEN\n"
+    "    BLUE\n"
+    "end\n"
+    "\n"
+    "structure node is\n"
+    "    value is integer\n"
+    "    next is optional node\n"
+    "    weights is vector of real\n"
+    "    names is map of string to vector of integer\n"
+    "    position is array of 3 real\n"
+    "    tint is shade\n"
+    "end\n"
+    "\n"
+    "constant limit is integer = -42\n"
+    "global counter is natural\n"
+    "\n"
+    "procedure apply(inout v is vector of integer,\n"
+    "                in f is function(in integer) return integer)\n"
+    "    local i is integer\n"
+    "begin\n"
+    "    for i in 0 .. v.size() do\n"
+    "        v[i] = f(v[i])\n"
+    "    endfor\n"
+    "end\n"
+    "\n"
+    "function object_test(in args is vector of string) return integer\n"
+    "    local v is vector of integer\n"
+    "    local n is node\n"
+    "    local finished is boolean\n"
+    "begin\n"
+    "    n.value = limit * 2\n"
+    "    n.next = empty node\n"
+    "    n.names.put(\"three\", v)\n"
+    "    n.position[2] = 1.5\n"
+    "    n.tint = GREEN\n"
+    "    match n.tint\n"
+    "    case RED, GREEN do\n"
+    "        print n.tint\n"
+    "    case BLUE do\n"
+    "        print \"blue\"\n"
+    "    endmatch\n"
+    "    v.push(3)\n"
+    "    apply(v, lambda (in x is integer) return integer is return x + 1)\n"
+    "    if not finished and n.value < 0 then\n"
+    "        print \"neg \\\"quoted\\\"\", 'c', 2.5, \"\\n\"\n"
+    "    elsif true then\n"
+    "        read counter\n"
+    "    else\n"
+    "        on counter > 2 do counter = counter - 1\n"
+    "    endif\n"
+    "    loop\n"
+    "        counter = counter + 1\n"
+    "    until counter >= 10\n"
+    "    return 0\n"
+    "end\n";
+
+int main(void) {
+    program_t* prg = parse_program(source);
+    program_t* loaded = NULL;
+    char* object = NULL;
+    size_t object_size = 0;
+    FILE* f = NULL;
+
+    f = fmemopen(source, strlen(source), "r");
+    assert(!program_is_object(f));
+    fclose(f);
+
+    f = open_memstream(&object, &object_size);
+    assert(program_write_object(f, prg));
+    fclose(f);
+
+    f = fmemopen(object, object_size, "r");
+    assert(program_is_object(f));
+    loaded = program_read_object(f);
+    assert(loaded != NULL);
+    fclose(f);
+
+    /* A reloaded program generates exactly the same code. */
+    char* expected = print_program(prg, NULL);
+    char* got = print_program(loaded, NULL);
+    assert(strcmp(expected, got) == 0);
+    free(expected);
+    free(got);
+
+    /* Truncated objects are rejected. */
+    f = fmemopen(object, object_size / 2, "r");
+    assert(program_read_object(f) == NULL);
+    fclose(f);
+
+    /* Objects from another version are rejected. */
+    object[strlen(EZ_OBJECT_MAGIC)] = EZ_OBJECT_VERSION + 1;
+    f = fmemopen(object, object_size, "r");
+    assert(program_read_object(f) == NULL);
+    fclose(f);
+
+    free(object);
+    program_delete(loaded);
+
+    /* Structures and enumerations out of the program can't be
+     * referenced. */
+    identifier_t foreign_id = {.value = "foreign"};
+    identifier_t global_id = {.value = "stray"};
+    structure_t* foreign = structure_new(&foreign_id);
+    enumeration_t* foreign_enumeration = enumeration_new(&foreign_id);
+    type_t* foreign_types[] = {
+        type_structure_new(foreign),
+        type_enumeration_new(foreign_enumeration),
+    };
+
+    for (int i = 0; i < 2; i++) {
+        program_t* stray = parse_program(source);
+        program_add_global(stray, symbol_new(&global_id, foreign_types[i]));
+
+        f = open_memstream(&object, &object_size);
+        assert(!program_write_object(f, stray));
+        fclose(f);
+        free(object);
+        program_delete(stray);
+    }
+
+    program_delete(prg);
+    structure_delete(foreign);
+    enumeration_delete(foreign_enumeration);
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "ez-lang.h"
+#include "ez-test.h"
+
+char source[] =
+    "program optimize_test\n"
+    "\n"
+    "constant size is integer = 4 * 8 + 2\n"
+    "constant half is real = 1 / 2.0\n"
+    "constant debug is boolean = false\n"
+    "constant name is string = \"ez\" + \"c\"\n"
+    "constant count is natural = 5\n"
+    "\n"
+    "function optimize_test(in args is vector of string) return integer\n"
+    "    local i is integer\n"
+    "    local x is integer\n"
+    "    local size_copy is natural\n"
+    "    local wraps is boolean\n"
+    "begin\n"
+    "    x = size - 1\n"
+    "    x = x * 1 + 0\n"
+    "    size_copy = 7 - 2\n"
+    "    size_copy = count * 2\n"
+    "    wraps = count - 10 > 0\n"
+    "    print half, \" \", name, \" \", 10 / 0, \"\\n\"\n"
+    "    if debug then\n"
+    "        print \"debug\\n\"\n"
+    "    elsif size > 100 then\n"
+    "        print \"big\\n\"\n"
+    "    elsif not debug and x > 0 then\n"
+    "        print \"positive\\n\"\n"
+    "    else\n"
+    "        print \"other\\n\"\n"
+    "    endif\n"
+    "    while debug or false do\n"
+    "        print \"never\\n\"\n"
+    "    endwhile\n"
+    "    on 3 < 2 do print \"never\\n\"\n"
+    "    on 'a' == 'a' do print \"always\\n\"\n"
+    "    loop\n"
+    "        print \"once\\n\"\n"
+    "    until true\n"
+    "    for i in 0 .. size do\n"
+    "        x = x + i\n"
+    "    endfor\n"
+    "    return x\n"
+    "end\n";
+
+int main(void) {
+    program_t* prg = parse_program(source);
+
+    program_optimize(prg);
+    char* code = print_program(prg, NULL);
+
+    /* Constants are folded, and propagated with their declared type. */
+    assert(strstr(code, "const int size  = 34;"));
+    assert(strstr(code, "const double half  = 0.5;"));
+    assert(strstr(code, "const std::string name  = \"ezc\";"));
+    assert(strstr(code, "x = 33;"));
+    assert(strstr(code, "ez::out << 0.5 << \" \" << \"ezc\""));
+    assert(strstr(code, "for (i = 0; i < 34; i++)"));
+
+    /* Identities are removed, divisions by zero are left to the runtime. */
+    assert(strstr(code, "x = x;"));
+    assert(strstr(code, "(10) / (0)"));
+    assert(strstr(code, "size_copy = 5;"));
+
+    /* Natural constants are unsigned in C++, and stay so once propagated. */
+    assert(strstr(code, "size_copy = 10u;"));
+    assert(strstr(code, "wraps = ((5u) - (10)) > (0);"));
+
+    /* Constant branches are resolved. */
+    assert(!strstr(code, "\"debug"));
+    assert(!strstr(code, "big"));
+    assert(!strstr(code, "never"));
+    assert(strstr(code, "if ((x) > (0)) {"));
+    assert(strstr(code, "else {"));
+    assert(strstr(code, "ez::out << \"always\\n\";"));
+    assert(strstr(code, "ez::out << \"once\\n\";"));
+    assert(!strstr(code, "while"));
+
+    free(code);
+    program_delete(prg);
+
+    return 0;
+}
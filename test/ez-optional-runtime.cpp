@@ -0,0 +1,132 @@
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include "../ez/optional.hpp"
+
+/* Checks the ez::optional runtime, counting the allocations it does.
+ *
+ * The former optional allocated its value and a reference count for each
+ * optional, even unset, and never freed them when it was copied: a tree of
+ * N nodes did 3N + 1 allocations and leaked the copied ones.
+ */
+
+static long allocations = 0;
+static long deallocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    void* p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    if (p) {
+        deallocations++;
+    }
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+/* What the compiler generates for a recursive EZ structure. */
+struct tree;
+namespace ez {
+template <> struct optional_is_boxed< tree > : std::true_type {};
+}
+
+struct tree {
+    int value;
+    ez::optional< tree > left;
+    ez::optional< tree > right;
+};
+
+static void tree_insert(ez::optional< tree >& t, int value) {
+    if (!t.is_set()) {
+        tree node;
+        node.value = value;
+        t.set(std::move(node));
+    } else if (value <= t.get().value) {
+        tree_insert(t.get().left, value);
+    } else {
+        tree_insert(t.get().right, value);
+    }
+}
+
+static int tree_sum(const ez::optional< tree >& t) {
+    if (!t.is_set()) {
+        return 0;
+    }
+    return t.get().value + tree_sum(t.get().left) + tree_sum(t.get().right);
+}
+
+static void test_inline() {
+    long before = allocations;
+    {
+        ez::optional<int> a;
+        assert(!a.is_set());
+        a.set(32);
+        assert(a.is_set() && a.get() == 32);
+
+        ez::optional<int> b = a;
+        b.get() = 12;
+        assert(a.get() == 32 && b.get() == 12);
+
+        ez::optional<int> c;
+        b = c;
+        assert(!b.is_set());
+    }
+    assert(allocations == before);
+
+    static_assert(sizeof(ez::optional<double>) <= 2 * sizeof(double),
+                  "inline optionals hold their value");
+
+    /* Moving a string keeps its buffer. */
+    ez::optional<std::string> s;
+    s.set(std::string(100, 'x'));
+    before = allocations;
+    ez::optional<std::string> moved = std::move(s);
+    assert(allocations == before && moved.get().size() == 100);
+}
+
+static void test_boxed() {
+    const int N = 1000;
+    long before = allocations;
+    long freed = deallocations;
+    {
+        ez::optional< tree > t;
+        for (int i = 0; i < N; i++) {
+            tree_insert(t, (i * 7919) % N);
+        }
+        assert(tree_sum(t) == N * (N - 1) / 2);
+        assert(allocations - before == N);
+
+        /* Copies are deep, moves aren't copies. */
+        ez::optional< tree > copy = t;
+        assert(allocations - before == 2 * N);
+        copy.get().value = -1;
+        assert(t.get().value != -1);
+
+        ez::optional< tree > moved = std::move(copy);
+        assert(allocations - before == 2 * N && !copy.is_set());
+
+        /* Replacing a tree by one of its subtrees. */
+        moved.set(moved.get().right.get());
+        assert(tree_sum(moved) == tree_sum(t.get().right));
+    }
+    assert(allocations - before == deallocations - freed);
+}
+
+int main(void) {
+    test_inline();
+    test_boxed();
+
+    printf("%ld allocations, %ld deallocations\n", allocations, deallocations);
+    return 0;
+}
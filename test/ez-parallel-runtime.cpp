@@ -0,0 +1,144 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include "../ez/parallel.hpp"
+
+/* Checks the thread pool and the `parallel for` ranges: every index runs
+ * once, on uneven work too, and the chunks cover the ranges in order. */
+
+static void test_run() {
+    ez::thread_pool& pool = ez::thread_pool::instance();
+    const size_t counts[] = {0, 1, 2, 7, 1000, 100003};
+
+    for (size_t count : counts) {
+        std::vector<std::atomic<int> > seen(count);
+        for (size_t i = 0; i < count; i++) {
+            seen[i] = 0;
+        }
+
+        pool.run(count, [&](size_t i) { seen[i]++; });
+        for (size_t i = 0; i < count; i++) {
+            assert(seen[i] == 1);
+        }
+    }
+
+    /* A job started from a job runs in its calling thread, the one that
+     * started the outer job included. */
+    std::atomic<int> calls(0);
+    pool.run(8, [&](size_t) {
+        pool.run(8, [&](size_t) { calls++; });
+    });
+    assert(calls == 64);
+
+    /* Like a `parallel_map` in a `parallel for` body: nested twice, and the
+     * pool is usable again afterwards. */
+    calls = 0;
+    pool.run(100, [&](size_t) {
+        pool.run(10, [&](size_t) {
+            pool.run(3, [&](size_t) { calls++; });
+        });
+    });
+    assert(calls == 3000);
+
+    calls = 0;
+    pool.run(1000, [&](size_t) { calls++; });
+    assert(calls == 1000);
+}
+
+static double work(size_t n) {
+    double x = 0;
+    for (size_t i = 0; i < n; i++) {
+        x += sqrt((double)i);
+    }
+    return x;
+}
+
+/* The last indexes cost much more than the first ones: the threads done
+ * with their range steal from the others. */
+static void test_uneven() {
+    const size_t count = 512;
+    std::vector<double> results(count);
+    std::vector<double> expected(count);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        expected[i] = work(i * i / 4);
+    }
+    std::chrono::duration<double> sequential =
+        std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    ez::thread_pool::instance().run(count, [&](size_t i) {
+        results[i] = work(i * i / 4);
+    });
+    std::chrono::duration<double> parallel =
+        std::chrono::steady_clock::now() - start;
+
+    assert(results == expected);
+    printf("uneven work on %u threads: sequential %.3fms, parallel %.3fms\n",
+           ez::thread_pool::instance().size(),
+           sequential.count() * 1000, parallel.count() * 1000);
+}
+
+static void test_range() {
+    ez::parallel_range<int> range(-5, 1000);
+    assert(range.chunks() > 0);
+    assert(range.end() == 1000);
+
+    std::vector<int> from(range.chunks());
+    std::vector<int> to(range.chunks());
+    range.run([&](size_t chunk, int f, int t) {
+        from[chunk] = f;
+        to[chunk] = t;
+    });
+
+    assert(from[0] == -5);
+    assert(to[range.chunks() - 1] == 1000);
+    for (size_t c = 0; c < range.chunks(); c++) {
+        assert(from[c] < to[c]);
+        if (c > 0) {
+            assert(from[c] == to[c - 1]);
+        }
+    }
+
+    /* A reduction, one part per chunk. */
+    ez::parallel_range<unsigned int> naturals(0, 100000);
+    auto parts = naturals.parts<long long>();
+    naturals.run([&](size_t chunk, unsigned int f, unsigned int t) {
+        long long sum = 0;
+        for (unsigned int i = f; i < t; i++) {
+            sum += i;
+        }
+        parts[chunk] = sum;
+    });
+    long long sum = 0;
+    for (size_t c = 0; c < naturals.chunks(); c++) {
+        sum += parts[c];
+    }
+    assert(sum == 100000LL * 99999 / 2);
+
+    /* Empty ranges leave the subject at their start. */
+    ez::parallel_range<int> empty(10, 3);
+    assert(empty.chunks() == 0);
+    assert(empty.end() == 10);
+    empty.run([&](size_t, int, int) { assert(false); });
+
+    ez::parallel_range<int> one(3, 4);
+    assert(one.chunks() == 1);
+}
+
+int main(void) {
+    /* Several threads even on a single core, so jobs really run on the
+     * pool. */
+    setenv("EZ_THREADS", "4", 0);
+
+    test_run();
+    test_uneven();
+    test_range();
+
+    return 0;
+}
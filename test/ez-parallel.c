@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "ez-lang.h"
+#include "ez-test.h"
+
+char source[] =
+    "program parallel_test\n"
+    "\n"
+    "function parallel_test(in args is vector of string) return integer\n"
+    "    local i is natural\n"
+    "    local sum is integer\n"
+    "    local all is boolean\n"
+    "    local square is natural\n"
+    "    local v is vector of natural\n"
+    "begin\n"
+    "    sum = 0\n"
+    "    all = true\n"
+    "    parallel for i in 0 .. v.size() do\n"
+    "        square = i * i\n"
+    "        v[i] = square\n"
+    "        sum = sum + v[i]\n"
+    "        all = all and v[i] > 0\n"
+    "    endfor\n"
+    "    return sum\n"
+    "end\n";
+
+/* Loops whose iterations can't run concurrently. */
+const char* invalid_bodies[] = {
+    /* Writes its subject. */
+    "        i = i + 1\n",
+    /* Writes an element other than its own. */
+    "        v[j] = i\n",
+    /* Reads a local set by the previous iteration. */
+    "        on i > 0 do v[i] = j\n"
+    "        j = i\n",
+    /* Mixes an accumulation with another use. */
+    "        j = j + i\n"
+    "        v[i] = j\n",
+    "        print i\n",
+    "        on i == 3 do return 1\n",
+    /* Writes a vector it also reads. */
+    "        v.push(i)\n",
+    /* Assigns a local on some paths only, the last chunk may not. */
+    "        if i < 5 then\n"
+    "            j = i\n"
+    "        endif\n",
+    "        on i < 5 do j = i\n",
+    /* Prints through the functions it calls. */
+    "        show(i)\n",
+    "        v[i] = shown(i)\n",
+};
+
+/* The programs checked, with a loop body instead of "%s". */
+static const char fixture[] =
+    "program invalid\n"
+    "\n"
+    "procedure show(in n is natural)\n"
+    "begin\n"
+    "    print n\n"
+    "end\n"
+    "\n"
+    "function shown(in n is natural) return natural\n"
+    "begin\n"
+    "    show(n)\n"
+    "    return n\n"
+    "end\n"
+    "\n"
+    "function twice(in n is natural) return natural\n"
+    "begin\n"
+    "    return 2 * n\n"
+    "end\n"
+    "\n"
+    "function invalid(in args is vector of string) return integer\n"
+    "    local i is natural\n"
+    "    local j is natural\n"
+    "    local v is vector of natural\n"
+    "begin\n"
+    "    parallel for i in 0 .. 10 do\n"
+    "%s"
+    "    endfor\n"
+    "    return 0\n"
+    "end\n";
+
+int main(void) {
+    program_t* prg = parse_program(source);
+
+    char* code = print_program(prg, NULL);
+
+    assert(strstr(code, "const ez::parallel_range< unsigned int > "
+                        "_ez_i_range(0, v.size());"));
+    assert(strstr(code, "for (unsigned int i = _ez_i_from; i < _ez_i_to; "
+                        "i++)"));
+    assert(strstr(code, "i = _ez_i_range.end();"));
+
+    /* `square` is private to each chunk, the last one gives its value. */
+    assert(strstr(code, "auto& _ez_square_outer = square;"));
+    assert(strstr(code, "unsigned int square {};"));
+    assert(strstr(code, "_ez_square_outer = std::move(square);"));
+
+    /* `sum` and `all` are reductions. */
+    assert(strstr(code, "const auto _ez_sum_parts = "
+                        "_ez_i_range.parts< int >();"));
+    assert(strstr(code, "int sum{};"));
+    assert(strstr(code, "bool all{true};"));
+    assert(strstr(code, "sum = sum + _ez_sum_parts[_ez_chunk];"));
+    assert(strstr(code, "all = all && _ez_all_parts[_ez_chunk];"));
+
+    free(code);
+    program_delete(prg);
+
+    for (size_t i = 0; i < sizeof(invalid_bodies) / sizeof(char*); i++) {
+        assert(!snippet_is_valid(fixture, invalid_bodies[i]));
+    }
+
+    /* Assigned by all the branches, the local is private. */
+    assert(snippet_is_valid(fixture, "        if i < 5 then\n"
+                                     "            j = i\n"
+                                     "        else\n"
+                                     "            j = 0\n"
+                                     "        endif\n"
+                                     "        v[i] = j\n"));
+
+    /* The functions called without printing nor reading are accepted. */
+    assert(snippet_is_valid(fixture, "        v[i] = twice(i)\n"));
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include <cassert>
+#include <cstdio>
+#include <chrono>
+#include <string>
+#include "../ez/functions.hpp"
+
+/* Checks the bulk number parsing runtime, and that loading a file of
+ * numbers is faster than reading it line by line as EZ programs did. */
+
+static const char* PATH = "test-ez-parse-runtime.txt";
+static const int COUNT = 1000000;
+
+static void test_parse() {
+    ez::vector<int> integers;
+    ez::vector<double> reals;
+
+    assert(!ez::parse_integers(" 1, -2,3 \n\n+4,2147483647,-2147483648\n",
+                               ',', integers).is_set());
+    assert(integers.size() == 6);
+    assert(integers.at(1) == -2 && integers.at(3) == 4);
+    assert(integers.at(4) == 2147483647 && integers.at(5) == -2147483647 - 1);
+
+    assert(!ez::parse_integers("1  2\t3\n4", ' ', integers).is_set());
+    assert(integers.size() == 4 && integers.at(2) == 3);
+
+    assert(!ez::parse_integers("", ',', integers).is_set());
+    assert(integers.size() == 0);
+
+    ez::optional<std::string> error =
+        ez::parse_integers("1,2\n3,x", ',', integers);
+    assert(error.is_set() && error.get() == "line 2: invalid integer");
+    error = ez::parse_integers("2147483648", ',', integers);
+    assert(error.is_set() && error.get() == "line 1: invalid integer");
+    error = ez::parse_integers("1,2,\n", ',', integers);
+    assert(error.get() == "line 1: expected a number after a delimiter");
+    error = ez::parse_integers("1 2", ',', integers);
+    assert(error.get() == "line 1: expected a delimiter after a number");
+
+    assert(!ez::parse_reals("1.5;-2e3; .25\n7", ';', reals).is_set());
+    assert(reals.size() == 4);
+    assert(reals.at(0) == 1.5 && reals.at(1) == -2000 && reals.at(2) == 0.25);
+    error = ez::parse_reals("1.5;1.5.5", ';', reals);
+    assert(error.get() == "line 1: expected a delimiter after a number");
+
+    error = ez::load_reals("does/not/exist", ',', reals);
+    assert(error.is_set() && reals.size() == 0);
+}
+
+static void test_benchmark() {
+    FILE* file = fopen(PATH, "w");
+    assert(file);
+    long sum = 0;
+    for (int i = 0; i < COUNT; i++) {
+        fprintf(file, "%d\n", i * 37 - COUNT);
+        sum += i * 37 - COUNT;
+    }
+    fclose(file);
+
+    auto start = std::chrono::steady_clock::now();
+    ez::vector<int> numbers;
+    assert(!ez::load_integers(PATH, ',', numbers).is_set());
+    std::chrono::duration<double> load_time =
+        std::chrono::steady_clock::now() - start;
+
+    long loaded = 0;
+    for (unsigned int i = 0; i < numbers.size(); i++) {
+        loaded += numbers.at(i);
+    }
+    assert(numbers.size() == COUNT && loaded == sum);
+
+    start = std::chrono::steady_clock::now();
+    ez::File f;
+    ez::open_file(PATH, "r", f);
+    ez::vector<int> read;
+    while (!ez::is_file_over(f)) {
+        std::string line = ez::read_line_from_file(f);
+        if (!line.empty()) {
+            read.push(ez::integer_from_string(line));
+        }
+    }
+    ez::close_file(f);
+    std::chrono::duration<double> lines_time =
+        std::chrono::steady_clock::now() - start;
+    assert(read.size() == COUNT);
+
+    printf("load_integers %.3fms, line by line %.3fms\n",
+           load_time.count() * 1000, lines_time.count() * 1000);
+    assert(load_time.count() < lines_time.count());
+
+    remove(PATH);
+}
+
+int main(void) {
+    test_parse();
+    test_benchmark();
+
+    return 0;
+}
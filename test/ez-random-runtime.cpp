@@ -0,0 +1,87 @@
+#include <cassert>
+#include <cstdio>
+#include <thread>
+#include "../ez/random.hpp"
+
+/* Checks the ez::Random runtime: reproducible streams, ranges, and
+ * independent streams for threads and splits. */
+
+static const int DRAWS = 600000;
+
+static void test_ranges() {
+    ez::Random random;
+    ez::seed_random(random, 42);
+
+    /* 3 doesn't divide 2^32: a modulo would favor the first values. */
+    int counts[3] = {0, 0, 0};
+    for (int i = 0; i < DRAWS; i++) {
+        int n = ez::random_integer(random, -1, 2);
+        assert(n >= -1 && n < 2);
+        counts[n + 1]++;
+    }
+    for (int i = 0; i < 3; i++) {
+        assert(counts[i] > DRAWS / 3 - DRAWS / 100);
+        assert(counts[i] < DRAWS / 3 + DRAWS / 100);
+    }
+
+    double sum = 0;
+    for (int i = 0; i < DRAWS; i++) {
+        double x = ez::random_real(random);
+        assert(x >= 0 && x < 1);
+        sum += x;
+    }
+    assert(sum / DRAWS > 0.49 && sum / DRAWS < 0.51);
+
+    assert(ez::random_integer(random, 5, 5) == 0);
+    int n = ez::random_integer(random, -2147483647 - 1, 2147483647);
+    (void)n;
+}
+
+static void test_streams() {
+    ez::Random a, b;
+    ez::seed_random(a, 7);
+    ez::seed_random(b, 7);
+    for (int i = 0; i < 100; i++) {
+        assert(ez::random_integer(a, 0, 1000000) ==
+               ez::random_integer(b, 0, 1000000));
+    }
+
+    ez::Random stream;
+    ez::split_random(a, stream);
+    assert(stream.next() == b.next());
+    assert(a.next() != b.next());
+
+    ez::vector<int> integers;
+    ez::fill_random_integers(a, integers, 1000, 10, 20);
+    assert(integers.size() == 1000);
+    ez::vector<double> reals;
+    ez::fill_random_reals(a, reals, 10);
+    ez::fill_random_reals(a, reals, 20);
+    assert(reals.size() == 20);
+}
+
+/* `random` draws from a different stream in each thread, and seeding it
+ * in a thread doesn't change the others. */
+static void test_threads() {
+    ez::set_random_seed(3);
+    int main_draw = ez::random(0, 1 << 30);
+    int thread_draw = 0;
+
+    std::thread thread([&]() {
+        thread_draw = ez::random(0, 1 << 30);
+        ez::set_random_seed(3);
+    });
+    thread.join();
+
+    ez::set_random_seed(3);
+    assert(ez::random(0, 1 << 30) == main_draw);
+    assert(thread_draw != main_draw);
+}
+
+int main(void) {
+    test_ranges();
+    test_streams();
+    test_threads();
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "ez-lang.h"
+#include "ez-test.h"
+
+char source[] =
+    "program reach_test\n"
+    "\n"
+    "structure point is\n"
+    "    x is real\n"
+    "end\n"
+    "\n"
+    "structure segment is\n"
+    "    a is point\n"
+    "end\n"
+    "\n"
+    "structure unused_shape is\n"
+    "    p is point\n"
+    "end\n"
+    "\n"
+    "constant used_limit is integer = 10\n"
+    "constant unused_limit is integer = 20\n"
+    "global used_counter is integer\n"
+    "global unused_counter is integer\n"
+    "\n"
+    "function used_leaf(in s is segment) return real\n"
+    "begin\n"
+    "    return s.a.x\n"
+    "end\n"
+    "\n"
+    "function used_by_lambda(in x is integer) return integer\n"
+    "begin\n"
+    "    return x + used_limit\n"
+    "end\n"
+    "\n"
+    "procedure used_procedure()\n"
+    "begin\n"
+    "    used_counter = used_counter + 1\n"
+    "end\n"
+    "\n"
+    "procedure unused_procedure()\n"
+    "begin\n"
+    "    unused_counter = unused_limit\n"
+    "end\n"
+    "\n"
+    "function unused_function(in p is unused_shape) return integer\n"
+    "begin\n"
+    "    unused_procedure()\n"
+    "    return unused_function(p)\n"
+    "end\n"
+    "\n"
+    "function reach_test(in args is vector of string) return integer\n"
+    "    local s is segment\n"
+    "    local v is vector of integer\n"
+    "begin\n"
+    "    print used_leaf(s)\n"
+    "    v.map(lambda (inout x is integer) is x = used_by_lambda(x))\n"
+    "    used_procedure()\n"
+    "    return 0\n"
+    "end\n";
+
+int main(void) {
+    program_t* prg = parse_program(source);
+
+    program_remove_unreachable(prg);
+    char* code = print_program(prg, NULL);
+
+    assert(prg->functions.size == 3);
+    assert(prg->procedures.size == 1);
+    assert(prg->structures.size == 2);
+    assert(prg->constants.size == 1);
+    assert(prg->globals.size == 1);
+
+    assert(strstr(code, "struct point"));
+    assert(strstr(code, "struct segment"));
+    assert(strstr(code, "used_leaf("));
+    assert(strstr(code, "used_by_lambda("));
+    assert(strstr(code, "used_procedure("));
+    assert(strstr(code, "used_limit"));
+    assert(strstr(code, "used_counter"));
+    assert(!strstr(code, "unused"));
+
+    free(code);
+    program_delete(prg);
+
+    return 0;
+}
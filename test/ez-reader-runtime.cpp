@@ -0,0 +1,45 @@
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include "../ez/reader.hpp"
+
+/* Checks the ez::Reader runtime on lines longer than its buffer, and on a
+ * last line without '\n'. */
+
+static const char* PATH = "test-ez-reader-runtime.txt";
+
+int main(void) {
+    const std::string long_line(3 * EZ_READER_BUFFER_SIZE + 7, 'x');
+
+    FILE* file = fopen(PATH, "w");
+    assert(file);
+    fprintf(file, "first\n\n%s\nlast", long_line.c_str());
+    fclose(file);
+
+    ez::Reader reader;
+    std::string line;
+    assert(!ez::read_line(reader, line));
+
+    ez::open_reader(PATH, reader);
+    assert(ez::is_reader_open(reader));
+    assert(ez::read_line(reader, line) && line == "first\n");
+    assert(ez::read_line(reader, line) && line == "\n");
+    assert(ez::read_line(reader, line) && line == long_line + "\n");
+
+    /* The line storage is reused. */
+    const size_t capacity = line.capacity();
+    assert(ez::read_line(reader, line) && line == "last");
+    assert(line.capacity() == capacity);
+    assert(!ez::read_line(reader, line) && line.empty());
+
+    ez::Reader moved = std::move(reader);
+    assert(ez::is_reader_open(moved) && !ez::is_reader_open(reader));
+    ez::close_reader(moved);
+    assert(!ez::is_reader_open(moved));
+
+    ez::open_reader("does/not/exist", reader);
+    assert(!ez::is_reader_open(reader));
+
+    remove(PATH);
+    return 0;
+}
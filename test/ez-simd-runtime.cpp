@@ -0,0 +1,168 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <chrono>
+#include "../ez/vector.hpp"
+
+/* Checks the numeric kernels of every instruction set against plain loops,
+ * on sizes with and without a partial last pack. */
+
+static bool near(double a, double b) {
+    return std::fabs(a - b) <= 1e-9 * (std::fabs(a) + std::fabs(b) + 1);
+}
+
+static void fill(ez::vector<double>& v, unsigned int n, int seed) {
+    v.clear();
+    for (unsigned int i = 0; i < n; i++) {
+        v.push(((int)((i * 7919 + seed * 104729) % 2003) - 1001) / 16.0);
+    }
+}
+
+static void fill(ez::vector<int>& v, unsigned int n, int seed) {
+    v.clear();
+    for (unsigned int i = 0; i < n; i++) {
+        v.push((int)((i * 7919 + seed * 104729) % 2003) - 1001);
+    }
+}
+
+static bool same(double a, double b) {
+    return near(a, b);
+}
+
+static bool same(int a, int b) {
+    return a == b;
+}
+
+/* The kernels of one instruction set, `N` being its namespace. */
+#define CHECK_KERNELS(N, T, n)                                            \
+    do {                                                                  \
+        ez::vector<T> x, y, z;                                            \
+        fill(x, n, 1);                                                    \
+        fill(y, n, 2);                                                    \
+        const T* px = &x.at(0);                                           \
+        T* py = &y.at(0);                                                 \
+                                                                          \
+        T sum = 0, dot = 0, min = x.at(0), max = x.at(0);                 \
+        for (unsigned int i = 0; i < n; i++) {                            \
+            sum += x.at(i);                                               \
+            dot += x.at(i) * y.at(i);                                     \
+            min = x.at(i) < min ? x.at(i) : min;                          \
+            max = x.at(i) > max ? x.at(i) : max;                          \
+        }                                                                 \
+        assert(same(ez::simd::N::sum(px, n), sum));                       \
+        assert(same(ez::simd::N::dot(px, py, n), dot));                   \
+        assert(ez::simd::N::min(px, n) == min);                           \
+        assert(ez::simd::N::max(px, n) == max);                           \
+                                                                          \
+        z = y;                                                            \
+        ez::simd::N::axpy((T)3, px, py, n);                               \
+        for (unsigned int i = 0; i < n; i++) {                            \
+            assert(y.at(i) == z.at(i) + 3 * x.at(i));                     \
+        }                                                                 \
+        z = y;                                                            \
+        ez::simd::N::scale((T)-2, py, n);                                 \
+        for (unsigned int i = 0; i < n; i++) {                            \
+            assert(y.at(i) == -2 * z.at(i));                              \
+        }                                                                 \
+        z = y;                                                            \
+        ez::simd::N::add(px, py, n);                                      \
+        for (unsigned int i = 0; i < n; i++) {                            \
+            assert(y.at(i) == z.at(i) + x.at(i));                         \
+        }                                                                 \
+        z = y;                                                            \
+        ez::simd::N::mul(px, py, n);                                      \
+        for (unsigned int i = 0; i < n; i++) {                            \
+            assert(y.at(i) == z.at(i) * x.at(i));                         \
+        }                                                                 \
+    } while (0)
+
+static void test_kernels() {
+    const unsigned int sizes[] = {1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 33, 1000};
+
+    for (unsigned int n : sizes) {
+        CHECK_KERNELS(scalar, double, n);
+        CHECK_KERNELS(scalar, int, n);
+#ifdef EZ_SIMD_X86
+        if (__builtin_cpu_supports("sse4.1")) {
+            CHECK_KERNELS(sse41, double, n);
+            CHECK_KERNELS(sse41, int, n);
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            CHECK_KERNELS(avx2, double, n);
+            CHECK_KERNELS(avx2, int, n);
+        }
+#endif
+    }
+}
+
+static void test_vector() {
+    ez::vector<double> v;
+    ez::vector<double> w;
+    for (int i = 1; i <= 10; i++) {
+        v.push(i);
+        w.push(2);
+    }
+
+    assert(v.sum() == 55);
+    assert(v.dot(w) == 110);
+    assert(v.min() == 1);
+    assert(v.max() == 10);
+
+    v.axpy(0.5, w);
+    assert(v.at(0) == 2 && v.at(9) == 11);
+    v.scale(2);
+    assert(v.at(0) == 4 && v.at(9) == 22);
+    v.add(w);
+    assert(v.at(0) == 6 && v.at(9) == 24);
+    v.mul(w);
+    assert(v.at(0) == 12 && v.at(9) == 48);
+
+    /* Other types than reals and integers use the scalar kernels. */
+    ez::vector<unsigned int> naturals;
+    naturals.push(3);
+    naturals.push(1);
+    naturals.push(2);
+    assert(naturals.sum() == 6);
+    assert(naturals.min() == 1);
+
+    ez::vector<int> empty;
+    assert(empty.sum() == 0);
+}
+
+static void bench() {
+    const unsigned int n = 1 << 20;
+    ez::vector<double> x, y;
+    fill(x, n, 1);
+    fill(y, n, 2);
+
+    auto start = std::chrono::steady_clock::now();
+    double loop = 0;
+    for (int k = 0; k < 20; k++) {
+        for (unsigned int i = 0; i < n; i++) {
+            loop += x.at(i) * y.at(i);
+        }
+    }
+    std::chrono::duration<double> loop_time =
+        std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    double kernel = 0;
+    for (int k = 0; k < 20; k++) {
+        kernel += x.dot(y);
+    }
+    std::chrono::duration<double> kernel_time =
+        std::chrono::steady_clock::now() - start;
+
+    assert(near(loop, kernel));
+    printf("dot of %u reals: loop %.3fms, dot %.3fms (level %d)\n", n,
+           loop_time.count() * 1000 / 20, kernel_time.count() * 1000 / 20,
+           (int)ez::simd::best_level());
+}
+
+int main(void) {
+    test_kernels();
+    test_vector();
+    bench();
+
+    return 0;
+}
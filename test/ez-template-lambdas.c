@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "ez-lang.h"
+#include "ez-test.h"
+
+char source[] =
+    "program template_test\n"
+    "\n"
+    "function apply(in x is integer,\n"
+    "               in f is function(in integer) return integer)\n"
+    "        return integer\n"
+    "begin\n"
+    "    return f(x)\n"
+    "end\n"
+    "\n"
+    "function nest(in n is integer,\n"
+    "              in g is function(in integer) return integer)\n"
+    "        return integer\n"
+    "begin\n"
+    "    if n == 0 then\n"
+    "        return g(n)\n"
+    "    endif\n"
+    "    return nest(n - 1, lambda (in x is integer) return integer\n"
+    "                       is return x + 1)\n"
+    "end\n"
+    "\n"
+    "procedure give(out h is function(in integer) return integer)\n"
+    "begin\n"
+    "    h = lambda (in x is integer) return integer is return x\n"
+    "end\n"
+    "\n"
+    "function template_test(in args is vector of string) return integer\n"
+    "begin\n"
+    "    return apply(1, lambda (in x is integer) return integer\n"
+    "                    is return x * 2)\n"
+    "end\n";
+
+int main(void) {
+    program_t* prg = parse_program(source);
+
+    char* code = print_program(prg, NULL);
+    assert(!strstr(code, "template <"));
+    free(code);
+
+    const codegen_options_t options = (codegen_options_t){
+        .template_lambdas = true,
+    };
+    code = print_program(prg, &options);
+
+    assert(strstr(code, "template <typename _ez_f_t>\n"
+                        "static int apply(int x, const _ez_f_t& f)"));
+
+    /* Giving it a lambda would instantiate it endlessly. */
+    assert(strstr(code, "static int nest(int n, "
+                        "const std::function< int(int) >& g)"));
+    assert(!strstr(code, "_ez_g_t"));
+
+    /* Only `in` arguments are templates. */
+    assert(strstr(code, "static void give(std::function< int(int) >& h)"));
+
+    free(code);
+    program_delete(prg);
+
+    return 0;
+}
@@ -0,0 +1,42 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "ez-parser.h"
+#include "ez-test.h"
+
+program_t* parse_program(const char* source) {
+    context_t ctx;
+    program_t* prg = NULL;
+
+    FILE* f = fmemopen((void*)source, strlen(source), "r");
+    assert(program_parser(f, &ctx, &prg) == PARSER_SUCCESS);
+    assert(!ctx.error_prg);
+    fclose(f);
+
+    return prg;
+}
+
+bool snippet_is_valid(const char* format, const char* snippet) {
+    char source[2048];
+    context_t ctx;
+    program_t* prg = NULL;
+
+    snprintf(source, sizeof(source), format, snippet);
+
+    FILE* f = fmemopen(source, strlen(source), "r");
+    assert(program_parser(f, &ctx, &prg) == PARSER_SUCCESS);
+    fclose(f);
+    program_delete(prg);
+
+    return !ctx.error_prg;
+}
+
+char* print_program(const program_t* prg, const codegen_options_t* options) {
+    emitter_t emitter;
+    emitter_init(&emitter, 0);
+    program_print(&emitter, prg, options);
+    char* code = strdup(emitter_data(&emitter));
+    emitter_wipe(&emitter);
+    return code;
+}
@@ -0,0 +1,28 @@
+#ifndef _ez_test_h_
+#define _ez_test_h_
+
+#include <stdbool.h>
+#include "ez-lang.h"
+
+/* Helpers shared by the tests of the EZ compiler. They parse EZ sources, so
+ * the tests must be run from a directory containing the EZ builtins file.
+ */
+
+/**
+ * Parses the EZ program `source`, which must be valid, and returns it.
+ */
+program_t* parse_program(const char* source);
+
+/**
+ * Parses the EZ program made of `format` with its "%s" replaced by `snippet`,
+ * and returns true if it is valid. The program is then deleted.
+ */
+bool snippet_is_valid(const char* format, const char* snippet);
+
+/**
+ * Returns the C++ code generated for `prg` with the given options (NULL for
+ * the default ones). It must be freed.
+ */
+char* print_program(const program_t* prg, const codegen_options_t* options);
+
+#endif
@@ -0,0 +1,190 @@
+#include <cassert>
+#include <cstdio>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "../ez/vector.hpp"
+
+/* Checks the ez::vector runtime, and that it runs as fast as a plain
+ * std::vector on the usual EZ loops. */
+
+static const unsigned int SIZE = 1 << 20;
+static const int RUNS = 10;
+
+template <typename F>
+static double best_time(const F& func) {
+    double best = 1e30;
+
+    for (int run = 0; run < RUNS; run++) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        if (elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    return best;
+}
+
+static void test_operations() {
+    ez::vector<int> v;
+
+    for (int i = 0; i < 5; i++) {
+        v.push(i);
+    }
+    v.insert(0, -1);
+    v.insert(v.size(), 5);
+    v.remove(1);
+    v.pop();
+    assert(v.size() == 5);
+    assert(v.at(0) == -1 && v.at(1) == 1 && v.at(4) == 4);
+
+    v.map([](int& x) { x = x * 2; });
+    assert(v.reduce([](int x, int sum) { return x + sum; }, 0) == 18);
+
+    v.filter([](const int& x) { return x < 0; });
+    assert(v.size() == 4 && v.at(0) == 2);
+
+    ez::vector<int> odd;
+    v.push(3);
+    v.filter_into(odd, [](const int& x) { return x % 2 == 0; });
+    assert(odd.size() == 1 && odd.at(0) == 3 && v.size() == 5);
+
+    ez::vector<int> even;
+    v.partition(even, [](const int& x) { return x % 2 == 0; });
+    assert(v.size() == 1 && v.at(0) == 3);
+    assert(even.size() == 4 && even.at(0) == 2 && even.at(3) == 8);
+
+    /* Into the vector itself, filter_into filters it and partition leaves
+     * it unchanged. */
+    even.push(5);
+    even.partition(even, [](const int& x) { return x % 2 == 0; });
+    assert(even.size() == 5 && even.at(4) == 5);
+    even.filter_into(even, [](const int& x) { return x % 2 == 0; });
+    assert(even.size() == 1 && even.at(0) == 5);
+
+    /* Moves leave the source empty, copies don't. */
+    ez::vector<std::string> names;
+    std::string name = "name";
+    names.push(std::move(name));
+    ez::vector<std::string> copy = names;
+    ez::vector<std::string> moved = std::move(names);
+    assert(copy.size() == 1 && moved.size() == 1 && names.size() == 0);
+
+    static_assert(sizeof(ez::vector<int>) == sizeof(std::vector<int>),
+                  "ez::vector must not add any member");
+}
+
+static void test_benchmark() {
+    volatile long sink = 0;
+
+    double ez_time = best_time([&]() {
+        ez::vector<int> v;
+        for (unsigned int i = 0; i < SIZE; i++) {
+            v.push(i);
+        }
+        v.map([](int& x) { x = x * 3; });
+        long sum = 0;
+        for (unsigned int i = 0; i < v.size(); i++) {
+            sum += v.at(i);
+        }
+        sink = sink + sum;
+    });
+
+    double std_time = best_time([&]() {
+        std::vector<int> v;
+        for (unsigned int i = 0; i < SIZE; i++) {
+            v.push_back(i);
+        }
+        for (int& x : v) {
+            x = x * 3;
+        }
+        long sum = 0;
+        for (unsigned int i = 0; i < v.size(); i++) {
+            sum += v[i];
+        }
+        sink = sink + sum;
+    });
+
+    printf("ez::vector %.3fms, std::vector %.3fms\n",
+           ez_time * 1000, std_time * 1000);
+    assert(ez_time < std_time * 1.25 + 0.0005);
+}
+
+/* Filtering a large vector is linear: removing every other element must
+ * not take much longer than building the vector. */
+static void test_filter_benchmark() {
+    double build_time = best_time([&]() {
+        ez::vector<int> v;
+        for (unsigned int i = 0; i < SIZE; i++) {
+            v.push(i);
+        }
+    });
+
+    double filter_time = best_time([&]() {
+        ez::vector<int> v;
+        for (unsigned int i = 0; i < SIZE; i++) {
+            v.push(i);
+        }
+        v.filter([](const int& x) { return x % 2 == 0; });
+        assert(v.size() == SIZE / 2);
+    });
+
+    printf("build %.3fms, build and filter %.3fms\n",
+           build_time * 1000, filter_time * 1000);
+    assert(filter_time < build_time * 4 + 0.0005);
+}
+
+/* The parallel operations give the same results as the sequential ones,
+ * on vectors spanning many chunks. */
+static void test_parallel() {
+    ez::vector<int> v;
+    ez::vector<int> sequential;
+
+    for (unsigned int i = 0; i < SIZE + 17; i++) {
+        v.push(i % 1000);
+        sequential.push(i % 1000);
+    }
+
+    v.parallel_map([](int& x) { x = x * 3 + 1; });
+    sequential.map([](int& x) { x = x * 3 + 1; });
+    for (unsigned int i = 0; i < v.size(); i++) {
+        assert(v.at(i) == sequential.at(i));
+    }
+
+    auto sum = [](int x, int sum) { return x + sum; };
+    assert(v.parallel_reduce(sum, 0) == sequential.reduce(sum, 0));
+
+    /* Order matters: build the string of a few digits. */
+    ez::vector<std::string> digits;
+    for (unsigned int i = 0; i < 100000; i++) {
+        digits.push(std::string(1, '0' + i % 10));
+    }
+    auto concat = [](const std::string& x, const std::string& s) {
+        return s + x;
+    };
+    assert(digits.parallel_reduce(concat, "") == digits.reduce(concat, ""));
+
+    auto odd = [](const int& x) { return x % 2 == 1; };
+    v.parallel_filter(odd);
+    sequential.filter(odd);
+    assert(v.size() == sequential.size());
+    for (unsigned int i = 0; i < v.size(); i++) {
+        assert(v.at(i) == sequential.at(i));
+    }
+
+    ez::vector<int> empty;
+    empty.parallel_map([](int& x) { x++; });
+    empty.parallel_filter(odd);
+    assert(empty.parallel_reduce(sum, 7) == 7);
+}
+
+int main(void) {
+    test_operations();
+    test_benchmark();
+    test_filter_benchmark();
+    test_parallel();
+
+    return 0;
+}
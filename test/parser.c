@@ -19,6 +19,9 @@ int main(void) {
     char skip_until_char[] = "xyze bob";
     char skip_until_word[] = "this is a comment* /bob";
 
+    char slices[] = "identifier_01 \"a string\"";
+    parser_slice_t slice;
+
     f = fmemopen(char_ok, sizeof(char_ok), "r");
     *output = '\0';
     output_ptr = output;
@@ -58,6 +61,21 @@ int main(void) {
     assert (until_char_parser(f, "b", NULL) == PARSER_FAILURE);
     fclose(f);
 
+    f = fmemopen(slices, sizeof(slices), "r");
+    assert (chars_slice_parser(f, "abcdefghijklmnopqrstuvwxyz_01", &slice)
+            == PARSER_SUCCESS);
+    assert (slice.offset == 0 && slice.length == 13);
+    assert (char_parser(f, " ", NULL) == PARSER_SUCCESS);
+    assert (char_parser(f, "\"", NULL) == PARSER_SUCCESS);
+    assert (until_char_slice_parser(f, "\"", &slice) == PARSER_SUCCESS);
+    assert (slice.offset == 15 && slice.length == 8);
+    assert (!slice_copy(f, &slice, output, 8));
+    assert (slice_copy(f, &slice, output, 512));
+    assert (strcmp(output, "a string") == 0);
+    /* Materializing a slice doesn't move the stream. */
+    assert (char_parser(f, "\"", NULL) == PARSER_SUCCESS);
+    fclose(f);
+
     f = fmemopen(skip_until_word, sizeof(skip_until_word), "r");
     assert (until_word_parser(f, "*/", NULL) == PARSER_SUCCESS);
     assert (word_parser(f, "*/", NULL) == PARSER_SUCCESS);